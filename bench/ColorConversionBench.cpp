@@ -0,0 +1,113 @@
+// Microbenchmark: SIMD YUV->RGB32 kernels vs. QVideoFrame::toImage() + convertToFormat()
+#include <QGuiApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QVideoFrame>
+#include <QVideoFrameFormat>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "ColorConversion.h"
+
+namespace
+{
+    struct Layout
+    {
+        const char *name;
+        ColorConversion::Layout layout;
+        QVideoFrameFormat::PixelFormat qtFormat;
+    };
+
+    // Fill every plane of a mapped frame with a deterministic pattern
+    void fillFrame(QVideoFrame &frame)
+    {
+        frame.map(QVideoFrame::WriteOnly);
+        for (int plane = 0; plane < frame.planeCount(); ++plane)
+        {
+            uchar *bits = frame.bits(plane);
+            qsizetype size = frame.mappedBytes(plane);
+            for (qsizetype i = 0; i < size; ++i)
+            {
+                bits[i] = static_cast<uchar>((i * 7 + plane * 61) & 0xFF);
+            }
+        }
+        frame.unmap();
+    }
+
+    template <typename Function>
+    double averageMs(int iterations, Function function)
+    {
+        function(); // Warm up caches and lazy initialisation
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < iterations; ++i)
+        {
+            function();
+        }
+        return timer.nsecsElapsed() / 1e6 / iterations;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // QVideoFrame::toImage() may need a GUI context for its conversion shaders
+    QGuiApplication app(argc, argv);
+
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 20;
+    const QSize sizes[] = {QSize(1920, 1080), QSize(3840, 2160)};
+    const Layout layouts[] = {
+        {"NV12", ColorConversion::Layout::NV12, QVideoFrameFormat::Format_NV12},
+        {"YUV420P", ColorConversion::Layout::YUV420P, QVideoFrameFormat::Format_YUV420P},
+        {"P010", ColorConversion::Layout::P010, QVideoFrameFormat::Format_P010},
+        {"YUYV", ColorConversion::Layout::YUYV, QVideoFrameFormat::Format_YUYV},
+    };
+    const ColorConversion::Kernel kernels[] = {ColorConversion::Kernel::Scalar, ColorConversion::Kernel::SSE41,
+                                               ColorConversion::Kernel::AVX2};
+
+    std::printf("%-8s %-10s %-10s %10s\n", "layout", "size", "path", "ms/frame");
+    for (const QSize &size : sizes)
+    {
+        for (const Layout &layout : layouts)
+        {
+            QVideoFrameFormat format(size, layout.qtFormat);
+            format.setColorSpace(QVideoFrameFormat::ColorSpace_BT709);
+            format.setColorRange(QVideoFrameFormat::ColorRange_Video);
+            QVideoFrame frame(format);
+            fillFrame(frame);
+
+            const QString sizeText = QString("%1x%2").arg(size.width()).arg(size.height());
+
+            double qtMs = averageMs(iterations, [&frame]()
+                                    {
+                QImage image = frame.toImage().convertToFormat(QImage::Format_RGB32);
+                Q_UNUSED(image); });
+            std::printf("%-8s %-10s %-10s %10.2f\n", layout.name, qPrintable(sizeText), "Qt", qtMs);
+
+            frame.map(QVideoFrame::ReadOnly);
+            ColorConversion::Source source{};
+            source.layout = layout.layout;
+            source.width = size.width();
+            source.height = size.height();
+            source.matrix = ColorConversion::Matrix::BT709;
+            source.range = ColorConversion::Range::Limited;
+            for (int plane = 0; plane < qMin(3, frame.planeCount()); ++plane)
+            {
+                source.planes[plane] = frame.bits(plane);
+                source.strides[plane] = frame.bytesPerLine(plane);
+            }
+
+            QImage output(size, QImage::Format_RGB32);
+            for (ColorConversion::Kernel kernel : kernels)
+            {
+                if (!ColorConversion::isSupported(kernel))
+                    continue;
+                double kernelMs = averageMs(iterations, [&]()
+                                            { ColorConversion::convert(source, output.bits(), static_cast<int>(output.bytesPerLine()), kernel); });
+                std::printf("%-8s %-10s %-10s %10.2f  (%.1fx)\n", layout.name, qPrintable(sizeText),
+                            ColorConversion::kernelName(kernel), kernelMs, qtMs / kernelMs);
+            }
+            frame.unmap();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,551 @@
+// End-to-end benchmarks on generated clips: seek, step, capture, conversion, encoding, directory scan, timeline repaint
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QSysInfo>
+#include <QThread>
+#include <QVideoFrame>
+#include <QVideoFrameFormat>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "FrameDirectoryIndex.h"
+#include "FrameFilename.h"
+#include "FrameIndex.h"
+#include "FrameWriter.h"
+#include "ImageEncoder.h"
+#include "Logger.h"
+#include "SyntheticClip.h"
+#include "TimelineWidget.h"
+#include "VideoDecoder.h"
+
+extern "C"
+{
+#include <libavcodec/version.h>
+}
+
+namespace
+{
+    struct Options
+    {
+        QString workDir;
+        int frames = 300;
+        int seekSamples = 60;
+        int stepSamples = 120;
+        int captureSamples = 15;
+        bool quick = false;
+        QString filter;
+    };
+
+    void progress(const QString &text)
+    {
+        std::fprintf(stderr, "%s\n", text.toUtf8().constData());
+        std::fflush(stderr);
+    }
+
+    double percentile(const std::vector<double> &sorted, double fraction)
+    {
+        // Nearest rank; exact for the sample, unlike the HUD's bucketed histograms
+        size_t rank = static_cast<size_t>(fraction * sorted.size() + 0.5);
+        return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+
+    template <typename Function>
+    std::vector<double> timeEach(int samples, Function function)
+    {
+        std::vector<double> ms;
+        ms.reserve(samples);
+        QElapsedTimer timer;
+        for (int i = 0; i < samples; ++i)
+        {
+            timer.start();
+            function(i);
+            ms.push_back(timer.nsecsElapsed() / 1e6);
+        }
+        return ms;
+    }
+
+    QJsonObject clipObject(const SyntheticClip::Spec &spec)
+    {
+        return QJsonObject{{"name", spec.name()}, {"codec", spec.codec}, {"width", spec.width}, {"height", spec.height},
+                           {"gop", spec.gop}, {"frames", spec.frames}, {"fps", spec.fps}};
+    }
+
+    class Report
+    {
+    public:
+        explicit Report(const QString &filter) : m_filter(filter) {}
+
+        bool wants(const QString &benchmark) const
+        {
+            return m_filter.isEmpty() || benchmark.contains(m_filter, Qt::CaseInsensitive);
+        }
+
+        void add(const QString &benchmark, const QJsonObject &parameters, std::vector<double> ms, int errors = 0)
+        {
+            QJsonObject result = parameters;
+            result["benchmark"] = benchmark;
+            result["samples"] = static_cast<int>(ms.size());
+            result["errors"] = errors;
+            if (!ms.empty())
+            {
+                std::sort(ms.begin(), ms.end());
+                result["minMs"] = ms.front();
+                result["meanMs"] = std::accumulate(ms.begin(), ms.end(), 0.0) / ms.size();
+                result["p50Ms"] = percentile(ms, 0.50);
+                result["p95Ms"] = percentile(ms, 0.95);
+                result["p99Ms"] = percentile(ms, 0.99);
+                result["maxMs"] = ms.back();
+            }
+            m_results.append(result);
+
+            progress(QString("  %1 %2: p50 %3ms p95 %4ms (%5 samples%6)")
+                         .arg(benchmark, parameters.value("clip").toObject().value("name").toString(parameters.value("name").toString()))
+                         .arg(result.value("p50Ms").toDouble(), 0, 'f', 2)
+                         .arg(result.value("p95Ms").toDouble(), 0, 'f', 2)
+                         .arg(ms.size())
+                         .arg(errors > 0 ? QString(", %1 errors").arg(errors) : QString()));
+        }
+
+        void skip(const QString &benchmark, const QJsonObject &parameters, const QString &reason)
+        {
+            QJsonObject result = parameters;
+            result["benchmark"] = benchmark;
+            result["skipped"] = reason;
+            m_results.append(result);
+            progress(QString("  %1 skipped: %2").arg(benchmark, reason));
+        }
+
+        const QJsonArray &results() const { return m_results; }
+
+    private:
+        QString m_filter;
+        QJsonArray m_results;
+    };
+
+    QVideoFrame syntheticVideoFrame(QVideoFrameFormat::PixelFormat pixelFormat, const QSize &size, int frameNumber)
+    {
+        QVideoFrame frame(QVideoFrameFormat(size, pixelFormat));
+        frame.map(QVideoFrame::WriteOnly);
+        if (pixelFormat == QVideoFrameFormat::Format_YUV420P)
+        {
+            uint8_t *planes[3] = {frame.bits(0), frame.bits(1), frame.bits(2)};
+            int strides[3] = {frame.bytesPerLine(0), frame.bytesPerLine(1), frame.bytesPerLine(2)};
+            SyntheticClip::fillYuv420(frameNumber, size.width(), size.height(), planes, strides);
+        }
+        else
+        {
+            // NV12: draw planar, then interleave the chroma
+            int chromaWidth = (size.width() + 1) / 2;
+            int chromaHeight = (size.height() + 1) / 2;
+            std::vector<uint8_t> u(static_cast<size_t>(chromaWidth) * chromaHeight);
+            std::vector<uint8_t> v(u.size());
+            uint8_t *planes[3] = {frame.bits(0), u.data(), v.data()};
+            int strides[3] = {frame.bytesPerLine(0), chromaWidth, chromaWidth};
+            SyntheticClip::fillYuv420(frameNumber, size.width(), size.height(), planes, strides);
+            for (int y = 0; y < chromaHeight; ++y)
+            {
+                uint8_t *row = frame.bits(1) + static_cast<ptrdiff_t>(y) * frame.bytesPerLine(1);
+                for (int x = 0; x < chromaWidth; ++x)
+                {
+                    row[x * 2] = u[y * chromaWidth + x];
+                    row[x * 2 + 1] = v[y * chromaWidth + x];
+                }
+            }
+        }
+        frame.unmap();
+        return frame;
+    }
+
+    bool ffmpegAvailable()
+    {
+        QProcess process;
+        process.start("ffmpeg", {"-version"});
+        return process.waitForFinished(5000) && process.exitCode() == 0;
+    }
+
+    void benchClip(const SyntheticClip::Spec &spec, const Options &options, bool haveFfmpeg, Report &report)
+    {
+        QJsonObject parameters{{"clip", clipObject(spec)}};
+        progress(QString("Clip %1").arg(spec.name()));
+
+        QString error;
+        QString path = SyntheticClip::ensure(spec, options.workDir, &error);
+        if (path.isEmpty())
+        {
+            report.skip("generate", parameters, error);
+            return;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        FrameIndex index = FrameIndex::build(path);
+        if (report.wants("index"))
+            report.add("index", parameters, {timer.nsecsElapsed() / 1e6});
+        if (!index.isValid())
+        {
+            report.skip("seek", parameters, "indexing failed");
+            return;
+        }
+
+        // mt19937's output is fixed by the standard (distributions aren't), so every platform picks the same frames
+        std::mt19937 random(42);
+        auto anyFrame = [&random, &index]()
+        { return static_cast<int>(random() % static_cast<unsigned>(index.frameCount())); };
+        QString capturePath = QDir(options.workDir).filePath("capture.png");
+        ImageEncoder::Settings png;
+
+        // Random access, as when dragging the timeline or jumping to a capture
+        if (report.wants("seek"))
+        {
+            VideoDecoder decoder;
+            decoder.open(path, index);
+            int errors = 0;
+            std::vector<double> ms = timeEach(options.seekSamples, [&](int)
+                                              {
+                int target = anyFrame();
+                if (SyntheticClip::readFrameNumber(decoder.decodeFrame(target)) != target)
+                    ++errors; });
+            report.add("seek", parameters, ms, errors);
+        }
+
+        // One frame at a time from a warm decoder, like the arrow keys without the read-ahead cache
+        for (int direction : {1, -1})
+        {
+            QString name = direction > 0 ? "step_forward" : "step_backward";
+            if (!report.wants(name))
+                continue;
+
+            int steps = qMin(options.stepSamples, index.frameCount() - 1);
+            int start = direction > 0 ? 0 : index.frameCount() - 1;
+            VideoDecoder decoder;
+            decoder.open(path, index);
+            decoder.decodeFrame(start);
+            int errors = 0;
+            std::vector<double> ms = timeEach(steps, [&](int i)
+                                              {
+                int target = start + direction * (i + 1);
+                if (SyntheticClip::readFrameNumber(decoder.decodeFrame(target)) != target)
+                    ++errors; });
+            report.add(name, parameters, ms, errors);
+        }
+
+        // The libav backend: decode on the warm capture decoder, then convert and write the PNG
+        if (report.wants("capture_libav"))
+        {
+            VideoDecoder decoder;
+            decoder.open(path, index);
+            int errors = 0;
+            std::vector<double> ms = timeEach(options.captureSamples, [&](int)
+                                              {
+                QImage image = decoder.decodeFrame(anyFrame());
+                if (!ImageEncoder::encode(image, capturePath, png))
+                    ++errors; });
+            QJsonObject capture = parameters;
+            capture["backend"] = "libav";
+            report.add("capture_libav", capture, ms, errors);
+        }
+
+        // The FFmpeg backend: one ffmpeg process per frame
+        if (report.wants("capture_ffmpeg"))
+        {
+            QJsonObject capture = parameters;
+            capture["backend"] = "ffmpeg";
+            if (!haveFfmpeg)
+            {
+                report.skip("capture_ffmpeg", capture, "ffmpeg not on PATH");
+            }
+            else
+            {
+                int errors = 0;
+                std::vector<double> ms = timeEach(qMin(options.captureSamples, 5), [&](int)
+                                                  {
+                    double seconds = index.timestampMs(anyFrame()) / 1000.0;
+                    QProcess process;
+                    process.start("ffmpeg", {"-v", "error", "-ss", QString::number(seconds, 'f', 3), "-i", path,
+                                             "-frames:v", "1", "-compression_level", "1", "-y", capturePath});
+                    if (!process.waitForFinished(60000) || process.exitCode() != 0)
+                        ++errors; });
+                report.add("capture_ffmpeg", capture, ms, errors);
+            }
+        }
+        QFile::remove(capturePath);
+    }
+
+    // Work that depends on the frame size but not on how the video was encoded
+    void benchResolution(const QSize &size, const Options &options, Report &report)
+    {
+        QJsonObject parameters{{"width", size.width()}, {"height", size.height()},
+                               {"name", QString("%1x%2").arg(size.width()).arg(size.height())}};
+        progress(QString("Frame size %1x%2").arg(size.width()).arg(size.height()));
+        int samples = options.quick ? 10 : 30;
+
+        const std::pair<const char *, QVideoFrameFormat::PixelFormat> layouts[] = {
+            {"YUV420P", QVideoFrameFormat::Format_YUV420P}, {"NV12", QVideoFrameFormat::Format_NV12}};
+        for (const auto &layout : layouts)
+        {
+            QVideoFrame frame = syntheticVideoFrame(layout.second, size, 1234);
+            QJsonObject conversion = parameters;
+            conversion["pixelFormat"] = layout.first;
+
+            if (report.wants("conversion"))
+            {
+                int errors = 0;
+                std::vector<double> ms = timeEach(samples, [&](int)
+                                                  {
+                    if (SyntheticClip::readFrameNumber(FrameWriter::imageFromVideoFrame(frame)) != 1234)
+                        ++errors; });
+                report.add("conversion", conversion, ms, errors);
+            }
+
+            // The Qt sink backend: the player already holds the frame, so capture is convert + write
+            if (report.wants("capture_qt_sink"))
+            {
+                QString capturePath = QDir(options.workDir).filePath("capture.png");
+                int errors = 0;
+                std::vector<double> ms = timeEach(options.captureSamples, [&](int)
+                                                  {
+                    if (!ImageEncoder::encode(FrameWriter::imageFromVideoFrame(frame), capturePath, ImageEncoder::Settings()))
+                        ++errors; });
+                conversion["backend"] = "qt_sink";
+                report.add("capture_qt_sink", conversion, ms, errors);
+                QFile::remove(capturePath);
+            }
+        }
+
+        if (!report.wants("encode"))
+            return;
+
+        QImage image = FrameWriter::imageFromVideoFrame(syntheticVideoFrame(QVideoFrameFormat::Format_YUV420P, size, 1234));
+        QList<ImageEncoder::Settings> variants;
+        for (ImageEncoder::Format format : ImageEncoder::availableFormats())
+        {
+            ImageEncoder::Settings settings;
+            settings.format = format;
+            variants.append(settings);
+            if (format == ImageEncoder::Format::PNG)
+            {
+                settings.pngCompressionLevel = 6;
+                variants.append(settings);
+            }
+        }
+        for (const ImageEncoder::Settings &settings : variants)
+        {
+            QString path = QDir(options.workDir).filePath("encode." + ImageEncoder::fileExtension(settings.format));
+            int errors = 0;
+            std::vector<double> ms = timeEach(samples, [&](int)
+                                              {
+                if (!ImageEncoder::encode(image, path, settings))
+                    ++errors; });
+
+            QJsonObject encode = parameters;
+            encode["format"] = ImageEncoder::formatName(settings.format);
+            if (settings.format == ImageEncoder::Format::PNG)
+                encode["pngLevel"] = settings.pngCompressionLevel;
+            if (settings.format == ImageEncoder::Format::JPEG)
+                encode["jpegQuality"] = settings.jpegQuality;
+            encode["bytes"] = QFileInfo(path).size();
+            report.add("encode", encode, ms, errors);
+            QFile::remove(path);
+        }
+    }
+
+    // Initial listing and parse of an output folder, as on startup or when the folder changes
+    void benchDirectoryScan(int files, const Options &options, Report &report)
+    {
+        QDir directory(QDir(options.workDir).filePath(QString("scan_%1").arg(files)));
+        if (!directory.exists() || directory.entryList(QDir::Files).size() != files)
+        {
+            directory.removeRecursively();
+            directory.mkpath(".");
+            for (int i = 0; i < files; ++i)
+            {
+                QFile file(directory.filePath(FrameFilename::generate("bench_clip", i * 33LL, ImageEncoder::Format::PNG)));
+                file.open(QIODevice::WriteOnly);
+            }
+        }
+
+        int errors = 0;
+        std::vector<double> ms = timeEach(options.quick ? 3 : 5, [&](int)
+                                          {
+            FrameDirectoryIndex index;
+            QEventLoop loop;
+            QObject::connect(&index, &FrameDirectoryIndex::loaded, &loop, &QEventLoop::quit);
+            index.setDirectory(directory.absolutePath());
+            if (!index.isLoaded())
+                loop.exec();
+            if (index.fileCount() != files)
+                ++errors; });
+        report.add("directory_scan", QJsonObject{{"files", files}, {"name", QString("%1 files").arg(files)}}, ms, errors);
+    }
+
+    // Full rebuild after the markers change, and the cached repaint done as the playhead moves
+    void benchTimeline(int markers, const Options &options, Report &report)
+    {
+        const qint64 durationMs = 3600 * 1000;
+        TimelineWidget timeline;
+        timeline.resize(1600, timeline.sizeHint().height());
+        timeline.setRange(0, static_cast<int>(durationMs));
+        int layer = timeline.addMarkerLayer("Saved frame", QColor("#ff4444"));
+
+        QVector<qint64> timestamps;
+        timestamps.reserve(markers);
+        for (int i = 0; i < markers; ++i)
+        {
+            timestamps.append(durationMs * i / markers);
+        }
+
+        QImage target(timeline.size(), QImage::Format_ARGB32_Premultiplied);
+        QJsonObject parameters{{"markers", markers}, {"width", timeline.width()}, {"name", QString("%1 markers").arg(markers)}};
+        int samples = options.quick ? 20 : 100;
+
+        std::vector<double> rebuild = timeEach(samples, [&](int)
+                                               {
+            timeline.setMarkers(layer, timestamps);
+            timeline.render(&target); });
+        report.add("timeline_rebuild", parameters, rebuild);
+
+        std::vector<double> repaint = timeEach(samples, [&](int i)
+                                               {
+            timeline.setValue(static_cast<int>(durationMs * i / samples));
+            timeline.render(&target); });
+        report.add("timeline_repaint", parameters, repaint);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Timeline repaints need a QApplication but no display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    app.setApplicationName("picker_bench");
+
+    // Results go to stdout; keep the library's logging on stderr and quiet
+    spdlog::set_default_logger(spdlog::stderr_color_mt("bench"));
+    Logger::setLevel(spdlog::level::warn);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark seeking, stepping, capture, conversion, encoding, directory scans and\n"
+                                     "timeline repaints on generated clips. Prints JSON results.");
+    parser.addHelpOption();
+    QCommandLineOption outputOption({"o", "output"}, "Write the JSON results to a file instead of stdout.", "file");
+    QCommandLineOption workDirOption("work-dir", "Where generated clips and scratch files are kept (default: picker_bench_data).",
+                                     "dir", "picker_bench_data");
+    QCommandLineOption framesOption("frames", "Frames per generated clip (default: 300).", "N", "300");
+    QCommandLineOption quickOption("quick", "Small sizes and fewer samples, for a smoke run.");
+    QCommandLineOption filterOption("filter", "Only run benchmarks whose name contains this text.", "text");
+    parser.addOptions({outputOption, workDirOption, framesOption, quickOption, filterOption});
+    parser.process(app);
+
+    Options options;
+    options.workDir = QDir(parser.value(workDirOption)).absolutePath();
+    options.frames = qBound(30, parser.value(framesOption).toInt(), 65535);
+    options.quick = parser.isSet(quickOption);
+    options.filter = parser.value(filterOption);
+    if (options.quick)
+    {
+        options.seekSamples = 20;
+        options.stepSamples = 40;
+        options.captureSamples = 5;
+    }
+    QDir().mkpath(options.workDir);
+
+    Report report(options.filter);
+    bool haveFfmpeg = report.wants("capture_ffmpeg") && ffmpegAvailable();
+
+    QList<QSize> sizes{QSize(640, 360), QSize(1920, 1080)};
+    if (!options.quick)
+        sizes.append(QSize(3840, 2160));
+    QStringList codecs;
+    for (const QString &codec : {QString("libx264"), QString("mpeg4")})
+    {
+        if (SyntheticClip::isEncoderAvailable(codec))
+            codecs.append(codec);
+        else
+            report.skip("generate", QJsonObject{{"codec", codec}}, "encoder not in this libav build");
+    }
+    const int gops[] = {1, 30, 250};
+
+    for (const QSize &size : sizes)
+    {
+        for (const QString &codec : codecs)
+        {
+            for (int gop : gops)
+            {
+                // The longest GOP only differs from the middle one at small sizes in quick runs
+                if (options.quick && gop == 250 && size.width() > 640)
+                    continue;
+                SyntheticClip::Spec spec;
+                spec.codec = codec;
+                spec.width = size.width();
+                spec.height = size.height();
+                spec.gop = gop;
+                spec.frames = options.frames;
+                benchClip(spec, options, haveFfmpeg, report);
+            }
+        }
+        benchResolution(size, options, report);
+    }
+
+    if (report.wants("directory_scan"))
+    {
+        progress("Directory scan");
+        for (int files : {1000, 10000})
+        {
+            if (!options.quick || files <= 1000)
+                benchDirectoryScan(files, options, report);
+        }
+    }
+
+    if (report.wants("timeline"))
+    {
+        progress("Timeline");
+        for (int markers : {100, 10000, 100000})
+        {
+            benchTimeline(markers, options, report);
+        }
+    }
+
+    QJsonObject root{
+        {"tool", "picker_bench"},
+        {"version", 1},
+        {"time", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {"quick", options.quick},
+        {"environment", QJsonObject{{"cpu", QSysInfo::currentCpuArchitecture()},
+                                    {"os", QSysInfo::prettyProductName()},
+                                    {"qt", qVersion()},
+                                    {"libavcodec", LIBAVCODEC_IDENT},
+                                    {"threads", QThread::idealThreadCount()}}},
+        {"results", report.results()},
+    };
+    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet(outputOption))
+    {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size())
+        {
+            progress(QString("Cannot write %1: %2").arg(file.fileName(), file.errorString()));
+            return 1;
+        }
+        progress(QString("Wrote %1").arg(file.fileName()));
+    }
+    else
+    {
+        std::fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,248 @@
+#include "SyntheticClip.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/opt.h>
+}
+
+// Bits of the frame number drawn across the top; enough for 65535 frames
+static constexpr int kNumberBits = 16;
+// Video-range luma for set and clear bits, far enough apart to survive any sane bitrate
+static constexpr uint8_t kBitSet = 235;
+static constexpr uint8_t kBitClear = 16;
+// Fixed encoder threading: the bitstream then depends only on the spec and the libav version
+static constexpr int kEncoderThreads = 4;
+
+namespace
+{
+    int bandHeight(int height)
+    {
+        return qMax(16, height / 8) & ~1;
+    }
+
+    QString avError(int code)
+    {
+        char text[AV_ERROR_MAX_STRING_SIZE] = {};
+        av_strerror(code, text, sizeof(text));
+        return QString::fromUtf8(text);
+    }
+
+    // Owns everything one encode touches, so every early return cleans up
+    struct Encoder
+    {
+        AVFormatContext *format = nullptr;
+        AVCodecContext *codec = nullptr;
+        AVFrame *frame = nullptr;
+        AVPacket *packet = nullptr;
+        AVStream *stream = nullptr;
+
+        ~Encoder()
+        {
+            av_packet_free(&packet);
+            av_frame_free(&frame);
+            avcodec_free_context(&codec);
+            if (format)
+            {
+                if (format->pb)
+                    avio_closep(&format->pb);
+                avformat_free_context(format);
+            }
+        }
+
+        // Feed one frame (nullptr to drain) and mux whatever comes out
+        int send(AVFrame *input)
+        {
+            int result = avcodec_send_frame(codec, input);
+            while (result >= 0)
+            {
+                result = avcodec_receive_packet(codec, packet);
+                if (result == AVERROR(EAGAIN) || result == AVERROR_EOF)
+                    return 0;
+                if (result < 0)
+                    break;
+                av_packet_rescale_ts(packet, codec->time_base, stream->time_base);
+                packet->stream_index = stream->index;
+                result = av_interleaved_write_frame(format, packet);
+            }
+            return result;
+        }
+    };
+}
+
+QString SyntheticClip::Spec::name() const
+{
+    return QString("%1_%2x%3_gop%4_%5f").arg(codec).arg(width).arg(height).arg(gop).arg(frames);
+}
+
+bool SyntheticClip::isEncoderAvailable(const QString &codec)
+{
+    return avcodec_find_encoder_by_name(codec.toUtf8().constData()) != nullptr;
+}
+
+QString SyntheticClip::ensure(const Spec &spec, const QString &directory, QString *error)
+{
+    QString path = QDir(directory).filePath(spec.name() + ".mp4");
+    if (QFileInfo::exists(path))
+        return path;
+
+    auto fail = [error](const QString &message)
+    {
+        if (error)
+            *error = message;
+        return QString();
+    };
+
+    const AVCodec *codec = avcodec_find_encoder_by_name(spec.codec.toUtf8().constData());
+    if (!codec)
+        return fail(QString("encoder %1 is not in this libav build").arg(spec.codec));
+
+    // Written under a temporary name so an interrupted run never leaves a truncated clip to be reused
+    QDir().mkpath(directory);
+    QString partialPath = path + ".part";
+    QByteArray partial = partialPath.toUtf8();
+
+    Encoder encoder;
+    int result = avformat_alloc_output_context2(&encoder.format, nullptr, "mp4", partial.constData());
+    if (result < 0)
+        return fail("cannot create mp4 muxer: " + avError(result));
+
+    encoder.stream = avformat_new_stream(encoder.format, nullptr);
+    encoder.codec = avcodec_alloc_context3(codec);
+    encoder.codec->width = spec.width;
+    encoder.codec->height = spec.height;
+    encoder.codec->pix_fmt = AV_PIX_FMT_YUV420P;
+    encoder.codec->time_base = AVRational{1, spec.fps};
+    encoder.codec->framerate = AVRational{spec.fps, 1};
+    encoder.codec->gop_size = spec.gop;
+    encoder.codec->keyint_min = spec.gop;
+    encoder.codec->max_b_frames = spec.gop > 2 ? 2 : 0;
+    encoder.codec->bit_rate = static_cast<int64_t>(spec.width) * spec.height * spec.fps / 4;
+    encoder.codec->thread_count = kEncoderThreads;
+    encoder.codec->flags |= AV_CODEC_FLAG_BITEXACT;
+    if (encoder.format->oformat->flags & AVFMT_GLOBALHEADER)
+        encoder.codec->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+
+    // Keyframes exactly every gop frames; the moving gradient would otherwise trigger scene cuts
+    av_opt_set_int(encoder.codec, "sc_threshold", 1000000000, AV_OPT_SEARCH_CHILDREN);
+    if (spec.codec == "libx264")
+    {
+        av_opt_set(encoder.codec->priv_data, "preset", "veryfast", 0);
+        av_opt_set(encoder.codec->priv_data, "x264-params", "scenecut=0", 0);
+    }
+
+    result = avcodec_open2(encoder.codec, codec, nullptr);
+    if (result < 0)
+        return fail(QString("cannot open encoder %1: %2").arg(spec.codec, avError(result)));
+
+    avcodec_parameters_from_context(encoder.stream->codecpar, encoder.codec);
+    encoder.stream->time_base = encoder.codec->time_base;
+
+    result = avio_open(&encoder.format->pb, partial.constData(), AVIO_FLAG_WRITE);
+    if (result >= 0)
+        result = avformat_write_header(encoder.format, nullptr);
+    if (result < 0)
+        return fail(QString("cannot write %1: %2").arg(partialPath, avError(result)));
+
+    encoder.frame = av_frame_alloc();
+    encoder.frame->format = AV_PIX_FMT_YUV420P;
+    encoder.frame->width = spec.width;
+    encoder.frame->height = spec.height;
+    encoder.packet = av_packet_alloc();
+    if (av_frame_get_buffer(encoder.frame, 0) < 0)
+        return fail("out of memory for a frame");
+
+    for (int n = 0; n < spec.frames; ++n)
+    {
+        av_frame_make_writable(encoder.frame);
+        fillYuv420(n, spec.width, spec.height, encoder.frame->data, encoder.frame->linesize);
+        encoder.frame->pts = n;
+        result = encoder.send(encoder.frame);
+        if (result < 0)
+            return fail(QString("encoding frame %1 failed: %2").arg(n).arg(avError(result)));
+    }
+    result = encoder.send(nullptr);
+    if (result >= 0)
+        result = av_write_trailer(encoder.format);
+    if (result < 0)
+        return fail("finishing the clip failed: " + avError(result));
+    avio_closep(&encoder.format->pb);
+
+    QFile::remove(path);
+    if (!QFile::rename(partialPath, path))
+        return fail(QString("cannot rename %1").arg(partialPath));
+    return path;
+}
+
+void SyntheticClip::fillYuv420(int frameNumber, int width, int height, uint8_t *const planes[3], const int strides[3])
+{
+    int band = bandHeight(height);
+    int cellWidth = width / kNumberBits;
+
+    for (int y = 0; y < height; ++y)
+    {
+        uint8_t *row = planes[0] + static_cast<ptrdiff_t>(y) * strides[0];
+        if (y < band)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                int bit = qMin(x / qMax(1, cellWidth), kNumberBits - 1);
+                bool set = (frameNumber >> (kNumberBits - 1 - bit)) & 1;
+                row[x] = set ? kBitSet : kBitClear;
+            }
+        }
+        else
+        {
+            // Diagonal ramp sliding four pixels per frame
+            for (int x = 0; x < width; ++x)
+            {
+                row[x] = static_cast<uint8_t>(16 + (x + y + frameNumber * 4) % 220);
+            }
+        }
+    }
+
+    for (int y = 0; y < (height + 1) / 2; ++y)
+    {
+        uint8_t *u = planes[1] + static_cast<ptrdiff_t>(y) * strides[1];
+        uint8_t *v = planes[2] + static_cast<ptrdiff_t>(y) * strides[2];
+        bool inBand = y * 2 < band;
+        for (int x = 0; x < (width + 1) / 2; ++x)
+        {
+            // Neutral chroma behind the number keeps its cells pure grey after conversion
+            u[x] = inBand ? 128 : static_cast<uint8_t>(64 + ((x * 2 + frameNumber * 2) & 127));
+            v[x] = inBand ? 128 : static_cast<uint8_t>(64 + ((y * 2 + frameNumber * 3) & 127));
+        }
+    }
+}
+
+int SyntheticClip::readFrameNumber(const QImage &image)
+{
+    int band = bandHeight(image.height());
+    int cellWidth = image.width() / kNumberBits;
+    if (cellWidth < 4 || image.height() < band)
+        return -1;
+
+    QImage rgb = image.convertToFormat(QImage::Format_RGB32);
+    int number = 0;
+    for (int bit = 0; bit < kNumberBits; ++bit)
+    {
+        // Average the middle of the cell, away from edges blurred by the codec
+        qint64 sum = 0;
+        int count = 0;
+        for (int y = band / 4; y < band * 3 / 4; ++y)
+        {
+            const QRgb *row = reinterpret_cast<const QRgb *>(rgb.constScanLine(y));
+            for (int x = bit * cellWidth + cellWidth / 4; x < bit * cellWidth + cellWidth * 3 / 4; ++x)
+            {
+                sum += qGray(row[x]);
+                ++count;
+            }
+        }
+        number = (number << 1) | (sum / count >= 128 ? 1 : 0);
+    }
+    return number;
+}
@@ -0,0 +1,59 @@
+#ifndef SYNTHETICCLIP_H
+#define SYNTHETICCLIP_H
+
+#include <QImage>
+#include <QString>
+#include <cstdint>
+
+/**
+ * Deterministic test videos for the benchmarks.
+ *
+ * Every frame carries its own frame number as a row of 16 black or white
+ * cells across the top, large enough to survive lossy encoding. Below it is
+ * a gradient that moves each frame, so the encoder sees real motion. The
+ * same spec always produces the same pixels, so results from different
+ * machines and builds compare directly. A decoded frame can be checked with
+ * readFrameNumber().
+ */
+class SyntheticClip
+{
+public:
+    struct Spec
+    {
+        QString codec; // libav encoder name, e.g. "libx264" or "mpeg4"
+        int width = 1280;
+        int height = 720;
+        int gop = 30; // Frames per keyframe interval; 1 makes every frame a keyframe
+        int frames = 300;
+        int fps = 30;
+
+        /**
+         * Short name used for the file and in results, e.g. "libx264_1280x720_gop30_300f"
+         */
+        QString name() const;
+    };
+
+    /**
+     * Encode the clip unless a file for the same spec already exists in the directory
+     * @return Path of the clip, empty on failure (error describes it)
+     */
+    static QString ensure(const Spec &spec, const QString &directory, QString *error);
+
+    /**
+     * Whether this libav build has the encoder
+     */
+    static bool isEncoderAvailable(const QString &codec);
+
+    /**
+     * Draw frame n into 8-bit YUV 4:2:0 planes (Y full size, U and V half size in both directions)
+     */
+    static void fillYuv420(int frameNumber, int width, int height, uint8_t *const planes[3], const int strides[3]);
+
+    /**
+     * Read back the number drawn by fillYuv420()
+     * @return Frame number, -1 if the image is too small to hold one
+     */
+    static int readFrameNumber(const QImage &image);
+};
+
+#endif // SYNTHETICCLIP_H
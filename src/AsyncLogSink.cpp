@@ -0,0 +1,190 @@
+#include "AsyncLogSink.h"
+#include <spdlog/fmt/fmt.h>
+#include <chrono>
+
+// The flush thread wakes at least this often; info and below don't wake it
+static constexpr auto kIdleWait = std::chrono::milliseconds(50);
+
+AsyncLogSink::AsyncLogSink(std::vector<spdlog::sink_ptr> targets, size_t capacity, OverflowPolicy policy)
+    : m_targets(std::move(targets)), m_policy(policy), m_mask(0), m_enqueuePos(0), m_dequeuePos(0), m_reportedDrops(0),
+      m_dropped(0), m_highWatermark(0), m_flushRequested(false), m_quit(false)
+{
+    size_t size = 2;
+    while (size < capacity)
+        size <<= 1;
+    m_mask = size - 1;
+
+    // Slot i is free for the producer claiming position i
+    m_slots.reset(new Slot[size]);
+    for (size_t i = 0; i < size; ++i)
+    {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    m_thread = std::thread(&AsyncLogSink::run, this);
+}
+
+AsyncLogSink::~AsyncLogSink()
+{
+    m_quit.store(true, std::memory_order_release);
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void AsyncLogSink::log(const spdlog::details::log_msg &message)
+{
+    if (tryPush(message))
+    {
+        // Errors should reach the file promptly, even if the app is about to crash
+        if (message.level >= spdlog::level::warn)
+            m_wake.notify_one();
+        return;
+    }
+
+    bool wait = m_policy == OverflowPolicy::Block ||
+                (m_policy == OverflowPolicy::DropBelowWarn && message.level >= spdlog::level::warn);
+    if (!wait)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    m_wake.notify_one();
+    while (!tryPush(message))
+    {
+        std::this_thread::yield();
+    }
+}
+
+void AsyncLogSink::flush()
+{
+    m_flushRequested.store(true, std::memory_order_relaxed);
+}
+
+void AsyncLogSink::set_pattern(const std::string &pattern)
+{
+    for (const spdlog::sink_ptr &target : m_targets)
+    {
+        target->set_pattern(pattern);
+    }
+}
+
+void AsyncLogSink::set_formatter(std::unique_ptr<spdlog::formatter> formatter)
+{
+    for (const spdlog::sink_ptr &target : m_targets)
+    {
+        target->set_formatter(formatter->clone());
+    }
+}
+
+bool AsyncLogSink::tryPush(const spdlog::details::log_msg &message)
+{
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+    while (true)
+    {
+        slot = &m_slots[pos & m_mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (difference == 0)
+        {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            // The slot still holds a message from one lap ago: the ring is full
+            return false;
+        }
+        else
+        {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Copies the payload into the slot's inline buffer; no allocation for typical message lengths
+    slot->message = spdlog::details::log_msg_buffer(message);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool AsyncLogSink::drain()
+{
+    size_t written = 0;
+    while (true)
+    {
+        Slot &slot = m_slots[m_dequeuePos & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1)
+            break;
+
+        if (written == 0)
+        {
+            size_t queued = m_enqueuePos.load(std::memory_order_relaxed) - m_dequeuePos;
+            if (queued > m_highWatermark.load(std::memory_order_relaxed))
+                m_highWatermark.store(queued, std::memory_order_relaxed);
+        }
+
+        for (const spdlog::sink_ptr &target : m_targets)
+        {
+            if (target->should_log(slot.message.level))
+                target->log(slot.message);
+        }
+
+        // Hand the slot back to producers one lap ahead
+        slot.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+        ++m_dequeuePos;
+        ++written;
+    }
+    return written > 0;
+}
+
+void AsyncLogSink::reportDrops()
+{
+    size_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped == m_reportedDrops)
+        return;
+
+    std::string text = fmt::format("Logger: dropped {} messages, the log queue was full ({} in total)",
+                                   dropped - m_reportedDrops, dropped);
+    spdlog::details::log_msg message(spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}, "main", spdlog::level::warn, text);
+    for (const spdlog::sink_ptr &target : m_targets)
+    {
+        target->log(message);
+    }
+    m_reportedDrops = dropped;
+}
+
+void AsyncLogSink::run()
+{
+    while (true)
+    {
+        bool wrote = drain();
+        reportDrops();
+
+        if (m_flushRequested.exchange(false, std::memory_order_relaxed))
+        {
+            for (const spdlog::sink_ptr &target : m_targets)
+            {
+                target->flush();
+            }
+        }
+
+        if (m_quit.load(std::memory_order_acquire))
+        {
+            // Producers may still have been writing when quit was set
+            drain();
+            reportDrops();
+            for (const spdlog::sink_ptr &target : m_targets)
+            {
+                target->flush();
+            }
+            return;
+        }
+
+        if (!wrote)
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wake.wait_for(lock, kIdleWait);
+        }
+    }
+}
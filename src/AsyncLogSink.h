@@ -0,0 +1,101 @@
+#ifndef ASYNCLOGSINK_H
+#define ASYNCLOGSINK_H
+
+#include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/sinks/sink.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * spdlog sink that hands messages to other sinks on a background thread.
+ *
+ * log() copies the message into a slot of a fixed-size lock-free ring
+ * (multi-producer, single-consumer) and returns; formatting, console and
+ * file writes and flushes all happen on the flush thread. The calling
+ * thread never takes a lock or waits on I/O unless the ring is full and
+ * the overflow policy says to wait.
+ *
+ * Dropped messages are counted, and the count is written to the target
+ * sinks as a warning once there is room again.
+ */
+class AsyncLogSink : public spdlog::sinks::sink
+{
+public:
+    enum class OverflowPolicy
+    {
+        Drop,         // Discard the new message and count it
+        Block,        // Spin until the flush thread makes room
+        DropBelowWarn // Wait for warnings and errors, drop anything less severe
+    };
+
+    /**
+     * @param capacity Ring size in messages, rounded up to a power of two
+     */
+    AsyncLogSink(std::vector<spdlog::sink_ptr> targets, size_t capacity = 8192,
+                 OverflowPolicy policy = OverflowPolicy::DropBelowWarn);
+
+    /**
+     * Writes out everything still queued, then stops the flush thread
+     */
+    ~AsyncLogSink() override;
+
+    AsyncLogSink(const AsyncLogSink &) = delete;
+    AsyncLogSink &operator=(const AsyncLogSink &) = delete;
+
+    void log(const spdlog::details::log_msg &message) override;
+
+    /**
+     * Ask the flush thread to flush the targets; doesn't wait for it
+     */
+    void flush() override;
+
+    void set_pattern(const std::string &pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override;
+
+    const std::vector<spdlog::sink_ptr> &targets() const { return m_targets; }
+
+    size_t capacity() const { return m_mask + 1; }
+    size_t droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * Most messages ever waiting in the ring at once
+     */
+    size_t highWatermark() const { return m_highWatermark.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<size_t> sequence;
+        spdlog::details::log_msg_buffer message;
+    };
+
+    bool tryPush(const spdlog::details::log_msg &message);
+    bool drain();
+    void reportDrops();
+    void run();
+
+    std::vector<spdlog::sink_ptr> m_targets; // Fixed at construction; must be thread-safe (_mt) sinks
+    OverflowPolicy m_policy;
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+
+    alignas(64) std::atomic<size_t> m_enqueuePos;
+    alignas(64) size_t m_dequeuePos; // Flush thread only
+    size_t m_reportedDrops;          // Flush thread only
+
+    std::atomic<size_t> m_dropped;
+    std::atomic<size_t> m_highWatermark;
+    std::atomic_bool m_flushRequested;
+    std::atomic_bool m_quit;
+
+    // Only the flush thread sleeps; producers notify without taking the mutex
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::thread m_thread;
+};
+
+#endif // ASYNCLOGSINK_H
@@ -0,0 +1,135 @@
+#include "BatchExporter.h"
+#include "Logger.h"
+#include "VideoDecoder.h"
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <algorithm>
+
+BatchExporter::BatchExporter(QObject *parent)
+    : QThread(parent), m_cancelled(false)
+{
+    m_encoderPool.setMaxThreadCount(QThread::idealThreadCount());
+}
+
+BatchExporter::~BatchExporter()
+{
+    cancel();
+    wait();
+}
+
+void BatchExporter::setJob(const QString &videoPath, const FrameIndex &index, const QVector<Item> &items,
+                           const ImageEncoder::Settings &settings)
+{
+    m_videoPath = videoPath;
+    m_index = index;
+    m_items = items;
+    m_settings = settings;
+    m_cancelled.store(false);
+}
+
+void BatchExporter::cancel()
+{
+    m_cancelled.store(true);
+}
+
+void BatchExporter::setEncoderThreads(int count)
+{
+    m_encoderPool.setMaxThreadCount(qMax(1, count));
+}
+
+void BatchExporter::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    int total = m_items.size();
+    if (!m_index.isValid())
+    {
+        m_index = FrameIndex::build(m_videoPath, &m_cancelled);
+    }
+    VideoDecoder decoder;
+    if (total == 0 || !m_index.isValid() || !decoder.open(m_videoPath, m_index))
+    {
+        LOG_ERROR("Batch export: cannot open {}", m_videoPath.toStdString());
+        emit exportFinished(0, total, isCancelled());
+        return;
+    }
+
+    // Several timestamps can land on the same frame; decode it once and write every destination
+    QHash<int, QVector<int>> itemsByFrame;
+    QVector<int> frames;
+    for (int i = 0; i < m_items.size(); ++i)
+    {
+        int frameIndex = m_index.frameAtTime(m_items[i].timestamp);
+        if (!itemsByFrame.contains(frameIndex))
+        {
+            frames.append(frameIndex);
+        }
+        itemsByFrame[frameIndex].append(i);
+    }
+    std::sort(frames.begin(), frames.end());
+
+    LOG_INFO("Batch export: {} frames ({} unique) from {} with {} encoder threads",
+             total, frames.size(), m_videoPath.toStdString(), m_encoderPool.maxThreadCount());
+
+    // Two queued frames per encoder keeps every core busy without holding many decoded images
+    int slots = m_encoderPool.maxThreadCount() * 2;
+    m_encoderSlots.acquire(m_encoderSlots.available());
+    m_encoderSlots.release(slots);
+
+    std::atomic_int decodedCount(0);
+    std::atomic_int done(0);
+    std::atomic_int failed(0);
+    // Time the decoder spends blocked on a full encoder queue; high means encoding is the bottleneck
+    qint64 stallNs = 0;
+    bool decoded = decoder.decodeFrames(frames, [&](int frameIndex, const QImage &image)
+                                        {
+        if (isCancelled())
+            return false;
+
+        QVector<int> frameItems = itemsByFrame.value(frameIndex);
+        decodedCount.fetch_add(frameItems.size());
+        for (int item : frameItems)
+        {
+            if (!m_encoderSlots.tryAcquire())
+            {
+                qint64 waitStart = timer.nsecsElapsed();
+                m_encoderSlots.acquire();
+                stallNs += timer.nsecsElapsed() - waitStart;
+            }
+            QString path = m_items[item].path;
+            qint64 timestamp = m_items[item].timestamp;
+            m_encoderPool.start([this, image, path, timestamp, frameIndex, total, &decodedCount, &done, &failed, &timer]()
+                                {
+                if (!ImageEncoder::encode(image, path, m_settings))
+                {
+                    LOG_ERROR("Batch export: failed to write {}", path.toStdString());
+                    failed.fetch_add(1);
+                }
+                else if (m_manifest && QFileInfo(path).absolutePath() == m_manifest->directory())
+                {
+                    m_manifest->append(CaptureManifest::recordFor(image, path, timestamp, frameIndex, m_index.entry(frameIndex).pts));
+                }
+                int count = done.fetch_add(1) + 1;
+                m_encoderSlots.release();
+                double seconds = timer.nsecsElapsed() / 1e9;
+                if (seconds > 0)
+                    emit progress(count, total, decodedCount.load() / seconds, count / seconds); });
+        }
+        return true; });
+    m_encoderPool.waitForDone();
+
+    if (!decoded)
+    {
+        LOG_ERROR("Batch export: decoder failed after {} of {} frames", done.load(), total);
+    }
+
+    int written = done.load() - failed.load();
+    double seconds = timer.nsecsElapsed() / 1e9;
+    LOG_INFO("Batch export: wrote {} of {} frames in {:.2f}s (decode {:.1f} frames/s, encode {:.1f} frames/s, "
+             "decoder waited on encoders {:.0f}% of the time){}",
+             written, total, seconds, seconds > 0 ? decodedCount.load() / seconds : 0.0, seconds > 0 ? done.load() / seconds : 0.0,
+             seconds > 0 ? 100.0 * stallNs / timer.nsecsElapsed() : 0.0, isCancelled() ? ", cancelled" : "");
+    emit exportFinished(written, total - written, isCancelled());
+}
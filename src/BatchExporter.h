@@ -0,0 +1,92 @@
+#ifndef BATCHEXPORTER_H
+#define BATCHEXPORTER_H
+
+#include <QThread>
+#include <QSemaphore>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include "CaptureManifest.h"
+#include "FrameIndex.h"
+#include "ImageEncoder.h"
+
+/**
+ * Worker thread that extracts a batch of frames from one video.
+ *
+ * Requested timestamps are mapped to frame indices, sorted and decoded in a
+ * single forward sweep (one pass per GOP range, see VideoDecoder::decodeFrames).
+ * Decoded frames are fanned out to a pool of encoder threads; a semaphore
+ * bounds the frames waiting for an encoder so the decoder can't outrun them.
+ */
+class BatchExporter : public QThread
+{
+    Q_OBJECT
+
+public:
+    struct Item
+    {
+        qint64 timestamp; // Video position in ms
+        QString path;     // Destination file
+    };
+
+    explicit BatchExporter(QObject *parent = nullptr);
+    ~BatchExporter() override;
+
+    /**
+     * Configure the next export; call before start()
+     * @param videoPath Video to extract from
+     * @param index Frame index for the video; built on the worker thread if invalid
+     * @param items Frames to write, in any order
+     * @param settings Encoder settings for every written frame
+     */
+    void setJob(const QString &videoPath, const FrameIndex &index, const QVector<Item> &items,
+                const ImageEncoder::Settings &settings);
+
+    /**
+     * Record every frame written into the output directory in a capture manifest
+     * @param manifest Manifest of the same video; nullptr to record nothing
+     */
+    void setManifest(const std::shared_ptr<CaptureManifest> &manifest) { m_manifest = manifest; }
+
+    /**
+     * Ask the export to stop; frames already decoded are still written
+     */
+    void cancel();
+    bool isCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+    /**
+     * Limit the number of encoder threads (defaults to one per core)
+     */
+    void setEncoderThreads(int count);
+
+signals:
+    /**
+     * Emitted from the worker threads as frames are written
+     * @param decodeFps Frames delivered by the decoder per second since the export started
+     * @param encodeFps Frames written per second since the export started
+     */
+    void progress(int done, int total, double decodeFps, double encodeFps);
+
+    /**
+     * Emitted once all frames are written or the export was cancelled
+     */
+    void exportFinished(int written, int failed, bool cancelled);
+
+protected:
+    void run() override;
+
+private:
+    QString m_videoPath;
+    FrameIndex m_index;
+    QVector<Item> m_items;
+    ImageEncoder::Settings m_settings;
+    std::shared_ptr<CaptureManifest> m_manifest;
+
+    QThreadPool m_encoderPool;
+    QSemaphore m_encoderSlots; // Decoded frames allowed to wait for an encoder
+    std::atomic_bool m_cancelled;
+};
+
+#endif // BATCHEXPORTER_H
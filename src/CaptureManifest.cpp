@@ -0,0 +1,196 @@
+#include "CaptureManifest.h"
+#include "Logger.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+// Bytes hashed at each end of a video for its fingerprint
+static constexpr qint64 kFingerprintChunk = 64 * 1024;
+
+CaptureManifest::CaptureManifest() = default;
+
+CaptureManifest::~CaptureManifest()
+{
+    close();
+}
+
+QString CaptureManifest::manifestDirectoryName()
+{
+    return ".captures";
+}
+
+QString CaptureManifest::fingerprint(const QString &videoPath)
+{
+    QFile file(videoPath);
+    if (!file.open(QIODevice::ReadOnly))
+        return QString();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    qint64 size = file.size();
+    hash.addData(QByteArray::number(size));
+    hash.addData(file.read(kFingerprintChunk));
+    if (size > kFingerprintChunk && file.seek(qMax(kFingerprintChunk, size - kFingerprintChunk)))
+    {
+        hash.addData(file.read(kFingerprintChunk));
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+bool CaptureManifest::open(const QString &directory, const QString &videoPath)
+{
+    close();
+
+    QElapsedTimer timer;
+    timer.start();
+    QString fingerprint = CaptureManifest::fingerprint(videoPath);
+    if (fingerprint.isEmpty())
+    {
+        LOG_ERROR("Capture manifest: cannot read {}", videoPath.toStdString());
+        return false;
+    }
+
+    QDir manifestDir(QDir(directory).filePath(manifestDirectoryName()));
+    if (!manifestDir.mkpath("."))
+    {
+        LOG_ERROR("Capture manifest: cannot create {}", manifestDir.path().toStdString());
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_directory = QDir(directory).absolutePath();
+    m_videoPath = QFileInfo(videoPath).absoluteFilePath();
+    m_fingerprint = fingerprint;
+    m_file.setFileName(manifestDir.filePath(fingerprint + ".jsonl"));
+
+    if (m_file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        while (!m_file.atEnd())
+        {
+            QByteArray line = m_file.readLine().trimmed();
+            if (line.isEmpty())
+                continue;
+            QJsonObject object = QJsonDocument::fromJson(line).object();
+            Record record;
+            record.fileName = object.value("file").toString();
+            if (record.fileName.isEmpty())
+                continue;
+            record.timestampMs = object.value("ms").toInteger(-1);
+            record.pts = object.value("pts").toInteger(-1);
+            record.frameNumber = object.value("frame").toInt(-1);
+            record.format = object.value("format").toString();
+            record.width = object.value("width").toInt();
+            record.height = object.value("height").toInt();
+            record.contentHash = object.value("sha1").toString();
+            m_records.append(record);
+        }
+        m_file.close();
+    }
+
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+    {
+        LOG_ERROR("Capture manifest: cannot write {}", m_file.fileName().toStdString());
+        return false;
+    }
+
+    LOG_INFO("Capture manifest: {} captures of {} loaded in {}ms", m_records.size(),
+             QFileInfo(m_videoPath).fileName().toStdString(), timer.elapsed());
+    return true;
+}
+
+void CaptureManifest::close()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_file.isOpen())
+    {
+        m_file.close();
+    }
+    m_records.clear();
+    m_directory.clear();
+    m_videoPath.clear();
+    m_fingerprint.clear();
+}
+
+bool CaptureManifest::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_file.isOpen();
+}
+
+QString CaptureManifest::directory() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_directory;
+}
+
+QString CaptureManifest::videoPath() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_videoPath;
+}
+
+QString CaptureManifest::videoFingerprint() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_fingerprint;
+}
+
+QVector<CaptureManifest::Record> CaptureManifest::records() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_records;
+}
+
+bool CaptureManifest::append(const Record &record)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_file.isOpen())
+        return false;
+
+    QJsonObject object{
+        {"file", record.fileName},
+        {"video", m_videoPath},
+        {"videoSha1", m_fingerprint},
+        {"ms", record.timestampMs},
+        {"pts", record.pts},
+        {"frame", record.frameNumber},
+        {"format", record.format},
+        {"width", record.width},
+        {"height", record.height},
+        {"sha1", record.contentHash},
+    };
+    QByteArray line = QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+    if (m_file.write(line) != line.size() || !m_file.flush())
+    {
+        LOG_ERROR("Capture manifest: failed to append to {}", m_file.fileName().toStdString());
+        return false;
+    }
+    m_records.append(record);
+    return true;
+}
+
+CaptureManifest::Record CaptureManifest::recordFor(const QImage &image, const QString &path, qint64 timestampMs,
+                                                   int frameNumber, qint64 pts)
+{
+    Record record;
+    QFileInfo info(path);
+    record.fileName = info.fileName();
+    record.timestampMs = timestampMs;
+    record.pts = pts;
+    record.frameNumber = frameNumber;
+    record.format = info.suffix().toLower();
+    record.width = image.width();
+    record.height = image.height();
+
+    // Hash visible pixels only; row padding differs between otherwise identical images
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    const qsizetype rowBytes = static_cast<qsizetype>(image.width()) * image.depth() / 8;
+    for (int y = 0; y < image.height(); ++y)
+    {
+        hash.addData(QByteArrayView(reinterpret_cast<const char *>(image.constScanLine(y)), rowBytes));
+    }
+    record.contentHash = QString::fromLatin1(hash.result().toHex());
+    return record;
+}
@@ -0,0 +1,89 @@
+#ifndef CAPTUREMANIFEST_H
+#define CAPTUREMANIFEST_H
+
+#include <QFile>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+/**
+ * Append-only record of the frames captured from one video into one
+ * output directory.
+ *
+ * Each video gets its own JSON Lines file under .captures/ in the output
+ * directory, named after a fingerprint of the video's contents, so renaming
+ * or moving the video keeps its captures. Opening a video reads only that
+ * file, so its markers load in O(captures) without listing the directory.
+ * One line is appended per saved frame and flushed straight away; a line
+ * cut short by a crash is skipped on the next load.
+ *
+ * Thread-safe; frame writers append from their worker threads.
+ */
+class CaptureManifest
+{
+public:
+    struct Record
+    {
+        QString fileName;      // Relative to the output directory
+        qint64 timestampMs = -1;
+        qint64 pts = -1;       // In the video stream's time base, -1 if unknown
+        int frameNumber = -1;  // Index into the video's FrameIndex, -1 if unknown
+        QString format;        // File extension of the saved image
+        int width = 0;
+        int height = 0;
+        QString contentHash;   // SHA-1 of the saved pixels, hex
+    };
+
+    CaptureManifest();
+    ~CaptureManifest();
+
+    CaptureManifest(const CaptureManifest &) = delete;
+    CaptureManifest &operator=(const CaptureManifest &) = delete;
+
+    /**
+     * Load the manifest of a video in an output directory; a missing file is an empty manifest
+     * @return false if the video can't be read or the manifest can't be opened for appending
+     */
+    bool open(const QString &directory, const QString &videoPath);
+    void close();
+    bool isOpen() const;
+
+    QString directory() const;
+    QString videoPath() const;
+    QString videoFingerprint() const;
+
+    QVector<Record> records() const;
+
+    /**
+     * Append a capture and flush it to disk
+     */
+    bool append(const Record &record);
+
+    /**
+     * Build the record of a frame about to be written to path
+     */
+    static Record recordFor(const QImage &image, const QString &path, qint64 timestampMs, int frameNumber, qint64 pts);
+
+    /**
+     * Identify a video by its size and the SHA-1 of its first and last 64KB
+     * Reads 128KB at most, whatever the size of the file.
+     * @return Hex fingerprint, or an empty string if the file can't be read
+     */
+    static QString fingerprint(const QString &videoPath);
+
+    /**
+     * Directory inside the output directory that holds the manifests
+     */
+    static QString manifestDirectoryName();
+
+private:
+    mutable QMutex m_mutex;
+    QString m_directory;
+    QString m_videoPath;
+    QString m_fingerprint;
+    QVector<Record> m_records;
+    QFile m_file;
+};
+
+#endif // CAPTUREMANIFEST_H
@@ -0,0 +1,359 @@
+#include "ColorConversion.h"
+#include <algorithm>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PICKER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(PICKER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PICKER_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PICKER_TARGET(isa)
+#endif
+
+namespace
+{
+    // Samples are unpacked into a common 10-bit domain (8-bit sources are shifted up by two),
+    // so P010 keeps its precision and every layout shares the same matrix kernels.
+    constexpr int32_t kChromaOffset = 512;
+    constexpr int32_t kRound = 1 << 15;
+
+    // Fixed-point coefficients: result = (coefficient * (sample - offset) + kRound) >> 16.
+    // Coefficients are scaled by 2^14; the remaining two bits undo the 10-bit domain.
+    struct Coefficients
+    {
+        int32_t yOffset;
+        int32_t yScale;
+        int32_t rV;
+        int32_t gU;
+        int32_t gV;
+        int32_t bU;
+    };
+
+    Coefficients makeCoefficients(ColorConversion::Matrix matrix, ColorConversion::Range range)
+    {
+        double kr = 0.299;
+        double kb = 0.114;
+        switch (matrix)
+        {
+        case ColorConversion::Matrix::BT709:
+            kr = 0.2126;
+            kb = 0.0722;
+            break;
+        case ColorConversion::Matrix::BT2020:
+            kr = 0.2627;
+            kb = 0.0593;
+            break;
+        case ColorConversion::Matrix::BT601:
+        default:
+            break;
+        }
+        double kg = 1.0 - kr - kb;
+
+        bool limited = range == ColorConversion::Range::Limited;
+        double yScale = limited ? 255.0 / 219.0 : 1.0;
+        double cScale = limited ? 255.0 / 224.0 : 1.0;
+
+        auto fixed = [](double value)
+        { return static_cast<int32_t>(value * 16384.0 + (value < 0 ? -0.5 : 0.5)); };
+
+        Coefficients c;
+        c.yOffset = limited ? 16 << 2 : 0;
+        c.yScale = fixed(yScale);
+        c.rV = fixed(cScale * 2.0 * (1.0 - kr));
+        c.gU = fixed(cScale * 2.0 * kb * (1.0 - kb) / kg);
+        c.gV = fixed(cScale * 2.0 * kr * (1.0 - kr) / kg);
+        c.bU = fixed(cScale * 2.0 * (1.0 - kb));
+        return c;
+    }
+
+    inline uint32_t clampChannel(int32_t value)
+    {
+        return static_cast<uint32_t>(std::min(255, std::max(0, value)));
+    }
+
+    void matrixRowScalar(const int16_t *y, const int16_t *u, const int16_t *v, uint32_t *out, int width, const Coefficients &c)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            int32_t yy = (y[x] - c.yOffset) * c.yScale + kRound;
+            int32_t uu = u[x] - kChromaOffset;
+            int32_t vv = v[x] - kChromaOffset;
+            uint32_t r = clampChannel((yy + c.rV * vv) >> 16);
+            uint32_t g = clampChannel((yy - c.gU * uu - c.gV * vv) >> 16);
+            uint32_t b = clampChannel((yy + c.bU * uu) >> 16);
+            out[x] = 0xFF000000u | (r << 16) | (g << 8) | b;
+        }
+    }
+
+#ifdef PICKER_X86
+    PICKER_TARGET("sse4.1")
+    void matrixRowSse41(const int16_t *y, const int16_t *u, const int16_t *v, uint32_t *out, int width, const Coefficients &c)
+    {
+        const __m128i yOffset = _mm_set1_epi32(c.yOffset);
+        const __m128i yScale = _mm_set1_epi32(c.yScale);
+        const __m128i chromaOffset = _mm_set1_epi32(kChromaOffset);
+        const __m128i rV = _mm_set1_epi32(c.rV);
+        const __m128i gU = _mm_set1_epi32(c.gU);
+        const __m128i gV = _mm_set1_epi32(c.gV);
+        const __m128i bU = _mm_set1_epi32(c.bU);
+        const __m128i round = _mm_set1_epi32(kRound);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i maxValue = _mm_set1_epi32(255);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+        int x = 0;
+        for (; x + 4 <= width; x += 4)
+        {
+            __m128i yy = _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(y + x)));
+            __m128i uu = _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(u + x)));
+            __m128i vv = _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(v + x)));
+
+            yy = _mm_add_epi32(_mm_mullo_epi32(_mm_sub_epi32(yy, yOffset), yScale), round);
+            uu = _mm_sub_epi32(uu, chromaOffset);
+            vv = _mm_sub_epi32(vv, chromaOffset);
+
+            __m128i r = _mm_srai_epi32(_mm_add_epi32(yy, _mm_mullo_epi32(vv, rV)), 16);
+            __m128i g = _mm_srai_epi32(_mm_sub_epi32(_mm_sub_epi32(yy, _mm_mullo_epi32(uu, gU)), _mm_mullo_epi32(vv, gV)), 16);
+            __m128i b = _mm_srai_epi32(_mm_add_epi32(yy, _mm_mullo_epi32(uu, bU)), 16);
+
+            r = _mm_min_epi32(_mm_max_epi32(r, zero), maxValue);
+            g = _mm_min_epi32(_mm_max_epi32(g, zero), maxValue);
+            b = _mm_min_epi32(_mm_max_epi32(b, zero), maxValue);
+
+            __m128i pixels = _mm_or_si128(alpha, _mm_or_si128(_mm_slli_epi32(r, 16), _mm_or_si128(_mm_slli_epi32(g, 8), b)));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), pixels);
+        }
+        matrixRowScalar(y + x, u + x, v + x, out + x, width - x, c);
+    }
+
+    PICKER_TARGET("avx2")
+    void matrixRowAvx2(const int16_t *y, const int16_t *u, const int16_t *v, uint32_t *out, int width, const Coefficients &c)
+    {
+        const __m256i yOffset = _mm256_set1_epi32(c.yOffset);
+        const __m256i yScale = _mm256_set1_epi32(c.yScale);
+        const __m256i chromaOffset = _mm256_set1_epi32(kChromaOffset);
+        const __m256i rV = _mm256_set1_epi32(c.rV);
+        const __m256i gU = _mm256_set1_epi32(c.gU);
+        const __m256i gV = _mm256_set1_epi32(c.gV);
+        const __m256i bU = _mm256_set1_epi32(c.bU);
+        const __m256i round = _mm256_set1_epi32(kRound);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i maxValue = _mm256_set1_epi32(255);
+        const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            __m256i yy = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x)));
+            __m256i uu = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(u + x)));
+            __m256i vv = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(v + x)));
+
+            yy = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(yy, yOffset), yScale), round);
+            uu = _mm256_sub_epi32(uu, chromaOffset);
+            vv = _mm256_sub_epi32(vv, chromaOffset);
+
+            __m256i r = _mm256_srai_epi32(_mm256_add_epi32(yy, _mm256_mullo_epi32(vv, rV)), 16);
+            __m256i g = _mm256_srai_epi32(_mm256_sub_epi32(_mm256_sub_epi32(yy, _mm256_mullo_epi32(uu, gU)), _mm256_mullo_epi32(vv, gV)), 16);
+            __m256i b = _mm256_srai_epi32(_mm256_add_epi32(yy, _mm256_mullo_epi32(uu, bU)), 16);
+
+            r = _mm256_min_epi32(_mm256_max_epi32(r, zero), maxValue);
+            g = _mm256_min_epi32(_mm256_max_epi32(g, zero), maxValue);
+            b = _mm256_min_epi32(_mm256_max_epi32(b, zero), maxValue);
+
+            __m256i pixels = _mm256_or_si256(alpha, _mm256_or_si256(_mm256_slli_epi32(r, 16), _mm256_or_si256(_mm256_slli_epi32(g, 8), b)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x), pixels);
+        }
+        matrixRowScalar(y + x, u + x, v + x, out + x, width - x, c);
+    }
+#endif
+
+    using MatrixRowFunction = void (*)(const int16_t *, const int16_t *, const int16_t *, uint32_t *, int, const Coefficients &);
+
+    MatrixRowFunction matrixRowFunction(ColorConversion::Kernel kernel)
+    {
+        switch (kernel)
+        {
+#ifdef PICKER_X86
+        case ColorConversion::Kernel::AVX2:
+            return matrixRowAvx2;
+        case ColorConversion::Kernel::SSE41:
+            return matrixRowSse41;
+#endif
+        default:
+            return matrixRowScalar;
+        }
+    }
+
+    // Unpack one output row into 10-bit Y, U and V line buffers with chroma upsampled to full width
+    void unpackRow(const ColorConversion::Source &source, int row, int16_t *y, int16_t *u, int16_t *v)
+    {
+        const int width = source.width;
+        const int chromaRow = row / 2;
+
+        switch (source.layout)
+        {
+        case ColorConversion::Layout::NV12:
+        {
+            const uint8_t *luma = source.planes[0] + static_cast<ptrdiff_t>(row) * source.strides[0];
+            const uint8_t *chroma = source.planes[1] + static_cast<ptrdiff_t>(chromaRow) * source.strides[1];
+            for (int x = 0; x < width; ++x)
+            {
+                y[x] = static_cast<int16_t>(luma[x] << 2);
+                u[x] = static_cast<int16_t>(chroma[(x >> 1) * 2] << 2);
+                v[x] = static_cast<int16_t>(chroma[(x >> 1) * 2 + 1] << 2);
+            }
+            break;
+        }
+        case ColorConversion::Layout::YUV420P:
+        {
+            const uint8_t *luma = source.planes[0] + static_cast<ptrdiff_t>(row) * source.strides[0];
+            const uint8_t *cb = source.planes[1] + static_cast<ptrdiff_t>(chromaRow) * source.strides[1];
+            const uint8_t *cr = source.planes[2] + static_cast<ptrdiff_t>(chromaRow) * source.strides[2];
+            for (int x = 0; x < width; ++x)
+            {
+                y[x] = static_cast<int16_t>(luma[x] << 2);
+                u[x] = static_cast<int16_t>(cb[x >> 1] << 2);
+                v[x] = static_cast<int16_t>(cr[x >> 1] << 2);
+            }
+            break;
+        }
+        case ColorConversion::Layout::P010:
+        {
+            const uint16_t *luma = reinterpret_cast<const uint16_t *>(source.planes[0] + static_cast<ptrdiff_t>(row) * source.strides[0]);
+            const uint16_t *chroma = reinterpret_cast<const uint16_t *>(source.planes[1] + static_cast<ptrdiff_t>(chromaRow) * source.strides[1]);
+            for (int x = 0; x < width; ++x)
+            {
+                y[x] = static_cast<int16_t>(luma[x] >> 6);
+                u[x] = static_cast<int16_t>(chroma[(x >> 1) * 2] >> 6);
+                v[x] = static_cast<int16_t>(chroma[(x >> 1) * 2 + 1] >> 6);
+            }
+            break;
+        }
+        case ColorConversion::Layout::YUYV:
+        {
+            const uint8_t *packed = source.planes[0] + static_cast<ptrdiff_t>(row) * source.strides[0];
+            for (int x = 0; x < width; ++x)
+            {
+                y[x] = static_cast<int16_t>(packed[x * 2] << 2);
+                u[x] = static_cast<int16_t>(packed[(x >> 1) * 4 + 1] << 2);
+                v[x] = static_cast<int16_t>(packed[(x >> 1) * 4 + 3] << 2);
+            }
+            break;
+        }
+        }
+    }
+
+    bool hasRequiredPlanes(const ColorConversion::Source &source)
+    {
+        switch (source.layout)
+        {
+        case ColorConversion::Layout::YUV420P:
+            return source.planes[0] && source.planes[1] && source.planes[2];
+        case ColorConversion::Layout::NV12:
+        case ColorConversion::Layout::P010:
+            return source.planes[0] && source.planes[1];
+        case ColorConversion::Layout::YUYV:
+            return source.planes[0] != nullptr;
+        }
+        return false;
+    }
+}
+
+bool ColorConversion::convert(const Source &source, uint8_t *destination, int destinationStride, Kernel kernel)
+{
+    if (!destination || source.width <= 0 || source.height <= 0 || !hasRequiredPlanes(source))
+        return false;
+
+    if (kernel == Kernel::Auto || !isSupported(kernel))
+        kernel = bestKernel();
+
+    const Coefficients coefficients = makeCoefficients(source.matrix, source.range);
+    const MatrixRowFunction matrixRow = matrixRowFunction(kernel);
+
+    // One small line buffer per plane keeps the unpacked row in L1 for the matrix pass
+    std::vector<int16_t> lineBuffer(static_cast<size_t>(source.width) * 3);
+    int16_t *y = lineBuffer.data();
+    int16_t *u = y + source.width;
+    int16_t *v = u + source.width;
+
+    for (int row = 0; row < source.height; ++row)
+    {
+        unpackRow(source, row, y, u, v);
+        uint32_t *out = reinterpret_cast<uint32_t *>(destination + static_cast<ptrdiff_t>(row) * destinationStride);
+        matrixRow(y, u, v, out, source.width, coefficients);
+    }
+    return true;
+}
+
+ColorConversion::Matrix ColorConversion::defaultMatrix(int width, int height)
+{
+    return (width > 1024 || height >= 720) ? Matrix::BT709 : Matrix::BT601;
+}
+
+ColorConversion::Kernel ColorConversion::bestKernel()
+{
+    static const Kernel best = []()
+    {
+        if (isSupported(Kernel::AVX2))
+            return Kernel::AVX2;
+        if (isSupported(Kernel::SSE41))
+            return Kernel::SSE41;
+        return Kernel::Scalar;
+    }();
+    return best;
+}
+
+bool ColorConversion::isSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::Auto:
+    case Kernel::Scalar:
+        return true;
+#if defined(PICKER_X86) && (defined(__GNUC__) || defined(__clang__))
+    case Kernel::SSE41:
+        return __builtin_cpu_supports("sse4.1");
+    case Kernel::AVX2:
+        return __builtin_cpu_supports("avx2");
+#elif defined(PICKER_X86) && defined(_MSC_VER)
+    case Kernel::SSE41:
+    {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 19)) != 0;
+    }
+    case Kernel::AVX2:
+    {
+        int info[4];
+        __cpuid(info, 1);
+        bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+        __cpuidex(info, 7, 0);
+        return osSavesYmm && (info[1] & (1 << 5)) != 0;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+const char *ColorConversion::kernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::Auto:
+        return kernelName(bestKernel());
+    case Kernel::SSE41:
+        return "SSE4.1";
+    case Kernel::AVX2:
+        return "AVX2";
+    case Kernel::Scalar:
+    default:
+        return "Scalar";
+    }
+}
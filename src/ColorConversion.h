@@ -0,0 +1,86 @@
+#ifndef COLORCONVERSION_H
+#define COLORCONVERSION_H
+
+#include <cstdint>
+
+/**
+ * Single-pass YUV to RGB32 conversion for captured and exported frames.
+ *
+ * Converts the common decoder output layouts straight into the final export
+ * pixel layout (QImage::Format_RGB32, i.e. 0xFFRRGGBB per pixel), replacing
+ * QVideoFrame::toImage() followed by a separate convertToFormat() pass.
+ * Each row is unpacked into a small line buffer and then run through a
+ * SIMD matrix kernel selected at runtime (AVX2, SSE4.1 or scalar).
+ */
+class ColorConversion
+{
+public:
+    enum class Layout
+    {
+        NV12,    // 8-bit Y plane + interleaved UV plane, 4:2:0
+        YUV420P, // 8-bit Y, U and V planes, 4:2:0
+        P010,    // 16-bit little-endian Y plane + interleaved UV plane, 10 bits in the high bits, 4:2:0
+        YUYV     // 8-bit packed Y0 U Y1 V, 4:2:2
+    };
+
+    enum class Matrix
+    {
+        BT601,
+        BT709,
+        BT2020
+    };
+
+    enum class Range
+    {
+        Limited, // Y in [16, 235], chroma in [16, 240] (video range)
+        Full     // Y and chroma in [0, 255]
+    };
+
+    enum class Kernel
+    {
+        Auto, // Best kernel supported by the running CPU
+        Scalar,
+        SSE41,
+        AVX2
+    };
+
+    struct Source
+    {
+        Layout layout;
+        const uint8_t *planes[3]; // Unused planes may be null
+        int strides[3];           // Bytes per line of each plane
+        int width;
+        int height;
+        Matrix matrix;
+        Range range;
+    };
+
+    /**
+     * Convert a frame into a 32-bit RGB buffer
+     * @param source Frame planes and colour description
+     * @param destination First byte of the output (width * 4 bytes per row at least)
+     * @param destinationStride Bytes per output row
+     * @param kernel Kernel to use; unsupported kernels fall back to the best available one
+     * @return false if the source description is invalid
+     */
+    static bool convert(const Source &source, uint8_t *destination, int destinationStride, Kernel kernel = Kernel::Auto);
+
+    /**
+     * Matrix to assume when a stream doesn't signal one: BT.709 for HD and up, BT.601 for SD
+     */
+    static Matrix defaultMatrix(int width, int height);
+
+    /**
+     * Best kernel available on this CPU
+     */
+    static Kernel bestKernel();
+
+    /**
+     * Whether a kernel can run on this CPU
+     */
+    static bool isSupported(Kernel kernel);
+
+    static const char *kernelName(Kernel kernel);
+};
+
+#endif // COLORCONVERSION_H
@@ -0,0 +1,409 @@
+#include "ExtractionQueue.h"
+#include "CaptureManifest.h"
+#include "FrameFilename.h"
+#include "FrameIndex.h"
+#include "Logger.h"
+#include "VideoDecoder.h"
+#include "WorkStealingPool.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutexLocker>
+#include <QVector>
+#include <algorithm>
+
+// Wanted frames decoded per decode step before the worker goes back to the pool
+static constexpr int kDecodeChunkFrames = 8;
+// Decoded frames a video may have waiting for encoders before its decoder parks
+static constexpr int kMaxPendingEncodes = 8;
+// Jobs indexed ahead of a free decoder slot
+static constexpr int kIndexAhead = 2;
+// Reference and in-flight frames an H.264/HEVC decoder holds beyond one per thread
+static constexpr int kDecoderReferenceFrames = 16;
+
+struct ExtractionQueue::JobState
+{
+    int id = 0;
+    ExtractionJob spec;
+    QString prefix;
+
+    FrameIndex index;
+    QVector<int> frames;                   // Wanted frames, ascending
+    struct Output
+    {
+        QString path;
+        qint64 timestamp; // Requested position the file is named after
+    };
+    QHash<int, QVector<Output>> outputsByFrame; // Destinations of each wanted frame
+    CaptureManifest manifest;                   // Records every frame written
+    int total = 0;
+    qint64 memoryEstimate = 0;
+    int decoderThreads = 1;
+
+    // Only touched by the job's single decode step at a time
+    std::unique_ptr<VideoDecoder> decoder;
+    int nextFrame = 0;
+
+    // One unit for the decoder plus one per queued encode; the job ends when it drops to zero
+    std::atomic_int outstanding{1};
+    std::atomic_int pendingEncodes{0};
+    std::atomic_bool decodeParked{false};
+    std::atomic_int written{0};
+    std::atomic_int failed{0};
+};
+
+ExtractionQueue::ExtractionQueue(int threadCount, QObject *parent)
+    : QObject(parent), m_pool(std::make_unique<WorkStealingPool>(threadCount)), m_indexing(0), m_decoders(0), m_maxDecoders(0), m_unfinished(0), m_finished(0), m_nextId(1), m_memoryBudget(2048LL * 1024 * 1024), m_memoryInUse(0), m_framesTotal(0), m_framesWritten(0), m_framesFailed(0), m_cancelled(false)
+{
+    LOG_INFO("Extraction queue: {} worker threads", m_pool->threadCount());
+}
+
+ExtractionQueue::~ExtractionQueue()
+{
+    cancel();
+    m_pool->waitForIdle();
+}
+
+void ExtractionQueue::setMemoryBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_memoryBudget = qMax<qint64>(0, bytes);
+    scheduleLocked();
+}
+
+void ExtractionQueue::setMaxDecoders(int count)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxDecoders = qMax(0, count);
+    scheduleLocked();
+}
+
+qint64 ExtractionQueue::memoryBudget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_memoryBudget;
+}
+
+int ExtractionQueue::threadCount() const
+{
+    return m_pool->threadCount();
+}
+
+int ExtractionQueue::addJob(const ExtractionJob &spec)
+{
+    auto job = std::make_shared<JobState>();
+    job->spec = spec;
+    job->prefix = spec.prefix.isEmpty() ? FrameFilename::prefixForVideo(spec.videoPath) : spec.prefix;
+
+    QMutexLocker locker(&m_mutex);
+    m_cancelled.store(false);
+    if (m_unfinished == 0)
+    {
+        // First job of a new run; every counter of the last run has settled
+        m_finished = 0;
+        m_framesTotal = 0;
+        m_framesWritten.store(0);
+        m_framesFailed.store(0);
+    }
+    job->id = m_nextId++;
+    ++m_unfinished;
+    m_waiting.append(job);
+    scheduleLocked();
+    return job->id;
+}
+
+void ExtractionQueue::cancel()
+{
+    QList<std::shared_ptr<JobState>> dropped;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_cancelled.store(true);
+        dropped = m_waiting + m_ready;
+        m_waiting.clear();
+        m_ready.clear();
+    }
+
+    // Jobs that never got a decoder still have to report that they ended
+    for (const std::shared_ptr<JobState> &job : dropped)
+    {
+        releaseWork(job);
+    }
+}
+
+void ExtractionQueue::waitForDone()
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_unfinished > 0)
+    {
+        m_doneCondition.wait(&m_mutex);
+    }
+}
+
+ExtractionQueue::Stats ExtractionQueue::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats stats;
+    stats.jobsWaiting = m_waiting.size();
+    stats.jobsActive = m_unfinished - m_waiting.size();
+    stats.jobsFinished = m_finished;
+    stats.framesWritten = m_framesWritten.load();
+    stats.framesFailed = m_framesFailed.load();
+    stats.framesTotal = m_framesTotal;
+    stats.decoders = m_decoders;
+    stats.memoryInUse = m_memoryInUse;
+    stats.steals = m_pool->stealCount();
+    return stats;
+}
+
+void ExtractionQueue::scheduleLocked()
+{
+    if (m_cancelled.load())
+        return;
+
+    // Open decoders while they fit in the budget; never more than there are workers to run them
+    int maxDecoders = m_maxDecoders > 0 ? qMin(m_maxDecoders, m_pool->threadCount()) : m_pool->threadCount();
+    while (!m_ready.isEmpty() && m_decoders < maxDecoders)
+    {
+        std::shared_ptr<JobState> job = m_ready.first();
+        if (m_decoders > 0 && m_memoryInUse + job->memoryEstimate > m_memoryBudget)
+            break;
+
+        m_ready.removeFirst();
+        ++m_decoders;
+        m_memoryInUse += job->memoryEstimate;
+        // Many small decoders share the cores; a lone decoder gets more threads
+        job->decoderThreads = qBound(1, m_pool->threadCount() / (m_decoders + m_ready.size()), 8);
+        LOG_DEBUG("Extraction queue: decoder {} opened for {} (~{}MB, {} threads)", m_decoders,
+                  job->spec.videoPath.toStdString(), job->memoryEstimate / (1024 * 1024), job->decoderThreads);
+        m_pool->submit([this, job]()
+                       { decodeStep(job); });
+    }
+
+    // Keep a couple of videos indexed so a freed decoder slot is refilled at once
+    while (!m_waiting.isEmpty() && m_indexing + m_ready.size() < kIndexAhead)
+    {
+        std::shared_ptr<JobState> job = m_waiting.takeFirst();
+        ++m_indexing;
+        m_pool->submit([this, job]()
+                       { indexJob(job); });
+    }
+}
+
+void ExtractionQueue::indexJob(const std::shared_ptr<JobState> &job)
+{
+    const ExtractionJob &spec = job->spec;
+    if (!m_cancelled.load())
+    {
+        job->index = FrameIndex::build(spec.videoPath, &m_cancelled);
+    }
+
+    QList<qint64> timestamps;
+    if (job->index.isValid())
+    {
+        if (spec.everyFrames > 0 || spec.everyMs > 0)
+        {
+            for (int frame : job->index.sampleFrames(spec.inPoint, spec.outPoint, spec.everyFrames, spec.everyMs))
+            {
+                timestamps.append(job->index.timestampMs(frame));
+            }
+        }
+        else if (!spec.timestampsFromDirectory.isEmpty())
+        {
+            QDir directory(spec.timestampsFromDirectory);
+            for (const QFileInfo &file : directory.entryInfoList(FrameFilename::imageNameFilters(), QDir::Files))
+            {
+                qint64 timestamp = FrameFilename::parseTimestamp(file.fileName(), job->prefix);
+                if (timestamp >= 0)
+                {
+                    timestamps.append(timestamp);
+                }
+            }
+        }
+        else
+        {
+            timestamps = spec.timestamps;
+        }
+    }
+
+    // Map positions to frames; several positions can land on one frame
+    QDir outputDir(spec.outputDirectory);
+    outputDir.mkpath(".");
+    std::sort(timestamps.begin(), timestamps.end());
+    timestamps.erase(std::unique(timestamps.begin(), timestamps.end()), timestamps.end());
+    for (qint64 timestamp : timestamps)
+    {
+        int frame = job->index.frameAtTime(timestamp);
+        if (!job->outputsByFrame.contains(frame))
+        {
+            job->frames.append(frame);
+        }
+        job->outputsByFrame[frame].append({outputDir.absoluteFilePath(FrameFilename::generate(job->prefix, timestamp, spec.encoder.format)), timestamp});
+    }
+    std::sort(job->frames.begin(), job->frames.end());
+    job->total = timestamps.size();
+
+    // Decoder memory: YUV reference/thread frames plus RGB32 frames queued for encoding
+    qint64 pixels = static_cast<qint64>(qMax(1, job->index.width())) * qMax(1, job->index.height());
+    qint64 yuvFrame = pixels * 3 / 2;
+    qint64 rgbFrame = pixels * 4;
+    int threads = qBound(1, m_pool->threadCount(), 8);
+    job->memoryEstimate = yuvFrame * (threads + kDecoderReferenceFrames) + rgbFrame * kMaxPendingEncodes;
+
+    bool runnable = job->index.isValid() && !job->frames.isEmpty();
+    if (runnable)
+    {
+        job->manifest.open(outputDir.absolutePath(), spec.videoPath);
+    }
+    if (!job->index.isValid() && !m_cancelled.load())
+    {
+        LOG_ERROR("Extraction queue: cannot index {}", spec.videoPath.toStdString());
+        job->failed.store(1);
+        m_framesFailed.fetch_add(1);
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        --m_indexing;
+        m_framesTotal += job->total;
+        if (runnable && !m_cancelled.load())
+        {
+            m_ready.append(job);
+        }
+        else
+        {
+            runnable = false;
+        }
+        scheduleLocked();
+    }
+
+    if (!runnable)
+    {
+        releaseWork(job);
+    }
+}
+
+void ExtractionQueue::decodeStep(const std::shared_ptr<JobState> &job)
+{
+    if (!job->decoder && !m_cancelled.load())
+    {
+        job->decoder = std::make_unique<VideoDecoder>();
+        job->decoder->setThreadCount(job->decoderThreads);
+        if (job->decoder->open(job->spec.videoPath, job->index))
+        {
+            emit jobStarted(job->id, job->spec.videoPath, job->total);
+        }
+    }
+
+    bool ok = job->decoder && job->decoder->isOpen() && !m_cancelled.load();
+    if (ok)
+    {
+        QVector<int> chunk = job->frames.mid(job->nextFrame, kDecodeChunkFrames);
+        job->nextFrame += chunk.size();
+        ok = job->decoder->decodeFrames(chunk, [this, job](int frameIndex, const QImage &image)
+                                        {
+            for (const JobState::Output &output : job->outputsByFrame.value(frameIndex))
+            {
+                job->outstanding.fetch_add(1);
+                job->pendingEncodes.fetch_add(1);
+                m_pool->submit([this, job, image, frameIndex, output]()
+                               { encodeFrame(job, image, frameIndex, output.path, output.timestamp); });
+            }
+            return !m_cancelled.load(); });
+    }
+
+    if (!ok || job->nextFrame >= job->frames.size() || m_cancelled.load())
+    {
+        // Frames the decoder never reached count as failed
+        if (!m_cancelled.load())
+        {
+            for (int i = job->nextFrame; i < job->frames.size(); ++i)
+            {
+                int missing = job->outputsByFrame.value(job->frames[i]).size();
+                job->failed.fetch_add(missing);
+                m_framesFailed.fetch_add(missing);
+            }
+            if (!ok)
+            {
+                LOG_ERROR("Extraction queue: decoding {} failed", job->spec.videoPath.toStdString());
+            }
+        }
+        releaseDecoder(job);
+        releaseWork(job);
+        return;
+    }
+
+    // Let the encoders catch up before decoding more; the last encode to drain resumes us
+    if (job->pendingEncodes.load() >= kMaxPendingEncodes)
+    {
+        job->decodeParked.store(true);
+        if (job->pendingEncodes.load() >= kMaxPendingEncodes || !job->decodeParked.exchange(false))
+            return;
+    }
+    m_pool->submit([this, job]()
+                   { decodeStep(job); });
+}
+
+void ExtractionQueue::encodeFrame(const std::shared_ptr<JobState> &job, const QImage &image, int frameIndex,
+                                  const QString &path, qint64 timestamp)
+{
+    if (ImageEncoder::encode(image, path, job->spec.encoder))
+    {
+        job->written.fetch_add(1);
+        m_framesWritten.fetch_add(1);
+        if (job->manifest.isOpen())
+        {
+            job->manifest.append(CaptureManifest::recordFor(image, path, timestamp, frameIndex, job->index.entry(frameIndex).pts));
+        }
+    }
+    else
+    {
+        LOG_ERROR("Extraction queue: failed to write {}", path.toStdString());
+        job->failed.fetch_add(1);
+        m_framesFailed.fetch_add(1);
+    }
+
+    int done = job->written.load() + job->failed.load();
+    emit jobProgress(job->id, done, job->total);
+
+    // Resume a parked decoder once half its queue has drained
+    if (job->pendingEncodes.fetch_sub(1) - 1 <= kMaxPendingEncodes / 2 && job->decodeParked.exchange(false))
+    {
+        m_pool->submit([this, job]()
+                       { decodeStep(job); });
+    }
+    releaseWork(job);
+}
+
+void ExtractionQueue::releaseDecoder(const std::shared_ptr<JobState> &job)
+{
+    job->decoder.reset();
+
+    QMutexLocker locker(&m_mutex);
+    --m_decoders;
+    m_memoryInUse -= job->memoryEstimate;
+    scheduleLocked();
+}
+
+void ExtractionQueue::releaseWork(const std::shared_ptr<JobState> &job)
+{
+    if (job->outstanding.fetch_sub(1) != 1)
+        return;
+
+    int written = job->written.load();
+    int failed = job->failed.load();
+    LOG_INFO("Extraction queue: {} done, {} written, {} failed", job->spec.videoPath.toStdString(), written, failed);
+    emit jobFinished(job->id, job->spec.videoPath, written, failed);
+
+    bool drained;
+    {
+        QMutexLocker locker(&m_mutex);
+        --m_unfinished;
+        ++m_finished;
+        drained = m_unfinished == 0;
+        m_doneCondition.wakeAll();
+    }
+    if (drained)
+    {
+        emit allJobsFinished();
+    }
+}
@@ -0,0 +1,153 @@
+#ifndef EXTRACTIONQUEUE_H
+#define EXTRACTIONQUEUE_H
+
+#include <QObject>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
+#include "ImageEncoder.h"
+
+class WorkStealingPool;
+
+/**
+ * What to extract from one video.
+ * Frames come from exactly one source: explicit timestamps, the names of frames
+ * already saved in a directory, or uniform sampling (every N frames or X ms).
+ */
+struct ExtractionJob
+{
+    QString videoPath;
+    QString outputDirectory;
+    QString prefix; // Empty: derived from the video's name
+    ImageEncoder::Settings encoder;
+
+    QList<qint64> timestamps;         // Video positions in ms
+    QString timestampsFromDirectory;  // Re-extract the frames saved here for this prefix
+    int everyFrames = 0;              // Sample every Nth frame...
+    qint64 everyMs = 0;               // ...or one frame every X ms
+    qint64 inPoint = -1;              // Sampling range in ms, -1 for the start...
+    qint64 outPoint = -1;             // ...and the end of the video
+};
+
+/**
+ * Extracts frames from many videos at once on a shared work-stealing pool.
+ *
+ * Each job goes through three kinds of task on the same pool: indexing,
+ * decode steps and encodes. A decode step decodes a short run of wanted frames
+ * and queues one encode per frame on its own worker; idle workers steal them.
+ * Only one decode step per video exists at a time, and a video that is too far
+ * ahead of its encoders parks until they catch up.
+ *
+ * The number of open decoders is capped by a memory budget. Each decoder's
+ * reference frames and queued RGB frames are estimated from the video size.
+ * Workers not busy decoding therefore spend their time encoding.
+ */
+class ExtractionQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Stats
+    {
+        int jobsWaiting;  // Not yet indexed
+        int jobsActive;   // Indexed, decoding or encoding
+        int jobsFinished;
+        int framesWritten;
+        int framesFailed;
+        int framesTotal;  // Known once a job is indexed
+        int decoders;     // Decoders currently open
+        qint64 memoryInUse;
+        quint64 steals;
+    };
+
+    /**
+     * @param threadCount Pool workers; 0 means one per core
+     */
+    explicit ExtractionQueue(int threadCount = 0, QObject *parent = nullptr);
+    ~ExtractionQueue() override;
+
+    /**
+     * Upper bound on the estimated memory of all open decoders (default 2 GB)
+     * At least one decoder always runs, whatever its size.
+     */
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const;
+
+    /**
+     * Hard cap on open decoders on top of the memory budget; 0 means one per worker
+     */
+    void setMaxDecoders(int count);
+
+    /**
+     * Queue a video; work starts immediately
+     * Adding to an idle queue starts a new run, which resets the counters in stats().
+     * @return Job id passed to the signals
+     */
+    int addJob(const ExtractionJob &job);
+
+    /**
+     * Drop waiting jobs and stop decoding; frames already decoded are still written
+     */
+    void cancel();
+
+    /**
+     * Block until every job has finished; must not be called from a pool task
+     */
+    void waitForDone();
+
+    /**
+     * Progress of the current run, or of the last one once the queue is idle
+     */
+    Stats stats() const;
+    int threadCount() const;
+
+signals:
+    // All signals are emitted from pool threads
+
+    /**
+     * A job was indexed and its first decoder opened
+     */
+    void jobStarted(int id, const QString &videoPath, int totalFrames);
+    void jobProgress(int id, int done, int total);
+    void jobFinished(int id, const QString &videoPath, int written, int failed);
+
+    /**
+     * The queue ran empty
+     */
+    void allJobsFinished();
+
+private:
+    struct JobState;
+
+    void scheduleLocked();
+    void indexJob(const std::shared_ptr<JobState> &job);
+    void decodeStep(const std::shared_ptr<JobState> &job);
+    void encodeFrame(const std::shared_ptr<JobState> &job, const QImage &image, int frameIndex, const QString &path, qint64 timestamp);
+    void releaseDecoder(const std::shared_ptr<JobState> &job);
+    void releaseWork(const std::shared_ptr<JobState> &job);
+
+    std::unique_ptr<WorkStealingPool> m_pool;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_doneCondition;
+    QList<std::shared_ptr<JobState>> m_waiting; // Not yet indexed
+    QList<std::shared_ptr<JobState>> m_ready;   // Indexed, waiting for a decoder slot
+    int m_indexing;
+    int m_decoders;
+    int m_maxDecoders;
+    int m_unfinished;
+    int m_finished;
+    int m_nextId;
+    qint64 m_memoryBudget;
+    qint64 m_memoryInUse;
+    int m_framesTotal;
+
+    std::atomic_int m_framesWritten;
+    std::atomic_int m_framesFailed;
+    std::atomic_bool m_cancelled;
+};
+
+#endif // EXTRACTIONQUEUE_H
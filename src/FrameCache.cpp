@@ -0,0 +1,120 @@
+#include "FrameCache.h"
+#include <QMutexLocker>
+#include <iterator>
+
+FrameCache::FrameCache(int maxFrames, qint64 maxBytes)
+    : m_center(0), m_maxFrames(qMax(1, maxFrames)), m_maxBytes(qMax<qint64>(1, maxBytes)), m_bytes(0), m_hits(0), m_misses(0)
+{
+}
+
+void FrameCache::setLimits(int maxFrames, qint64 maxBytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxFrames = qMax(1, maxFrames);
+    m_maxBytes = qMax<qint64>(1, maxBytes);
+    evictLocked();
+}
+
+int FrameCache::maxFrames() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxFrames;
+}
+
+qint64 FrameCache::maxBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxBytes;
+}
+
+bool FrameCache::lookup(int frameIndex, QImage *image)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_frames.constFind(frameIndex);
+    if (it == m_frames.constEnd())
+    {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    if (image)
+    {
+        *image = it.value();
+    }
+    return true;
+}
+
+bool FrameCache::contains(int frameIndex) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_frames.contains(frameIndex);
+}
+
+void FrameCache::insert(int frameIndex, const QImage &image)
+{
+    if (image.isNull())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_frames.find(frameIndex);
+    if (it != m_frames.end())
+    {
+        m_bytes -= it.value().sizeInBytes();
+        it.value() = image;
+    }
+    else
+    {
+        m_frames.insert(frameIndex, image);
+    }
+    m_bytes += image.sizeInBytes();
+    evictLocked();
+}
+
+void FrameCache::setCenter(int frameIndex)
+{
+    QMutexLocker locker(&m_mutex);
+    m_center = frameIndex;
+    evictLocked();
+}
+
+void FrameCache::setPinned(const QVector<int> &frameIndices)
+{
+    QMutexLocker locker(&m_mutex);
+    m_pinned = QSet<int>(frameIndices.cbegin(), frameIndices.cend());
+    evictLocked();
+}
+
+void FrameCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_frames.clear();
+    m_pinned.clear();
+    m_bytes = 0;
+    m_hits.store(0, std::memory_order_relaxed);
+    m_misses.store(0, std::memory_order_relaxed);
+}
+
+FrameCache::Stats FrameCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return {m_hits.load(std::memory_order_relaxed), m_misses.load(std::memory_order_relaxed),
+            static_cast<int>(m_frames.size()), m_bytes};
+}
+
+void FrameCache::evictLocked()
+{
+    while (!m_frames.isEmpty() && (m_frames.size() > m_maxFrames || m_bytes > m_maxBytes))
+    {
+        // Drop whichever end of the window is farther from the centre, stepping over pinned frames
+        auto first = m_frames.begin();
+        auto last = std::prev(m_frames.end());
+        while (first != last && m_pinned.contains(first.key()))
+            ++first;
+        while (last != first && m_pinned.contains(last.key()))
+            --last;
+        auto victim = (m_center - first.key() > last.key() - m_center) ? first : last;
+        m_bytes -= victim.value().sizeInBytes();
+        m_frames.erase(victim);
+    }
+}
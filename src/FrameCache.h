@@ -0,0 +1,77 @@
+#ifndef FRAMECACHE_H
+#define FRAMECACHE_H
+
+#include <QImage>
+#include <QMap>
+#include <QMutex>
+#include <QSet>
+#include <QVector>
+#include <atomic>
+
+/**
+ * Bounded cache of decoded frames centred on the playhead.
+ *
+ * Frames are keyed by frame index. When either the frame count or the byte
+ * budget is exceeded, the frame farthest from the current centre is evicted,
+ * so the cache behaves like a ring sliding along with the playhead.
+ * All methods are thread-safe; decoder threads insert while the GUI reads.
+ */
+class FrameCache
+{
+public:
+    struct Stats
+    {
+        quint64 hits;
+        quint64 misses;
+        int frames;
+        qint64 bytes;
+    };
+
+    FrameCache(int maxFrames = 120, qint64 maxBytes = 512LL * 1024 * 1024);
+
+    void setLimits(int maxFrames, qint64 maxBytes);
+    int maxFrames() const;
+    qint64 maxBytes() const;
+
+    /**
+     * Look up a frame and count the hit or miss
+     * @return true and fill image if the frame is cached
+     */
+    bool lookup(int frameIndex, QImage *image);
+
+    /**
+     * Check for a frame without touching the hit/miss counters
+     */
+    bool contains(int frameIndex) const;
+
+    void insert(int frameIndex, const QImage &image);
+
+    /**
+     * Move the centre of the cache window and evict frames that no longer fit
+     */
+    void setCenter(int frameIndex);
+
+    /**
+     * Keep these frames however far they are from the centre, e.g. the next jump targets
+     * Replaces the previous set; an empty list unpins everything.
+     */
+    void setPinned(const QVector<int> &frameIndices);
+
+    void clear();
+    Stats stats() const;
+
+private:
+    void evictLocked();
+
+    mutable QMutex m_mutex;
+    QMap<int, QImage> m_frames; // Ordered by frame index, so the farthest frame is always at an end
+    QSet<int> m_pinned;
+    int m_center;
+    int m_maxFrames;
+    qint64 m_maxBytes;
+    qint64 m_bytes;
+    std::atomic<quint64> m_hits;
+    std::atomic<quint64> m_misses;
+};
+
+#endif // FRAMECACHE_H
@@ -1,5 +1,6 @@
 #include "FrameCaptureSink.h"
 #include "Logger.h"
+#include "PerfStats.h"
 #include <QDateTime>
 
 FrameCaptureSink::FrameCaptureSink(QObject *parent)
@@ -9,11 +10,23 @@ FrameCaptureSink::FrameCaptureSink(QObject *parent)
     connect(this, &QVideoSink::videoFrameChanged, this, &FrameCaptureSink::onFrameChanged);
 }
 
+void FrameCaptureSink::setDisplaySink(QVideoSink *sink)
+{
+    m_displaySink = (sink == this) ? nullptr : sink;
+}
+
 void FrameCaptureSink::onFrameChanged(const QVideoFrame &frame)
 {
     // Store the current frame for later retrieval
     m_currentFrame = frame;
 
+    // Forward to the display; QVideoFrame is shared, so this is a reference, not a copy
+    if (m_displaySink)
+    {
+        m_displaySink->setVideoFrame(frame);
+    }
+    PerfStats::frameDisplayed();
+
     // NOTE: Disabled all logging in frame capture to eliminate potential UI overhead
     // This method is called 30-60 times per second during video playback
 
@@ -4,10 +4,15 @@
 #include <QVideoSink>
 #include <QVideoFrame>
 #include <QObject>
+#include <QPointer>
 
 /**
  * Custom QVideoSink implementation for capturing video frames
  * from the media player for saving to disk.
+ *
+ * The media player renders into this sink, which keeps a reference to the
+ * latest frame and forwards it to the display sink, so the captured frame
+ * is exactly the one on screen and never needs a second decode.
  */
 class FrameCaptureSink : public QVideoSink
 {
@@ -22,6 +27,12 @@ public:
      */
     QVideoFrame getCurrentFrame() const { return m_currentFrame; }
 
+    /**
+     * Set the sink that displays the frames received by this sink
+     * @param sink Display sink, e.g. QVideoWidget::videoSink(); nullptr to stop forwarding
+     */
+    void setDisplaySink(QVideoSink *sink);
+
 public slots:
     /**
      * Slot called when a new video frame is available
@@ -38,6 +49,7 @@ signals:
 
 private:
     QVideoFrame m_currentFrame;
+    QPointer<QVideoSink> m_displaySink;
 };
 
 #endif // FRAMECAPTURESINK_H
@@ -0,0 +1,189 @@
+#include "FrameDirectoryIndex.h"
+#include "Logger.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QSet>
+#include <QtConcurrent/QtConcurrentRun>
+
+// Change notifications closer together than this are handled by one rescan
+static constexpr int kDebounceMs = 250;
+
+FrameDirectoryIndex::FrameDirectoryIndex(QObject *parent)
+    : QObject(parent), m_loaded(false), m_generation(0), m_rescanPending(false)
+{
+    m_debounceTimer.setSingleShot(true);
+    m_debounceTimer.setInterval(kDebounceMs);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, &m_debounceTimer, qOverload<>(&QTimer::start));
+    connect(&m_debounceTimer, &QTimer::timeout, this, &FrameDirectoryIndex::onDirectoryChanged);
+    connect(&m_scanWatcher, &QFutureWatcher<ScanResult>::finished, this, &FrameDirectoryIndex::onScanFinished);
+}
+
+FrameDirectoryIndex::~FrameDirectoryIndex()
+{
+    m_scanWatcher.waitForFinished();
+}
+
+void FrameDirectoryIndex::setDirectory(const QString &directory)
+{
+    QString absolute = QDir(directory).absolutePath();
+    if (absolute == m_directory)
+        return;
+
+    if (!m_watcher.directories().isEmpty())
+    {
+        m_watcher.removePaths(m_watcher.directories());
+    }
+    m_debounceTimer.stop();
+
+    m_directory = absolute;
+    m_loaded = false;
+    ++m_generation;
+    m_files.clear();
+    m_timestamps.clear();
+
+    if (QFileInfo(m_directory).isDir() && !m_watcher.addPath(m_directory))
+    {
+        LOG_WARN("Frame directory index: cannot watch {} - new files show up on the next open", m_directory.toStdString());
+    }
+    startScan(true);
+}
+
+void FrameDirectoryIndex::addFile(const QString &fileName)
+{
+    if (m_files.contains(fileName))
+        return;
+    insert(fileName, FrameFilename::parse(fileName));
+    emit updated();
+}
+
+QVector<qint64> FrameDirectoryIndex::timestamps(const QString &prefix) const
+{
+    auto it = m_timestamps.constFind(prefix.toCaseFolded());
+    if (it == m_timestamps.constEnd())
+        return QVector<qint64>();
+    return it.value().keys();
+}
+
+void FrameDirectoryIndex::onDirectoryChanged()
+{
+    startScan(!m_loaded);
+}
+
+void FrameDirectoryIndex::startScan(bool full)
+{
+    if (m_directory.isEmpty())
+        return;
+
+    // One scan at a time; a change during a scan is picked up by one more scan afterwards
+    if (m_scanWatcher.isRunning())
+    {
+        m_rescanPending = true;
+        return;
+    }
+    m_rescanPending = false;
+
+    // The hash is implicitly shared, so handing it to the worker doesn't copy it
+    FileReadings known = full ? FileReadings() : m_files;
+    m_scanWatcher.setFuture(QtConcurrent::run(&FrameDirectoryIndex::scan, m_directory, m_generation, known, full));
+}
+
+FrameDirectoryIndex::ScanResult FrameDirectoryIndex::scan(const QString &directory, int generation, const FileReadings &known, bool full)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ScanResult result{generation, full, FileReadings(), QStringList()};
+    QStringList names = QDir(directory).entryList(FrameFilename::imageNameFilters(), QDir::Files);
+
+    // Only names that weren't there last time get parsed
+    QSet<QString> listed;
+    listed.reserve(names.size());
+    for (const QString &name : names)
+    {
+        listed.insert(name);
+        if (!known.contains(name))
+        {
+            result.added.insert(name, FrameFilename::parse(name));
+        }
+    }
+    for (auto it = known.cbegin(); it != known.cend(); ++it)
+    {
+        if (!listed.contains(it.key()))
+        {
+            result.removed.append(it.key());
+        }
+    }
+
+    LOG_DEBUG("Frame directory index: listed {} files in {}ms ({} new, {} gone)",
+              names.size(), timer.elapsed(), result.added.size(), result.removed.size());
+    return result;
+}
+
+void FrameDirectoryIndex::onScanFinished()
+{
+    ScanResult result = m_scanWatcher.result();
+    if (result.generation == m_generation)
+    {
+        for (const QString &name : result.removed)
+        {
+            remove(name);
+        }
+        for (auto it = result.added.cbegin(); it != result.added.cend(); ++it)
+        {
+            if (!m_files.contains(it.key()))
+            {
+                insert(it.key(), it.value());
+            }
+        }
+
+        if (result.full)
+        {
+            m_loaded = true;
+            LOG_INFO("Frame directory index: {} image files in {}", m_files.size(), m_directory.toStdString());
+            emit loaded(m_files.size());
+        }
+        else if (!result.added.isEmpty() || !result.removed.isEmpty())
+        {
+            emit updated();
+        }
+    }
+
+    // A superseded directory always needs its own full scan
+    if (m_rescanPending || result.generation != m_generation)
+    {
+        startScan(!m_loaded);
+    }
+}
+
+void FrameDirectoryIndex::insert(const QString &fileName, const QVector<FrameFilename::Reading> &readings)
+{
+    m_files.insert(fileName, readings);
+    for (const FrameFilename::Reading &reading : readings)
+    {
+        ++m_timestamps[reading.prefix.toCaseFolded()][reading.timestamp];
+    }
+}
+
+void FrameDirectoryIndex::remove(const QString &fileName)
+{
+    auto file = m_files.find(fileName);
+    if (file == m_files.end())
+        return;
+
+    for (const FrameFilename::Reading &reading : file.value())
+    {
+        QString prefix = reading.prefix.toCaseFolded();
+        QMap<qint64, int> &positions = m_timestamps[prefix];
+        auto position = positions.find(reading.timestamp);
+        if (position != positions.end() && --position.value() <= 0)
+        {
+            positions.erase(position);
+        }
+        if (positions.isEmpty())
+        {
+            m_timestamps.remove(prefix);
+        }
+    }
+    m_files.erase(file);
+}
@@ -0,0 +1,96 @@
+#ifndef FRAMEDIRECTORYINDEX_H
+#define FRAMEDIRECTORYINDEX_H
+
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include "FrameFilename.h"
+
+/**
+ * In-memory index of the frames saved in the output directory, by prefix.
+ *
+ * The directory is listed and parsed once on a worker thread. After that a
+ * QFileSystemWatcher reports changes; each change lists the directory again
+ * (names only) and parses just the files that appeared, so a folder of tens of
+ * thousands of frames never blocks the GUI thread or gets parsed twice.
+ *
+ * All methods must be called from the thread that owns the object.
+ */
+class FrameDirectoryIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FrameDirectoryIndex(QObject *parent = nullptr);
+    ~FrameDirectoryIndex() override;
+
+    /**
+     * Start indexing a directory; loaded() is emitted once its listing has been parsed
+     */
+    void setDirectory(const QString &directory);
+    QString directory() const { return m_directory; }
+    bool isLoaded() const { return m_loaded; }
+
+    /**
+     * Record a file written by this process without waiting for the watcher
+     */
+    void addFile(const QString &fileName);
+
+    /**
+     * Video positions of every frame saved with a prefix, ascending and without duplicates
+     * Prefixes compare case-insensitively, like file names on the platforms we ship on.
+     */
+    QVector<qint64> timestamps(const QString &prefix) const;
+
+    int fileCount() const { return m_files.size(); }
+    bool contains(const QString &fileName) const { return m_files.contains(fileName); }
+
+signals:
+    /**
+     * The initial listing of the directory has been parsed
+     */
+    void loaded(int files);
+
+    /**
+     * Files were added to or removed from the directory after it was loaded
+     */
+    void updated();
+
+private slots:
+    void onDirectoryChanged();
+    void onScanFinished();
+
+private:
+    using FileReadings = QHash<QString, QVector<FrameFilename::Reading>>;
+
+    struct ScanResult
+    {
+        int generation;
+        bool full;          // Listing of a newly set directory
+        FileReadings added; // Names not known before, with their readings
+        QStringList removed;
+    };
+
+    static ScanResult scan(const QString &directory, int generation, const FileReadings &known, bool full);
+    void startScan(bool full);
+    void insert(const QString &fileName, const QVector<FrameFilename::Reading> &readings);
+    void remove(const QString &fileName);
+
+    QString m_directory;
+    bool m_loaded;
+    int m_generation; // Bumped per directory, so results of a superseded scan are dropped
+    bool m_rescanPending;
+
+    FileReadings m_files;                           // Every image file, with its readings
+    QHash<QString, QMap<qint64, int>> m_timestamps; // Folded prefix -> position -> number of files
+
+    QFileSystemWatcher m_watcher;
+    QTimer m_debounceTimer; // Collapses bursts of change notifications (batch exports) into one rescan
+    QFutureWatcher<ScanResult> m_scanWatcher;
+};
+
+#endif // FRAMEDIRECTORYINDEX_H
@@ -0,0 +1,127 @@
+#include "FrameFilename.h"
+#include "Logger.h"
+#include <QFileInfo>
+#include <QRegularExpression>
+
+QString FrameFilename::generate(const QString &prefix, qint64 videoPosition, ImageEncoder::Format format)
+{
+    // Use millisecond precision instead of seconds for better uniqueness
+    // Format: {prefix}_{milliseconds}.{extension of the selected image format}
+    // This provides much better precision for frame-by-frame captures
+    return QString("%1_%2.%3")
+        .arg(prefix)
+        .arg(videoPosition)
+        .arg(ImageEncoder::fileExtension(format));
+}
+
+namespace
+{
+    bool isImageExtension(QStringView extension)
+    {
+        static const char *const extensions[] = {"png", "jpg", "jpeg", "webp", "qoi", "bmp", "tiff"};
+        for (const char *candidate : extensions)
+        {
+            if (extension.compare(QLatin1String(candidate), Qt::CaseInsensitive) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool isDigits(QStringView text, int length = -1)
+    {
+        if (text.isEmpty() || (length >= 0 && text.size() != length))
+            return false;
+        for (QChar c : text)
+        {
+            if (c < QLatin1Char('0') || c > QLatin1Char('9'))
+                return false;
+        }
+        return true;
+    }
+}
+
+QVector<FrameFilename::Reading> FrameFilename::parse(QStringView filename)
+{
+    QVector<Reading> readings;
+    qsizetype dot = filename.lastIndexOf(QLatin1Char('.'));
+    if (dot < 0 || !isImageExtension(filename.mid(dot + 1)))
+        return readings;
+
+    // Split the last (up to) six underscore-separated fields off the stem, right to left
+    QStringView stem = filename.left(dot);
+    constexpr int kMaxFields = 6;
+    QStringView fields[kMaxFields];
+    qsizetype separators[kMaxFields];
+    int count = 0;
+    qsizetype end = stem.size();
+    while (count < kMaxFields)
+    {
+        qsizetype underscore = stem.lastIndexOf(QLatin1Char('_'), end - 1);
+        if (underscore < 0)
+            break;
+        fields[count] = stem.mid(underscore + 1, end - underscore - 1);
+        separators[count] = underscore;
+        ++count;
+        end = underscore;
+        if (end == 0)
+            break;
+    }
+
+    bool ok = false;
+
+    // Current format: prefix_<position>
+    if (count >= 1 && isDigits(fields[0]))
+    {
+        qint64 position = fields[0].toLongLong(&ok);
+        if (ok)
+            readings.append({stem.left(separators[0]).toString(), position});
+    }
+
+    // Old detailed format: prefix_<yyyyMMdd>_<hhmmss>_<zzz>_<position>ms_<width>_<height>
+    if (count == kMaxFields && isDigits(fields[0]) && isDigits(fields[1]) && fields[2].endsWith(QLatin1String("ms")) &&
+        isDigits(fields[2].chopped(2)) && isDigits(fields[3], 3) && isDigits(fields[4], 6) && isDigits(fields[5], 8))
+    {
+        qint64 position = fields[2].chopped(2).toLongLong(&ok);
+        if (ok)
+            readings.append({stem.left(separators[5]).toString(), position});
+    }
+    return readings;
+}
+
+qint64 FrameFilename::parseTimestamp(const QString &filename, const QString &prefix)
+{
+    for (const Reading &reading : parse(filename))
+    {
+        if (reading.prefix.compare(prefix, Qt::CaseInsensitive) == 0)
+            return reading.timestamp;
+    }
+    return -1;
+}
+
+QString FrameFilename::prefixForVideo(const QString &videoPath)
+{
+    QFileInfo fileInfo(videoPath);
+    QString baseName = fileInfo.baseName(); // Gets filename without extension
+
+    // Check if it looks like a YouTube ID (11 characters followed by underscore)
+    if (baseName.length() >= 12 && baseName.at(11) == '_')
+    {
+        QString potentialYouTubeId = baseName.left(11);
+        // YouTube IDs are alphanumeric with possible dashes and underscores
+        QRegularExpression youtubeIdPattern("^[A-Za-z0-9_-]{11}$");
+        if (youtubeIdPattern.match(potentialYouTubeId).hasMatch())
+        {
+            LOG_INFO("Detected YouTube ID format: {}", potentialYouTubeId.toStdString());
+            return potentialYouTubeId;
+        }
+    }
+
+    // Fallback: use the full filename (without extension) as prefix
+    LOG_INFO("Using full filename as prefix: {}", baseName.toStdString());
+    return baseName;
+}
+
+QStringList FrameFilename::imageNameFilters()
+{
+    return {"*.png", "*.jpg", "*.jpeg", "*.webp", "*.qoi", "*.bmp", "*.tiff"};
+}
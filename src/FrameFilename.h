@@ -0,0 +1,62 @@
+#ifndef FRAMEFILENAME_H
+#define FRAMEFILENAME_H
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+#include "ImageEncoder.h"
+
+/**
+ * Naming scheme for saved frames, shared by the GUI and headless extraction.
+ *
+ * Frames are named <prefix>_<video position in ms>.<extension>. Files from
+ * older releases (<prefix>_<date>_<time>_<ms>_<position>ms_<w>_<h>.<ext>)
+ * are still recognised when reading a directory back. Names are matched by
+ * hand rather than by regular expression, since directories of tens of
+ * thousands of frames are parsed on every open.
+ */
+class FrameFilename
+{
+public:
+    /**
+     * Build the file name for a frame
+     */
+    static QString generate(const QString &prefix, qint64 videoPosition, ImageEncoder::Format format);
+
+    /**
+     * One way of splitting a file name into prefix and video position
+     */
+    struct Reading
+    {
+        QString prefix;
+        qint64 timestamp;
+    };
+
+    /**
+     * Every prefix/position reading of a file name, without knowing the prefix
+     * The name is parsed from the right, so prefixes may contain underscores;
+     * that makes some names ambiguous (e.g. "a_1_2.png" is prefix "a_1" at
+     * 2ms) and up to two readings come back. Names of the old format without
+     * a position give none.
+     */
+    static QVector<Reading> parse(QStringView filename);
+
+    /**
+     * Recover the video position from a saved frame's file name
+     * @return Position in ms, or -1 if the name doesn't belong to prefix or carries no position
+     */
+    static qint64 parseTimestamp(const QString &filename, const QString &prefix);
+
+    /**
+     * Default prefix for a video: its YouTube ID if the name starts with one, else its base name
+     */
+    static QString prefixForVideo(const QString &videoPath);
+
+    /**
+     * Glob patterns matching every image format frames may be saved in
+     */
+    static QStringList imageNameFilters();
+};
+
+#endif // FRAMEFILENAME_H
@@ -0,0 +1,307 @@
+#include "FrameHashIndex.h"
+#include "Logger.h"
+#include "PerceptualHash.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QTextStream>
+
+namespace
+{
+    inline quint16 chunkOf(uint64_t hash, int chunk)
+    {
+        return static_cast<quint16>(hash >> (16 * chunk));
+    }
+
+    // Call visit(value) for every 16-bit value within radius bits of center, starting at bit firstBit
+    template <typename Visitor>
+    void forEachNeighbour(quint16 value, int radius, int firstBit, Visitor &visit)
+    {
+        visit(value);
+        if (radius == 0)
+            return;
+        for (int bit = firstBit; bit < 16; ++bit)
+        {
+            forEachNeighbour(static_cast<quint16>(value ^ (1u << bit)), radius - 1, bit + 1, visit);
+        }
+    }
+}
+
+FrameHashIndex::FrameHashIndex()
+    : m_size(0)
+{
+}
+
+QString FrameHashIndex::indexFileName()
+{
+    return ".frame_hashes";
+}
+
+bool FrameHashIndex::open(const QString &directory, const std::atomic_bool *cancelled)
+{
+    QMutexLocker locker(&m_mutex);
+    clearLocked();
+    m_directory = QDir(directory).absolutePath();
+
+    QFile file(QDir(m_directory).filePath(indexFileName()));
+    if (!file.exists())
+        return true;
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        LOG_ERROR("Hash index: cannot read {}", file.fileName().toStdString());
+        return false;
+    }
+
+    // One directory listing instead of a stat per entry
+    const QStringList present = QDir(m_directory).entryList(QDir::Files);
+    QSet<QString> existing(present.cbegin(), present.cend());
+
+    int lines = 0;
+    QTextStream stream(&file);
+    while (!stream.atEnd())
+    {
+        if (cancelled && cancelled->load())
+        {
+            // Half an index would hide duplicates; the next open starts over
+            clearLocked();
+            return false;
+        }
+        QString line = stream.readLine();
+        int space = line.indexOf(' ');
+        if (space <= 0)
+            continue;
+        ++lines;
+        bool ok;
+        uint64_t hash = line.left(space).toULongLong(&ok, 16);
+        QString fileName = line.mid(space + 1);
+        if (ok && existing.contains(fileName))
+        {
+            insertLocked(fileName, hash);
+        }
+    }
+
+    // Drop stale and superseded lines so the file doesn't grow without bound
+    if (lines > m_size)
+    {
+        rewriteFile();
+    }
+    LOG_INFO("Hash index: {} frames in {}", m_size, m_directory.toStdString());
+    return true;
+}
+
+void FrameHashIndex::close()
+{
+    QMutexLocker locker(&m_mutex);
+    clearLocked();
+}
+
+QString FrameHashIndex::directory() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_directory;
+}
+
+int FrameHashIndex::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_size;
+}
+
+bool FrameHashIndex::contains(const QString &fileName) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entryForName.contains(fileName);
+}
+
+void FrameHashIndex::add(const QString &fileName, uint64_t hash)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_directory.isEmpty())
+        return;
+    insertLocked(fileName, hash);
+    appendToFile(fileName, hash);
+}
+
+FrameHashIndex::Match FrameHashIndex::findNearest(uint64_t hash, int maxDistance)
+{
+    QMutexLocker locker(&m_mutex);
+    return findNearestLocked(hash, maxDistance);
+}
+
+FrameHashIndex::Match FrameHashIndex::findOrReserve(uint64_t hash, int maxDistance, const QString &fileName)
+{
+    QMutexLocker locker(&m_mutex);
+    Match match = findNearestLocked(hash, maxDistance);
+    if (!match.isValid() && !m_directory.isEmpty())
+    {
+        insertLocked(fileName, hash);
+        m_reserved.insert(fileName);
+    }
+    return match;
+}
+
+void FrameHashIndex::commitReservation(const QString &fileName, uint64_t hash)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_directory.isEmpty())
+        return;
+    // Reopened while the frame was written: the reservation is gone, so add it afresh
+    if (!m_reserved.remove(fileName))
+        insertLocked(fileName, hash);
+    appendToFile(fileName, hash);
+}
+
+void FrameHashIndex::cancelReservation(const QString &fileName)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_reserved.remove(fileName))
+        return;
+    auto entry = m_entryForName.constFind(fileName);
+    if (entry != m_entryForName.cend())
+        removeLocked(entry.value());
+}
+
+FrameHashIndex::Match FrameHashIndex::findNearestLocked(uint64_t hash, int maxDistance)
+{
+    Match match;
+    while (true)
+    {
+        int distance = -1;
+        int entry = bestMatchLocked(hash, qBound(0, maxDistance, 64), &distance);
+        if (entry < 0)
+            return match;
+
+        // Frames deleted by hand since the index was loaded must not suppress new ones
+        if (m_reserved.contains(m_names[entry]) || QFileInfo::exists(QDir(m_directory).filePath(m_names[entry])))
+        {
+            match.fileName = m_names[entry];
+            match.distance = distance;
+            return match;
+        }
+        removeLocked(entry);
+    }
+}
+
+void FrameHashIndex::clearLocked()
+{
+    m_directory.clear();
+    m_hashes.clear();
+    m_names.clear();
+    m_entryForName.clear();
+    m_reserved.clear();
+    for (QHash<quint16, QVector<int>> &table : m_tables)
+        table.clear();
+    m_size = 0;
+}
+
+int FrameHashIndex::bestMatchLocked(uint64_t hash, int maxDistance, int *distance) const
+{
+    int best = -1;
+    int bestDistance = maxDistance + 1;
+    auto consider = [&](int entry)
+    {
+        if (m_names[entry].isEmpty())
+            return;
+        int d = PerceptualHash::distance(hash, m_hashes[entry]);
+        if (d < bestDistance)
+        {
+            bestDistance = d;
+            best = entry;
+        }
+    };
+
+    // Past 15 bits every chunk needs 4+ bit neighbourhoods; a linear scan is cheaper then
+    int chunkRadius = maxDistance / kChunks;
+    if (chunkRadius > 3)
+    {
+        for (int entry = 0; entry < m_hashes.size(); ++entry)
+            consider(entry);
+    }
+    else
+    {
+        for (int chunk = 0; chunk < kChunks && bestDistance > 0; ++chunk)
+        {
+            const QHash<quint16, QVector<int>> &table = m_tables[chunk];
+            auto probe = [&](quint16 value)
+            {
+                auto it = table.constFind(value);
+                if (it == table.cend())
+                    return;
+                for (int entry : it.value())
+                    consider(entry);
+            };
+            forEachNeighbour(chunkOf(hash, chunk), chunkRadius, 0, probe);
+        }
+    }
+
+    if (best >= 0)
+        *distance = bestDistance;
+    return best;
+}
+
+void FrameHashIndex::insertLocked(const QString &fileName, uint64_t hash)
+{
+    auto existing = m_entryForName.constFind(fileName);
+    if (existing != m_entryForName.cend())
+    {
+        removeLocked(existing.value());
+    }
+
+    int entry = m_hashes.size();
+    m_hashes.append(hash);
+    m_names.append(fileName);
+    m_entryForName.insert(fileName, entry);
+    for (int chunk = 0; chunk < kChunks; ++chunk)
+    {
+        m_tables[chunk][chunkOf(hash, chunk)].append(entry);
+    }
+    ++m_size;
+}
+
+void FrameHashIndex::removeLocked(int entry)
+{
+    uint64_t hash = m_hashes[entry];
+    for (int chunk = 0; chunk < kChunks; ++chunk)
+    {
+        auto it = m_tables[chunk].find(chunkOf(hash, chunk));
+        if (it != m_tables[chunk].end())
+        {
+            it.value().removeOne(entry);
+            if (it.value().isEmpty())
+                m_tables[chunk].erase(it);
+        }
+    }
+    m_entryForName.remove(m_names[entry]);
+    m_names[entry].clear();
+    --m_size;
+}
+
+bool FrameHashIndex::appendToFile(const QString &fileName, uint64_t hash)
+{
+    QFile file(QDir(m_directory).filePath(indexFileName()));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+    {
+        LOG_WARN("Hash index: cannot append to {}", file.fileName().toStdString());
+        return false;
+    }
+    QTextStream(&file) << QString::number(hash, 16).rightJustified(16, '0') << ' ' << fileName << '\n';
+    return true;
+}
+
+bool FrameHashIndex::rewriteFile()
+{
+    QSaveFile file(QDir(m_directory).filePath(indexFileName()));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    QTextStream stream(&file);
+    for (int entry = 0; entry < m_hashes.size(); ++entry)
+    {
+        if (!m_names[entry].isEmpty())
+            stream << QString::number(m_hashes[entry], 16).rightJustified(16, '0') << ' ' << m_names[entry] << '\n';
+    }
+    stream.flush();
+    return file.commit();
+}
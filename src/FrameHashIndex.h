@@ -0,0 +1,104 @@
+#ifndef FRAMEHASHINDEX_H
+#define FRAMEHASHINDEX_H
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Persistent perceptual-hash index of the frames in one output directory.
+ *
+ * Hashes live in a small text file next to the frames, one "hash name" line
+ * per frame, appended as frames are saved. Near-duplicate lookups use
+ * multi-index hashing: the 64-bit hash is split into four 16-bit chunks,
+ * each with its own table. Any hash within distance r of the query matches
+ * it in at least one chunk to within r / 4 bits. Only those few buckets are
+ * probed, which keeps lookups in the microseconds with 100k+ frames.
+ *
+ * Thread-safe; frame writers query and extend it from their worker threads.
+ */
+class FrameHashIndex
+{
+public:
+    struct Match
+    {
+        QString fileName; // Relative to the indexed directory
+        int distance = -1;
+
+        bool isValid() const { return distance >= 0; }
+    };
+
+    FrameHashIndex();
+
+    /**
+     * Load the index of a directory, dropping entries whose files are gone
+     * @param cancelled Checked between lines; a cancelled load leaves the index closed
+     * @return false if the index file exists but could not be read, or the load was cancelled
+     */
+    bool open(const QString &directory, const std::atomic_bool *cancelled = nullptr);
+    void close();
+
+    QString directory() const;
+    int size() const;
+    bool contains(const QString &fileName) const;
+
+    /**
+     * Record the hash of a frame saved in the directory; replaces an older entry for the same file
+     */
+    void add(const QString &fileName, uint64_t hash);
+
+    /**
+     * Closest indexed frame within maxDistance bits
+     * Matches whose file has been deleted since are dropped from the index and skipped.
+     */
+    Match findNearest(uint64_t hash, int maxDistance);
+
+    /**
+     * findNearest(), and when nothing matches, reserve fileName with the hash in the same step
+     * A frame being encoded then counts as a duplicate for the next one straight away.
+     * The reservation must be completed with commitReservation() or cancelReservation().
+     */
+    Match findOrReserve(uint64_t hash, int maxDistance, const QString &fileName);
+
+    /**
+     * The reserved frame was written; records it in the index file
+     */
+    void commitReservation(const QString &fileName, uint64_t hash);
+
+    /**
+     * The reserved frame was not written; drops it from the index
+     */
+    void cancelReservation(const QString &fileName);
+
+    /**
+     * Name of the index file inside the directory
+     */
+    static QString indexFileName();
+
+private:
+    static constexpr int kChunks = 4;
+
+    void clearLocked();
+    Match findNearestLocked(uint64_t hash, int maxDistance);
+    int bestMatchLocked(uint64_t hash, int maxDistance, int *distance) const;
+    void insertLocked(const QString &fileName, uint64_t hash);
+    void removeLocked(int entry);
+    bool appendToFile(const QString &fileName, uint64_t hash);
+    bool rewriteFile();
+
+    mutable QMutex m_mutex;
+    QString m_directory;
+    QVector<uint64_t> m_hashes;
+    QStringList m_names;                  // Empty for removed entries
+    QHash<QString, int> m_entryForName;
+    QSet<QString> m_reserved;             // Entries whose files are still being written
+    QHash<quint16, QVector<int>> m_tables[kChunks];
+    int m_size;
+};
+
+#endif // FRAMEHASHINDEX_H
@@ -0,0 +1,198 @@
+#include "FrameIndex.h"
+#include "Logger.h"
+#include <QElapsedTimer>
+#include <algorithm>
+
+extern "C"
+{
+#include <libavformat/avformat.h>
+#include <libavutil/mathematics.h>
+}
+
+FrameIndex FrameIndex::build(const QString &videoPath, const std::atomic_bool *cancelled)
+{
+    FrameIndex index;
+    QElapsedTimer timer;
+    timer.start();
+
+    AVFormatContext *formatContext = nullptr;
+    QByteArray path = videoPath.toUtf8();
+    if (avformat_open_input(&formatContext, path.constData(), nullptr, nullptr) < 0)
+    {
+        LOG_ERROR("Frame index: failed to open {}", videoPath.toStdString());
+        return index;
+    }
+
+    if (avformat_find_stream_info(formatContext, nullptr) < 0)
+    {
+        LOG_ERROR("Frame index: failed to read stream info for {}", videoPath.toStdString());
+        avformat_close_input(&formatContext);
+        return index;
+    }
+
+    int streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (streamIndex < 0)
+    {
+        LOG_ERROR("Frame index: no video stream in {}", videoPath.toStdString());
+        avformat_close_input(&formatContext);
+        return index;
+    }
+
+    // Only the video stream matters - let the demuxer skip everything else
+    for (unsigned int i = 0; i < formatContext->nb_streams; ++i)
+    {
+        formatContext->streams[i]->discard = (static_cast<int>(i) == streamIndex) ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+    }
+
+    AVStream *stream = formatContext->streams[streamIndex];
+    QVector<Entry> entries;
+    if (stream->nb_frames > 0)
+    {
+        entries.reserve(static_cast<int>(stream->nb_frames));
+    }
+
+    AVPacket *packet = av_packet_alloc();
+    bool aborted = false;
+    while (av_read_frame(formatContext, packet) >= 0)
+    {
+        if (cancelled && cancelled->load(std::memory_order_relaxed))
+        {
+            aborted = true;
+            av_packet_unref(packet);
+            break;
+        }
+
+        if (packet->stream_index == streamIndex && !(packet->flags & AV_PKT_FLAG_DISCARD))
+        {
+            qint64 pts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+            if (pts != AV_NOPTS_VALUE)
+            {
+                entries.append({pts, 0, (packet->flags & AV_PKT_FLAG_KEY) != 0});
+            }
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+
+    if (aborted)
+    {
+        LOG_DEBUG("Frame index: scan of {} cancelled", videoPath.toStdString());
+        avformat_close_input(&formatContext);
+        return index;
+    }
+
+    // Packets arrive in decode order; B-frames make that differ from presentation order
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b)
+              { return a.pts < b.pts; });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry &a, const Entry &b)
+                              { return a.pts == b.pts; }),
+                  entries.end());
+
+    if (!entries.isEmpty())
+    {
+        qint64 startPts = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : entries.first().pts;
+        for (int i = 0; i < entries.size(); ++i)
+        {
+            Entry &entry = entries[i];
+            // Round up so that seeking to timeMs never lands on the previous frame
+            entry.timeMs = qMax<qint64>(0, av_rescale_q_rnd(entry.pts - startPts, stream->time_base, AVRational{1, 1000},
+                                                            static_cast<AVRounding>(AV_ROUND_UP | AV_ROUND_PASS_MINMAX)));
+            if (entry.keyframe)
+            {
+                index.m_keyframes.append(i);
+            }
+        }
+    }
+
+    index.m_entries = std::move(entries);
+    index.m_streamIndex = streamIndex;
+    index.m_timeBaseNum = stream->time_base.num;
+    index.m_timeBaseDen = stream->time_base.den;
+    index.m_width = stream->codecpar->width;
+    index.m_height = stream->codecpar->height;
+
+    avformat_close_input(&formatContext);
+
+    LOG_INFO("Frame index: {} frames, {} keyframes, {:.2f} fps, built in {}ms",
+             index.frameCount(), index.keyframeCount(), index.averageFrameRate(), timer.elapsed());
+    return index;
+}
+
+qint64 FrameIndex::timestampMs(int index) const
+{
+    if (m_entries.isEmpty())
+        return 0;
+    return m_entries[qBound(0, index, m_entries.size() - 1)].timeMs;
+}
+
+int FrameIndex::frameAtTime(qint64 ms) const
+{
+    if (m_entries.isEmpty())
+        return -1;
+
+    auto it = std::upper_bound(m_entries.cbegin(), m_entries.cend(), ms, [](qint64 value, const Entry &entry)
+                               { return value < entry.timeMs; });
+    if (it == m_entries.cbegin())
+        return 0;
+    return static_cast<int>(std::distance(m_entries.cbegin(), it)) - 1;
+}
+
+int FrameIndex::frameForPts(qint64 pts) const
+{
+    auto it = std::lower_bound(m_entries.cbegin(), m_entries.cend(), pts, [](const Entry &entry, qint64 value)
+                               { return entry.pts < value; });
+    if (it == m_entries.cend() || it->pts != pts)
+        return -1;
+    return static_cast<int>(std::distance(m_entries.cbegin(), it));
+}
+
+int FrameIndex::keyframeAtOrBefore(int index) const
+{
+    auto it = std::upper_bound(m_keyframes.cbegin(), m_keyframes.cend(), index);
+    if (it == m_keyframes.cbegin())
+        return 0;
+    return *(it - 1);
+}
+
+double FrameIndex::averageFrameRate() const
+{
+    if (m_entries.size() < 2)
+        return 0.0;
+
+    qint64 spanMs = m_entries.last().timeMs - m_entries.first().timeMs;
+    if (spanMs <= 0)
+        return 0.0;
+    return (m_entries.size() - 1) * 1000.0 / spanMs;
+}
+
+QVector<int> FrameIndex::sampleFrames(qint64 startMs, qint64 endMs, int frameStep, qint64 msStep) const
+{
+    QVector<int> frames;
+    if (!isValid() || (frameStep <= 0 && msStep <= 0))
+        return frames;
+
+    if (startMs < 0)
+        startMs = 0;
+    if (endMs < 0)
+        endMs = timestampMs(frameCount() - 1);
+
+    if (frameStep > 0)
+    {
+        int lastFrame = frameAtTime(endMs);
+        for (int frame = frameAtTime(startMs); frame <= lastFrame; frame += frameStep)
+        {
+            frames.append(frame);
+        }
+        return frames;
+    }
+
+    for (qint64 time = startMs; time <= endMs; time += msStep)
+    {
+        int frame = frameAtTime(time);
+        if (frames.isEmpty() || frames.last() != frame)
+        {
+            frames.append(frame);
+        }
+    }
+    return frames;
+}
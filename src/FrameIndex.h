@@ -0,0 +1,95 @@
+#ifndef FRAMEINDEX_H
+#define FRAMEINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+/**
+ * Sorted presentation-order index of every frame in a video stream.
+ *
+ * The index is built by a demux-only pass over the container (packets are
+ * read but never decoded), so it is cheap enough to run in the background
+ * right after a video is opened. It lets frame stepping move exactly one
+ * frame and lets seeks start decoding from the nearest keyframe.
+ */
+class FrameIndex
+{
+public:
+    struct Entry
+    {
+        qint64 pts;    // Presentation timestamp in stream time base
+        qint64 timeMs; // Presentation time relative to stream start, rounded up to whole ms
+        bool keyframe;
+    };
+
+    FrameIndex() = default;
+
+    /**
+     * Build the index for the best video stream of a file
+     * @param videoPath Path to the video file
+     * @param cancelled Optional flag polled between packets to abort the scan
+     * @return The populated index, or an invalid index on failure/cancellation
+     */
+    static FrameIndex build(const QString &videoPath, const std::atomic_bool *cancelled = nullptr);
+
+    bool isValid() const { return !m_entries.isEmpty(); }
+    int frameCount() const { return m_entries.size(); }
+    int keyframeCount() const { return m_keyframes.size(); }
+    const Entry &entry(int index) const { return m_entries[index]; }
+
+    int streamIndex() const { return m_streamIndex; }
+    int timeBaseNum() const { return m_timeBaseNum; }
+    int timeBaseDen() const { return m_timeBaseDen; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    /**
+     * Presentation time of a frame in milliseconds, clamped to the valid range
+     */
+    qint64 timestampMs(int index) const;
+
+    /**
+     * Find the frame displayed at a given time (last frame with timeMs <= ms)
+     * @return Frame index, 0 for times before the first frame, -1 if the index is empty
+     */
+    int frameAtTime(qint64 ms) const;
+
+    /**
+     * Find the frame with an exact presentation timestamp
+     * @return Frame index, or -1 if no frame has this pts
+     */
+    int frameForPts(qint64 pts) const;
+
+    /**
+     * Find the closest keyframe at or before a frame, i.e. where decoding must start
+     * @return Keyframe index, or 0 if the stream has no keyframe before the frame
+     */
+    int keyframeAtOrBefore(int index) const;
+
+    /**
+     * Average frame rate derived from the indexed timestamps
+     */
+    double averageFrameRate() const;
+
+    /**
+     * Uniformly sample the frames shown between two times
+     * @param startMs Range start; negative means the first frame
+     * @param endMs Range end; negative means the last frame
+     * @param frameStep Take every Nth frame when > 0
+     * @param msStep Otherwise take the frame shown every msStep ms (duplicates dropped)
+     * @return Ascending frame indices
+     */
+    QVector<int> sampleFrames(qint64 startMs, qint64 endMs, int frameStep, qint64 msStep) const;
+
+private:
+    QVector<Entry> m_entries;
+    QVector<int> m_keyframes; // Indices into m_entries, ascending
+    int m_streamIndex = -1;
+    int m_timeBaseNum = 1;
+    int m_timeBaseDen = 1000;
+    int m_width = 0;
+    int m_height = 0;
+};
+
+#endif // FRAMEINDEX_H
@@ -0,0 +1,188 @@
+#include "FrameListModel.h"
+#include "Logger.h"
+#include <QImageReader>
+
+// Decoded thumbnails kept by default; about 1500 at the default size
+static constexpr qint64 kDefaultCacheBytes = 32LL * 1024 * 1024;
+// Requests beyond this are for rows scrolled past long ago; the oldest are dropped
+static constexpr int kMaxPendingRequests = 64;
+
+FrameListModel::FrameListModel(QObject *parent)
+    : QAbstractListModel(parent), m_thumbnailSize(96, 54)
+{
+    m_thumbnails.setMaxCost(static_cast<int>(kDefaultCacheBytes / 1024));
+    m_pool.setMaxThreadCount(2);
+
+    m_placeholder = QPixmap(m_thumbnailSize);
+    m_placeholder.fill(Qt::transparent);
+}
+
+FrameListModel::~FrameListModel()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+int FrameListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_entries.size());
+}
+
+QVariant FrameListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.size())
+        return QVariant();
+
+    const Entry &entry = m_entries[index.row()];
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        return entry.label;
+    case Qt::ToolTipRole:
+    case PathRole:
+        return entry.path;
+    case TimestampRole:
+        return entry.timestamp;
+    case Qt::DecorationRole:
+        if (const QPixmap *thumbnail = m_thumbnails.object(entry.path))
+        {
+            if (!thumbnail->isNull())
+                return *thumbnail;
+        }
+        else
+        {
+            // Views only ask for the decoration of rows they are about to paint
+            const_cast<FrameListModel *>(this)->requestThumbnail(index.row());
+        }
+        return m_placeholder;
+    default:
+        return QVariant();
+    }
+}
+
+bool FrameListModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || row < 0 || count <= 0 || row + count > m_entries.size())
+        return false;
+
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    m_entries.remove(row, count);
+    endRemoveRows();
+    return true;
+}
+
+void FrameListModel::append(const QString &path, qint64 timestamp, const QString &label)
+{
+    int row = static_cast<int>(m_entries.size());
+    beginInsertRows(QModelIndex(), row, row);
+    m_entries.append({path, timestamp, label});
+    endInsertRows();
+}
+
+void FrameListModel::clear()
+{
+    // One reset instead of a removal per row; cached thumbnails stay until evicted
+    beginResetModel();
+    m_entries.clear();
+    m_pending.clear();
+    endResetModel();
+}
+
+QVector<qint64> FrameListModel::timestamps() const
+{
+    QVector<qint64> timestamps;
+    timestamps.reserve(m_entries.size());
+    for (const Entry &entry : m_entries)
+    {
+        timestamps.append(entry.timestamp);
+    }
+    return timestamps;
+}
+
+void FrameListModel::setThumbnailCacheLimit(qint64 bytes)
+{
+    m_thumbnails.setMaxCost(static_cast<int>(qMax<qint64>(1, bytes / 1024)));
+}
+
+void FrameListModel::requestThumbnail(int row)
+{
+    const QString &path = m_entries[row].path;
+    if (m_inFlight.contains(path))
+        return;
+
+    // A repeated request jumps the queue; the row was just scrolled back into view
+    for (qsizetype i = 0; i < m_pending.size(); ++i)
+    {
+        if (m_pending[i].path == path)
+        {
+            m_pending.remove(i);
+            break;
+        }
+    }
+    m_pending.append({path, row});
+    if (m_pending.size() > kMaxPendingRequests)
+    {
+        m_pending.removeFirst();
+    }
+    startLoads();
+}
+
+void FrameListModel::startLoads()
+{
+    while (!m_pending.isEmpty() && m_inFlight.size() < m_pool.maxThreadCount())
+    {
+        Request request = m_pending.takeLast();
+        m_inFlight.insert(request.path);
+
+        QSize size = m_thumbnailSize;
+        m_pool.start([this, request, size]()
+                     {
+            // Let the image plugin scale while decoding where it can (JPEG can skip most of the IDCT work)
+            QImageReader reader(request.path);
+            reader.setAutoTransform(true);
+            QSize original = reader.size();
+            if (original.isValid())
+            {
+                reader.setScaledSize(original.scaled(size, Qt::KeepAspectRatio));
+            }
+            QImage image = reader.read();
+
+            QMetaObject::invokeMethod(this, [this, request, image]()
+                                      { onThumbnailLoaded(request, image); }, Qt::QueuedConnection); });
+    }
+}
+
+void FrameListModel::onThumbnailLoaded(const Request &request, const QImage &image)
+{
+    m_inFlight.remove(request.path);
+    if (image.isNull())
+    {
+        LOG_DEBUG("Frame list: no thumbnail for {}", request.path.toStdString());
+    }
+
+    auto *thumbnail = new QPixmap(QPixmap::fromImage(image));
+    int cost = qMax(1, static_cast<int>(image.sizeInBytes() / 1024));
+    m_thumbnails.insert(request.path, thumbnail, cost);
+
+    // Rows only move on removal, so the requested row is almost always still right
+    int row = request.row;
+    if (row >= m_entries.size() || m_entries[row].path != request.path)
+    {
+        row = -1;
+        for (int i = 0; i < m_entries.size(); ++i)
+        {
+            if (m_entries[i].path == request.path)
+            {
+                row = i;
+                break;
+            }
+        }
+    }
+    if (row >= 0)
+    {
+        QModelIndex changed = index(row);
+        emit dataChanged(changed, changed, {Qt::DecorationRole});
+    }
+
+    startLoads();
+}
@@ -0,0 +1,85 @@
+#ifndef FRAMELISTMODEL_H
+#define FRAMELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QCache>
+#include <QImage>
+#include <QPixmap>
+#include <QSet>
+#include <QSize>
+#include <QThreadPool>
+#include <QVector>
+
+/**
+ * Frames saved this session, with thumbnails loaded on demand.
+ *
+ * Thumbnails are only requested when a view asks for a row's decoration,
+ * which a QListView with uniform item sizes only does for visible rows.
+ * They are decoded and scaled on a small worker pool, most recent request
+ * first, and kept in an LRU cache bounded by size, so memory stays flat
+ * however many frames are listed. Until its thumbnail arrives a row shows
+ * a blank placeholder of the same size.
+ */
+class FrameListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Role
+    {
+        PathRole = Qt::UserRole,
+        TimestampRole
+    };
+
+    explicit FrameListModel(QObject *parent = nullptr);
+    ~FrameListModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    /**
+     * Add a saved frame to the end of the list
+     * @param label Text shown next to the thumbnail
+     */
+    void append(const QString &path, qint64 timestamp, const QString &label);
+    void clear();
+
+    QVector<qint64> timestamps() const;
+
+    QSize thumbnailSize() const { return m_thumbnailSize; }
+
+    /**
+     * Memory budget for decoded thumbnails; the least recently used are dropped first
+     */
+    void setThumbnailCacheLimit(qint64 bytes);
+
+private:
+    struct Entry
+    {
+        QString path;
+        qint64 timestamp;
+        QString label;
+    };
+
+    struct Request
+    {
+        QString path;
+        int row; // Where the path was when requested; rows may have moved since
+    };
+
+    void requestThumbnail(int row);
+    void startLoads();
+    void onThumbnailLoaded(const Request &request, const QImage &image);
+
+    QVector<Entry> m_entries;
+    QSize m_thumbnailSize;
+    QPixmap m_placeholder;
+
+    QCache<QString, QPixmap> m_thumbnails; // Cost in KB; a null pixmap marks an unreadable file
+    QVector<Request> m_pending;            // Newest last
+    QSet<QString> m_inFlight;
+    QThreadPool m_pool;
+};
+
+#endif // FRAMELISTMODEL_H
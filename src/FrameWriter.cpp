@@ -0,0 +1,187 @@
+#include "FrameWriter.h"
+#include "Logger.h"
+#include "ColorConversion.h"
+#include "FrameHashIndex.h"
+#include "PerceptualHash.h"
+#include "PerfStats.h"
+#include "Tracer.h"
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QThread>
+
+FrameWriter::FrameWriter(int maxInFlight, QObject *parent)
+    : QObject(parent), m_maxInFlight(qMax(1, maxInFlight)), m_inFlight(0)
+{
+    // Leave one core for the GUI and the player's decoder
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+    LOG_INFO("Frame writer: {} encoder threads, up to {} frames in flight", m_pool.maxThreadCount(), m_maxInFlight);
+}
+
+FrameWriter::~FrameWriter()
+{
+    waitForDone();
+}
+
+bool FrameWriter::enqueue(const Job &job)
+{
+    // Reserve a slot first so concurrent callers can't overshoot the cap
+    int count = m_inFlight.fetch_add(1) + 1;
+    if (count > m_maxInFlight)
+    {
+        m_inFlight.fetch_sub(1);
+        LOG_WARN("Frame writer: queue full ({} in flight), rejecting {}", m_maxInFlight, job.path.toStdString());
+        return false;
+    }
+    emit inFlightChanged(count);
+
+    m_pool.start([this, job]()
+                 {
+        bool skipped = false;
+        bool success = writeJob(job, &skipped);
+        if (!skipped)
+            emit frameWritten(job.path, job.timestamp, success);
+        emit inFlightChanged(m_inFlight.fetch_sub(1) - 1); });
+    return true;
+}
+
+void FrameWriter::waitForDone()
+{
+    m_pool.waitForDone();
+}
+
+bool FrameWriter::writeJob(const Job &job, bool *skipped)
+{
+    TRACE_SCOPE("writeJob", "write");
+    QElapsedTimer timer;
+    timer.start();
+
+    QImage image = job.image;
+    if (image.isNull() && job.frame.isValid())
+    {
+        image = imageFromVideoFrame(job.frame);
+    }
+    if (image.isNull())
+    {
+        LOG_ERROR("Frame writer: no image data for {}", job.path.toStdString());
+        return false;
+    }
+
+    // The hash is cheap next to encoding; frames go into the index even when duplicates are kept
+    QFileInfo target(job.path);
+    bool indexed = job.hashIndex && target.absolutePath() == job.hashIndex->directory();
+    uint64_t hash = 0;
+    bool reserved = false;
+    if (indexed)
+    {
+        hash = PerceptualHash::dHash(image);
+        if (job.duplicates != DuplicatePolicy::Keep)
+        {
+            // Look up and claim in one step, so two quick saves of the same frame can't both miss
+            qint64 lookupStart = timer.nsecsElapsed();
+            FrameHashIndex::Match match = job.hashIndex->findOrReserve(hash, job.duplicateThreshold, target.fileName());
+            reserved = !match.isValid();
+            LOG_DEBUG("Frame writer: duplicate lookup in {} frames took {}us", job.hashIndex->size(),
+                      (timer.nsecsElapsed() - lookupStart) / 1000);
+            if (match.isValid())
+            {
+                bool skip = job.duplicates == DuplicatePolicy::Skip;
+                LOG_INFO("Frame writer: {} is {} bits from {}{}", target.fileName().toStdString(), match.distance,
+                         match.fileName.toStdString(), skip ? " - skipped" : "");
+                emit duplicateFound(job.path, job.timestamp, match.fileName, match.distance, skip);
+                if (skip)
+                {
+                    *skipped = true;
+                    return false;
+                }
+            }
+        }
+    }
+
+    qint64 encodeStart = timer.nsecsElapsed();
+    bool saved = ImageEncoder::encode(image, job.path, job.encoder);
+    if (saved && PerfStats::isEnabled())
+    {
+        // Only stat the file while someone is watching the throughput
+        PerfStats::frameEncoded((timer.nsecsElapsed() - encodeStart) / 1000, QFileInfo(job.path).size());
+    }
+    if (reserved)
+    {
+        if (saved)
+            job.hashIndex->commitReservation(target.fileName(), hash);
+        else
+            job.hashIndex->cancelReservation(target.fileName());
+    }
+    else if (saved && indexed)
+    {
+        job.hashIndex->add(target.fileName(), hash);
+    }
+    if (saved && job.manifest && target.absolutePath() == job.manifest->directory())
+    {
+        job.manifest->append(CaptureManifest::recordFor(image, job.path, job.timestamp, job.frameNumber, job.pts));
+    }
+    LOG_DEBUG("Frame writer: {} {}x{} {} in {}ms", saved ? "wrote" : "failed to write",
+              image.width(), image.height(), ImageEncoder::formatName(job.encoder.format).toStdString(), timer.elapsed());
+    return saved;
+}
+
+QImage FrameWriter::imageFromVideoFrame(const QVideoFrame &frame)
+{
+    TRACE_SCOPE("imageFromVideoFrame", "convert");
+    ColorConversion::Source source{};
+    switch (frame.pixelFormat())
+    {
+    case QVideoFrameFormat::Format_NV12:
+        source.layout = ColorConversion::Layout::NV12;
+        break;
+    case QVideoFrameFormat::Format_YUV420P:
+        source.layout = ColorConversion::Layout::YUV420P;
+        break;
+    case QVideoFrameFormat::Format_P010:
+        source.layout = ColorConversion::Layout::P010;
+        break;
+    case QVideoFrameFormat::Format_YUYV:
+        source.layout = ColorConversion::Layout::YUYV;
+        break;
+    default:
+        return frame.toImage().convertToFormat(QImage::Format_RGB32);
+    }
+
+    QVideoFrame mappedFrame = frame;
+    if (!mappedFrame.map(QVideoFrame::ReadOnly))
+    {
+        return frame.toImage().convertToFormat(QImage::Format_RGB32);
+    }
+
+    QVideoFrameFormat format = mappedFrame.surfaceFormat();
+    source.width = mappedFrame.width();
+    source.height = mappedFrame.height();
+    for (int plane = 0; plane < qMin(3, mappedFrame.planeCount()); ++plane)
+    {
+        source.planes[plane] = mappedFrame.bits(plane);
+        source.strides[plane] = mappedFrame.bytesPerLine(plane);
+    }
+
+    switch (format.colorSpace())
+    {
+    case QVideoFrameFormat::ColorSpace_BT601:
+        source.matrix = ColorConversion::Matrix::BT601;
+        break;
+    case QVideoFrameFormat::ColorSpace_BT709:
+        source.matrix = ColorConversion::Matrix::BT709;
+        break;
+    case QVideoFrameFormat::ColorSpace_BT2020:
+        source.matrix = ColorConversion::Matrix::BT2020;
+        break;
+    default:
+        source.matrix = ColorConversion::defaultMatrix(source.width, source.height);
+        break;
+    }
+    source.range = format.colorRange() == QVideoFrameFormat::ColorRange_Full ? ColorConversion::Range::Full
+                                                                               : ColorConversion::Range::Limited;
+
+    QImage image(source.width, source.height, QImage::Format_RGB32);
+    bool converted = ColorConversion::convert(source, image.bits(), static_cast<int>(image.bytesPerLine()));
+    mappedFrame.unmap();
+
+    return converted ? image : frame.toImage().convertToFormat(QImage::Format_RGB32);
+}
@@ -0,0 +1,100 @@
+#ifndef FRAMEWRITER_H
+#define FRAMEWRITER_H
+
+#include <QObject>
+#include <QImage>
+#include <QString>
+#include <QThreadPool>
+#include <QVideoFrame>
+#include <atomic>
+#include <memory>
+#include "CaptureManifest.h"
+#include "ImageEncoder.h"
+
+class FrameHashIndex;
+
+/**
+ * Bounded pool of background encoders for saving captured frames.
+ *
+ * Jobs carry either a ref-counted QVideoFrame (converted on the worker) or an
+ * already decoded QImage. The number of jobs in flight is capped; once the cap
+ * is reached enqueue() refuses new jobs instead of blocking the caller, so the
+ * GUI thread never waits on encoding.
+ */
+class FrameWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class DuplicatePolicy
+    {
+        Keep, // Save every frame (still hashed and indexed)
+        Warn, // Save, but report the near-duplicate
+        Skip  // Don't save frames within the threshold of an indexed one
+    };
+
+    struct Job
+    {
+        QVideoFrame frame; // Used when image is null
+        QImage image;
+        QString path;
+        qint64 timestamp; // Video position in ms, reported back on completion
+        ImageEncoder::Settings encoder;
+        FrameHashIndex *hashIndex = nullptr; // Index of the output directory; must outlive the job
+        DuplicatePolicy duplicates = DuplicatePolicy::Keep;
+        int duplicateThreshold = 6; // Max dHash distance in bits that counts as a duplicate
+        std::shared_ptr<CaptureManifest> manifest; // Video the frame came from; the write is recorded there
+        int frameNumber = -1;                      // Frame index in the video, -1 if unknown
+        qint64 pts = -1;                           // Presentation timestamp in the stream's time base, -1 if unknown
+    };
+
+    explicit FrameWriter(int maxInFlight = 8, QObject *parent = nullptr);
+    ~FrameWriter() override;
+
+    /**
+     * Queue a frame for encoding; safe to call from any thread
+     * @return false if the queue is full and the job was rejected
+     */
+    bool enqueue(const Job &job);
+
+    int inFlight() const { return m_inFlight.load(std::memory_order_relaxed); }
+    int maxInFlight() const { return m_maxInFlight; }
+
+    /**
+     * Block until every queued job has been written
+     */
+    void waitForDone();
+
+    /**
+     * Convert a video frame to QImage::Format_RGB32 in a single pass
+     * Uses the SIMD YUV kernels for NV12, YUV420P, P010 and YUYV frames and
+     * falls back to QVideoFrame::toImage() for anything else.
+     */
+    static QImage imageFromVideoFrame(const QVideoFrame &frame);
+
+signals:
+    /**
+     * Emitted from a worker thread when a job finishes
+     */
+    void frameWritten(const QString &path, qint64 timestamp, bool success);
+
+    /**
+     * Emitted from a worker thread, before frameWritten, when a frame is within the
+     * duplicate threshold of an indexed one; a skipped frame gets no frameWritten
+     */
+    void duplicateFound(const QString &path, qint64 timestamp, const QString &existingFile, int distance, bool skipped);
+
+    /**
+     * Emitted whenever the number of jobs in flight changes
+     */
+    void inFlightChanged(int count);
+
+private:
+    bool writeJob(const Job &job, bool *skipped);
+
+    QThreadPool m_pool;
+    int m_maxInFlight;
+    std::atomic_int m_inFlight;
+};
+
+#endif // FRAMEWRITER_H
@@ -0,0 +1,379 @@
+#include "HeadlessExtractor.h"
+#include "Logger.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    void printLine(const QString &line)
+    {
+        std::fprintf(stdout, "%s\n", qPrintable(line));
+        std::fflush(stdout);
+    }
+
+    void printError(const QString &line)
+    {
+        std::fprintf(stderr, "%s\n", qPrintable(line));
+    }
+}
+
+HeadlessExtractor::HeadlessExtractor(QObject *parent)
+    : QObject(parent), m_maxDecoders(0), m_threads(0), m_memoryBudget(2048LL * 1024 * 1024), m_queue(nullptr), m_finishedJobs(0), m_lastFramesDone(0)
+{
+    m_progressTimer.setInterval(1000);
+    connect(&m_progressTimer, &QTimer::timeout, this, &HeadlessExtractor::printProgress);
+}
+
+HeadlessExtractor::~HeadlessExtractor()
+{
+    if (m_queue)
+    {
+        m_queue->cancel();
+        m_queue->waitForDone();
+    }
+}
+
+bool HeadlessExtractor::isRequested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--extract") == 0)
+            return true;
+    }
+    return false;
+}
+
+bool HeadlessExtractor::parseArguments(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Extract frames from videos without the GUI.\n"
+                                     "Choose exactly one frame source: --timestamps, --from-dir, --every-frames or --every-ms.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("videos", "Video files to extract from.", "<video>...");
+
+    QCommandLineOption extractOption("extract", "Run headless extraction.");
+    QCommandLineOption timestampsOption("timestamps", "Text file with one video position in ms per line ('-' for stdin).", "file");
+    QCommandLineOption fromDirOption("from-dir", "Re-extract the positions of frames already saved in a directory.", "dir");
+    QCommandLineOption everyFramesOption("every-frames", "Extract every Nth frame.", "N");
+    QCommandLineOption everyMsOption("every-ms", "Extract a frame every X ms.", "X");
+    QCommandLineOption inOption("in", "Start of the sampled range in ms.", "ms");
+    QCommandLineOption outOption("out", "End of the sampled range in ms.", "ms");
+    QCommandLineOption outputOption({"o", "output"}, "Output directory (default: current directory).", "dir", ".");
+    QCommandLineOption prefixOption("prefix", "File name prefix (default: derived from each video's name).", "prefix");
+    QCommandLineOption formatOption("format", "png, jpeg, webp, qoi, bmp or tiff (default: png).", "format", "png");
+    QCommandLineOption pngLevelOption("png-level", "PNG zlib level 0-9 (default: 1).", "level");
+    QCommandLineOption pngFilterOption("png-filter", "PNG filter: none, sub, up, paeth or adaptive (default: up).", "filter");
+    QCommandLineOption jpegQualityOption("jpeg-quality", "JPEG quality 1-100 (default: 92).", "quality");
+    QCommandLineOption jpegSubsamplingOption("jpeg-subsampling", "JPEG chroma subsampling: 444, 422 or 420 (default: 420).", "mode");
+    QCommandLineOption jobsOption({"j", "jobs"}, "Most videos decoded at once (default: as many as the memory budget allows).", "count");
+    QCommandLineOption threadsOption("threads", "Worker threads shared by decoding and encoding (default: one per core).", "count");
+    QCommandLineOption memoryOption("memory-budget", "Memory for open decoders in MB (default: 2048).", "MB");
+    QCommandLineOption verboseOption("verbose", "Log at debug level.");
+
+    parser.addOptions({extractOption, timestampsOption, fromDirOption, everyFramesOption, everyMsOption, inOption, outOption,
+                       outputOption, prefixOption, formatOption, pngLevelOption, pngFilterOption, jpegQualityOption,
+                       jpegSubsamplingOption, jobsOption, threadsOption, memoryOption, verboseOption});
+
+    if (!parser.parse(arguments))
+    {
+        printError(parser.errorText());
+        return false;
+    }
+    if (parser.isSet("help"))
+    {
+        printLine(parser.helpText());
+        return false;
+    }
+
+    Logger::setLevel(parser.isSet(verboseOption) ? spdlog::level::debug : spdlog::level::warn);
+
+    m_videos = parser.positionalArguments();
+    if (m_videos.isEmpty())
+    {
+        printError("No video files given.\n\n" + parser.helpText());
+        return false;
+    }
+    for (const QString &video : m_videos)
+    {
+        if (!QFileInfo::exists(video))
+        {
+            printError(QString("Video not found: %1").arg(video));
+            return false;
+        }
+    }
+
+    // Exactly one frame source
+    int sources = parser.isSet(timestampsOption) + parser.isSet(fromDirOption) +
+                  (parser.isSet(everyFramesOption) || parser.isSet(everyMsOption));
+    if (sources != 1 || (parser.isSet(everyFramesOption) && parser.isSet(everyMsOption)))
+    {
+        printError("Choose exactly one of --timestamps, --from-dir, --every-frames or --every-ms.");
+        return false;
+    }
+
+    if (parser.isSet(timestampsOption))
+    {
+        QString path = parser.value(timestampsOption);
+        QFile file;
+        bool opened = false;
+        if (path == "-")
+        {
+            opened = file.open(stdin, QIODevice::ReadOnly | QIODevice::Text);
+        }
+        else
+        {
+            file.setFileName(path);
+            opened = file.open(QIODevice::ReadOnly | QIODevice::Text);
+        }
+        if (!opened)
+        {
+            printError(QString("Cannot read timestamps from %1").arg(path));
+            return false;
+        }
+        QTextStream stream(&file);
+        int lineNumber = 0;
+        while (!stream.atEnd())
+        {
+            QString line = stream.readLine().trimmed();
+            ++lineNumber;
+            if (line.isEmpty() || line.startsWith('#'))
+                continue;
+            bool ok;
+            qint64 timestamp = line.toLongLong(&ok);
+            if (!ok || timestamp < 0)
+            {
+                printError(QString("%1:%2: not a position in ms: %3").arg(path).arg(lineNumber).arg(line));
+                return false;
+            }
+            m_spec.timestamps.append(timestamp);
+        }
+    }
+    else if (parser.isSet(fromDirOption))
+    {
+        m_spec.timestampsFromDirectory = parser.value(fromDirOption);
+        if (!QDir(m_spec.timestampsFromDirectory).exists())
+        {
+            printError(QString("Directory not found: %1").arg(m_spec.timestampsFromDirectory));
+            return false;
+        }
+    }
+    else
+    {
+        bool ok = true;
+        if (parser.isSet(everyFramesOption))
+            m_spec.everyFrames = parser.value(everyFramesOption).toInt(&ok);
+        else
+            m_spec.everyMs = parser.value(everyMsOption).toLongLong(&ok);
+        if (!ok || (m_spec.everyFrames <= 0 && m_spec.everyMs <= 0))
+        {
+            printError("--every-frames and --every-ms need a positive number.");
+            return false;
+        }
+        m_spec.inPoint = parser.isSet(inOption) ? parser.value(inOption).toLongLong() : -1;
+        m_spec.outPoint = parser.isSet(outOption) ? parser.value(outOption).toLongLong() : -1;
+    }
+
+    m_spec.outputDirectory = parser.value(outputOption);
+    if (!QDir().mkpath(m_spec.outputDirectory))
+    {
+        printError(QString("Cannot create output directory %1").arg(m_spec.outputDirectory));
+        return false;
+    }
+    m_spec.prefix = parser.value(prefixOption);
+
+    // Encoder settings
+    QString formatName = parser.value(formatOption);
+    if (formatName.compare("jpg", Qt::CaseInsensitive) == 0)
+        formatName = "JPEG";
+    m_spec.encoder.format = ImageEncoder::formatFromName(formatName);
+    if (ImageEncoder::formatName(m_spec.encoder.format).compare(formatName, Qt::CaseInsensitive) != 0 ||
+        !ImageEncoder::availableFormats().contains(m_spec.encoder.format))
+    {
+        printError(QString("Unsupported image format: %1").arg(parser.value(formatOption)));
+        return false;
+    }
+    if (parser.isSet(pngLevelOption))
+        m_spec.encoder.pngCompressionLevel = qBound(0, parser.value(pngLevelOption).toInt(), 9);
+    if (parser.isSet(pngFilterOption))
+    {
+        bool found = false;
+        for (PngEncoder::Filter filter : {PngEncoder::Filter::None, PngEncoder::Filter::Sub, PngEncoder::Filter::Up,
+                                          PngEncoder::Filter::Paeth, PngEncoder::Filter::Adaptive})
+        {
+            if (ImageEncoder::pngFilterName(filter).compare(parser.value(pngFilterOption), Qt::CaseInsensitive) == 0)
+            {
+                m_spec.encoder.pngFilter = filter;
+                found = true;
+            }
+        }
+        if (!found)
+        {
+            printError(QString("Unknown PNG filter: %1").arg(parser.value(pngFilterOption)));
+            return false;
+        }
+    }
+    if (parser.isSet(jpegQualityOption))
+        m_spec.encoder.jpegQuality = qBound(1, parser.value(jpegQualityOption).toInt(), 100);
+    if (parser.isSet(jpegSubsamplingOption))
+    {
+        bool found = false;
+        QString mode = parser.value(jpegSubsamplingOption).remove(':');
+        for (JpegEncoder::Subsampling subsampling : {JpegEncoder::Subsampling::S444, JpegEncoder::Subsampling::S422,
+                                                     JpegEncoder::Subsampling::S420})
+        {
+            if (ImageEncoder::subsamplingName(subsampling).remove(':') == mode)
+            {
+                m_spec.encoder.jpegSubsampling = subsampling;
+                found = true;
+            }
+        }
+        if (!found)
+        {
+            printError(QString("Unknown JPEG subsampling: %1").arg(parser.value(jpegSubsamplingOption)));
+            return false;
+        }
+    }
+
+    // Decoders and encoders share one pool; the memory budget decides how many videos decode at once
+    m_maxDecoders = parser.isSet(jobsOption) ? qMax(1, parser.value(jobsOption).toInt()) : 0;
+    m_threads = parser.isSet(threadsOption) ? qMax(1, parser.value(threadsOption).toInt()) : 0;
+    if (parser.isSet(memoryOption))
+    {
+        bool ok;
+        qint64 megabytes = parser.value(memoryOption).toLongLong(&ok);
+        if (!ok || megabytes <= 0)
+        {
+            printError("--memory-budget needs a positive number of MB.");
+            return false;
+        }
+        m_memoryBudget = megabytes * 1024 * 1024;
+    }
+
+    return true;
+}
+
+void HeadlessExtractor::start()
+{
+    m_clock.start();
+    m_queue = new ExtractionQueue(m_threads, this);
+    m_queue->setMemoryBudget(m_memoryBudget);
+    m_queue->setMaxDecoders(m_maxDecoders);
+
+    // The queue signals from its worker threads; these connections are queued onto the event loop
+    connect(m_queue, &ExtractionQueue::jobStarted, this, [this](int id, const QString &, int totalFrames)
+            { onJobStarted(id, totalFrames); });
+    connect(m_queue, &ExtractionQueue::jobProgress, this, [this](int id, int done, int)
+            {
+        VideoJob &video = m_jobs[m_jobForId.value(id)];
+        video.done = qMax(video.done, done); });
+    connect(m_queue, &ExtractionQueue::jobFinished, this, [this](int id, const QString &, int written, int failed)
+            { onJobFinished(id, written, failed); });
+
+    printLine(QString("Extracting from %1 video(s) on %2 thread(s), decoder memory budget %3MB, format %4")
+                  .arg(m_videos.size())
+                  .arg(m_queue->threadCount())
+                  .arg(m_memoryBudget / (1024 * 1024))
+                  .arg(ImageEncoder::formatName(m_spec.encoder.format)));
+
+    m_jobs.resize(m_videos.size());
+    for (int i = 0; i < m_videos.size(); ++i)
+    {
+        m_jobs[i].path = m_videos[i];
+        ExtractionJob job = m_spec;
+        job.videoPath = m_videos[i];
+        m_jobForId.insert(m_queue->addJob(job), i);
+    }
+    m_progressTimer.start();
+}
+
+void HeadlessExtractor::onJobStarted(int id, int totalFrames)
+{
+    VideoJob &video = m_jobs[m_jobForId.value(id)];
+    video.started = true;
+    video.total = totalFrames;
+    video.startedMs = m_clock.elapsed();
+    printLine(QString("%1: %2 frame(s)").arg(video.path).arg(totalFrames));
+}
+
+void HeadlessExtractor::onJobFinished(int id, int written, int failed)
+{
+    VideoJob &video = m_jobs[m_jobForId.value(id)];
+    video.finished = true;
+    video.written = written;
+    video.failed = failed;
+    video.done = written + failed;
+    ++m_finishedJobs;
+
+    if (!video.started)
+    {
+        // Never reached a decoder: unreadable, or nothing matched the frame source
+        if (failed > 0)
+            printError(QString("%1: cannot read video").arg(video.path));
+        else
+            printLine(QString("%1: no frames to extract").arg(video.path));
+    }
+    else
+    {
+        double seconds = (m_clock.elapsed() - video.startedMs) / 1000.0;
+        printLine(QString("%1: wrote %2 of %3 frame(s) in %4s (%5 frames/s)%6")
+                      .arg(video.path)
+                      .arg(written)
+                      .arg(video.total)
+                      .arg(seconds, 0, 'f', 2)
+                      .arg(seconds > 0 ? written / seconds : 0.0, 0, 'f', 1)
+                      .arg(failed > 0 ? QString(", %1 failed").arg(failed) : QString()));
+    }
+
+    if (m_finishedJobs == m_jobs.size())
+    {
+        m_progressTimer.stop();
+        printSummary();
+    }
+}
+
+void HeadlessExtractor::printProgress()
+{
+    ExtractionQueue::Stats stats = m_queue->stats();
+    int done = stats.framesWritten + stats.framesFailed;
+    double interval = m_progressTimer.interval() / 1000.0;
+    double rate = (done - m_lastFramesDone) / interval;
+    m_lastFramesDone = done;
+
+    printLine(QString("[%1s] videos %2/%3, frames %4/%5, %6 frames/s, %7 decoder(s) using ~%8MB, %9 steals")
+                  .arg(m_clock.elapsed() / 1000.0, 0, 'f', 1)
+                  .arg(stats.jobsFinished)
+                  .arg(m_jobs.size())
+                  .arg(done)
+                  .arg(stats.framesTotal)
+                  .arg(rate, 0, 'f', 1)
+                  .arg(stats.decoders)
+                  .arg(stats.memoryInUse / (1024 * 1024))
+                  .arg(stats.steals));
+}
+
+void HeadlessExtractor::printSummary()
+{
+    int written = 0;
+    int failed = 0;
+    for (const VideoJob &video : m_jobs)
+    {
+        written += video.written;
+        failed += video.failed;
+    }
+
+    double seconds = m_clock.elapsed() / 1000.0;
+    printLine(QString("Done: %1 frame(s) from %2 video(s) in %3s, %4 frames/s overall%5")
+                  .arg(written)
+                  .arg(m_jobs.size())
+                  .arg(seconds, 0, 'f', 2)
+                  .arg(seconds > 0 ? written / seconds : 0.0, 0, 'f', 1)
+                  .arg(failed > 0 ? QString(", %1 failed").arg(failed) : QString()));
+
+    QCoreApplication::exit(failed > 0 ? 1 : 0);
+}
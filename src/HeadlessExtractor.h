@@ -0,0 +1,78 @@
+#ifndef HEADLESSEXTRACTOR_H
+#define HEADLESSEXTRACTOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include "ExtractionQueue.h"
+
+/**
+ * Command-line extraction without any widgets (ImageAnnotationPicker --extract).
+ *
+ * Runs under QCoreApplication on batch servers. Every video on the command line
+ * becomes a job on one ExtractionQueue, which decodes several videos at once
+ * within a memory budget and encodes on all remaining cores. Progress and
+ * throughput go to stdout; the process exits when every video is done.
+ */
+class HeadlessExtractor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HeadlessExtractor(QObject *parent = nullptr);
+    ~HeadlessExtractor() override;
+
+    /**
+     * Whether the command line asks for headless mode; checked before any QApplication exists
+     */
+    static bool isRequested(int argc, char *argv[]);
+
+    /**
+     * Parse the command line, printing usage or an error on failure
+     * @return false if the arguments are invalid and the process should exit
+     */
+    bool parseArguments(const QStringList &arguments);
+
+public slots:
+    /**
+     * Start extracting; calls QCoreApplication::exit() with 0 on success, 1 if any frame failed
+     */
+    void start();
+
+private:
+    struct VideoJob
+    {
+        QString path;
+        int total = 0;
+        int done = 0;
+        int written = 0;
+        int failed = 0;
+        qint64 startedMs = 0;
+        bool started = false;
+        bool finished = false;
+    };
+
+    void onJobStarted(int id, int totalFrames);
+    void onJobFinished(int id, int written, int failed);
+    void printProgress();
+    void printSummary();
+
+    QStringList m_videos;
+    ExtractionJob m_spec; // Shared by every video; videoPath is filled in per job
+    int m_maxDecoders;
+    int m_threads;
+    qint64 m_memoryBudget;
+
+    ExtractionQueue *m_queue;
+    QHash<int, int> m_jobForId; // Queue job id -> index in m_jobs
+    QVector<VideoJob> m_jobs;
+    int m_finishedJobs;
+    int m_lastFramesDone;
+    QElapsedTimer m_clock;
+    QTimer m_progressTimer;
+};
+
+#endif // HEADLESSEXTRACTOR_H
@@ -0,0 +1,186 @@
+#include "ImageEncoder.h"
+#include "Logger.h"
+#include "QoiEncoder.h"
+#include "Tracer.h"
+#include <QImageWriter>
+#include <QSaveFile>
+#include <vector>
+
+namespace
+{
+    bool writeFile(const QString &path, const std::vector<uint8_t> &data)
+    {
+        TRACE_SCOPE("writeFile", "write");
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly))
+        {
+            LOG_ERROR("Image encoder: cannot open {}: {}", path.toStdString(), file.errorString().toStdString());
+            return false;
+        }
+        if (file.write(reinterpret_cast<const char *>(data.data()), static_cast<qint64>(data.size())) != static_cast<qint64>(data.size()))
+        {
+            LOG_ERROR("Image encoder: short write to {}", path.toStdString());
+            file.cancelWriting();
+            return false;
+        }
+        return file.commit();
+    }
+
+    bool writeWithQt(const QImage &image, const QString &path, const QByteArray &format, int quality)
+    {
+        QImageWriter writer(path, format);
+        if (quality >= 0)
+        {
+            writer.setQuality(quality);
+        }
+        if (!writer.write(image))
+        {
+            LOG_ERROR("Image encoder: Qt {} writer failed for {}: {}", format.toStdString(),
+                      path.toStdString(), writer.errorString().toStdString());
+            return false;
+        }
+        return true;
+    }
+}
+
+bool ImageEncoder::encode(const QImage &source, const QString &path, const Settings &settings)
+{
+    TRACE_SCOPE("encode", "encode");
+    QImage image = source;
+    if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32)
+    {
+        image = image.convertToFormat(QImage::Format_RGB32);
+    }
+
+    const uint8_t *pixels = image.constBits();
+    int stride = static_cast<int>(image.bytesPerLine());
+    std::vector<uint8_t> data;
+
+    switch (settings.format)
+    {
+    case Format::PNG:
+        return PngEncoder::encode(pixels, image.width(), image.height(), stride,
+                                  settings.pngCompressionLevel, settings.pngFilter, data) &&
+               writeFile(path, data);
+    case Format::QOI:
+        return QoiEncoder::encode(pixels, image.width(), image.height(), stride, data) &&
+               writeFile(path, data);
+    case Format::JPEG:
+        if (JpegEncoder::isAvailable())
+        {
+            return JpegEncoder::encode(pixels, image.width(), image.height(), stride,
+                                       settings.jpegQuality, settings.jpegSubsampling, data) &&
+                   writeFile(path, data);
+        }
+        // Qt's JPEG plugin has no subsampling control
+        return writeWithQt(image, path, "jpg", settings.jpegQuality);
+    case Format::WebP:
+        // Quality 100 selects lossless mode in Qt's webp plugin
+        return writeWithQt(image, path, "webp", 100);
+    case Format::BMP:
+        return writeWithQt(image, path, "bmp", -1);
+    case Format::TIFF:
+        return writeWithQt(image, path, "tiff", -1);
+    }
+    return false;
+}
+
+QList<ImageEncoder::Format> ImageEncoder::availableFormats()
+{
+    QList<Format> formats{Format::PNG, Format::JPEG, Format::QOI};
+    const QList<QByteArray> supported = QImageWriter::supportedImageFormats();
+    if (supported.contains("webp"))
+    {
+        formats.append(Format::WebP);
+    }
+    formats.append(Format::BMP);
+    if (supported.contains("tiff"))
+    {
+        formats.append(Format::TIFF);
+    }
+    return formats;
+}
+
+QString ImageEncoder::formatName(Format format)
+{
+    switch (format)
+    {
+    case Format::PNG:
+        return "PNG";
+    case Format::JPEG:
+        return "JPEG";
+    case Format::WebP:
+        return "WebP";
+    case Format::QOI:
+        return "QOI";
+    case Format::BMP:
+        return "BMP";
+    case Format::TIFF:
+        return "TIFF";
+    }
+    return "PNG";
+}
+
+QString ImageEncoder::fileExtension(Format format)
+{
+    switch (format)
+    {
+    case Format::PNG:
+        return "png";
+    case Format::JPEG:
+        return "jpg";
+    case Format::WebP:
+        return "webp";
+    case Format::QOI:
+        return "qoi";
+    case Format::BMP:
+        return "bmp";
+    case Format::TIFF:
+        return "tiff";
+    }
+    return "png";
+}
+
+ImageEncoder::Format ImageEncoder::formatFromName(const QString &name, Format fallback)
+{
+    for (Format format : {Format::PNG, Format::JPEG, Format::WebP, Format::QOI, Format::BMP, Format::TIFF})
+    {
+        if (name.compare(formatName(format), Qt::CaseInsensitive) == 0)
+        {
+            return format;
+        }
+    }
+    return fallback;
+}
+
+QString ImageEncoder::pngFilterName(PngEncoder::Filter filter)
+{
+    switch (filter)
+    {
+    case PngEncoder::Filter::None:
+        return "None";
+    case PngEncoder::Filter::Sub:
+        return "Sub";
+    case PngEncoder::Filter::Up:
+        return "Up";
+    case PngEncoder::Filter::Paeth:
+        return "Paeth";
+    case PngEncoder::Filter::Adaptive:
+        return "Adaptive";
+    }
+    return "Up";
+}
+
+QString ImageEncoder::subsamplingName(JpegEncoder::Subsampling subsampling)
+{
+    switch (subsampling)
+    {
+    case JpegEncoder::Subsampling::S444:
+        return "4:4:4";
+    case JpegEncoder::Subsampling::S422:
+        return "4:2:2";
+    case JpegEncoder::Subsampling::S420:
+        return "4:2:0";
+    }
+    return "4:2:0";
+}
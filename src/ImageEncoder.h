@@ -0,0 +1,65 @@
+#ifndef IMAGEENCODER_H
+#define IMAGEENCODER_H
+
+#include <QImage>
+#include <QList>
+#include <QString>
+#include "JpegEncoder.h"
+#include "PngEncoder.h"
+
+/**
+ * Per-format encoder settings and the single save entry point for frames.
+ *
+ * PNG, JPEG and QOI go through our own encoders, which expose the speed/size
+ * knobs QImage::save() hides. WebP (lossless) and BMP/TIFF use Qt's image
+ * plugins. JPEG falls back to QImageWriter when libjpeg-turbo isn't available.
+ */
+class ImageEncoder
+{
+public:
+    enum class Format
+    {
+        PNG,
+        JPEG,
+        WebP,
+        QOI,
+        BMP,
+        TIFF
+    };
+
+    struct Settings
+    {
+        Format format = Format::PNG;
+        int pngCompressionLevel = 1; // zlib level 0-9; 1 keeps up with decode
+        PngEncoder::Filter pngFilter = PngEncoder::Filter::Up;
+        int jpegQuality = 92;
+        JpegEncoder::Subsampling jpegSubsampling = JpegEncoder::Subsampling::S420;
+    };
+
+    /**
+     * Encode an image and write it to disk
+     * @param image Source image; converted to RGB32 if necessary
+     * @param path Destination file; the extension is not inspected
+     * @param settings Format and encoder options
+     * @return true if the file was written
+     */
+    static bool encode(const QImage &image, const QString &path, const Settings &settings);
+
+    /**
+     * Formats that can be written by this build (WebP needs Qt's webp image plugin)
+     */
+    static QList<Format> availableFormats();
+
+    static QString formatName(Format format);
+    static QString fileExtension(Format format);
+
+    /**
+     * Parse a name produced by formatName(); returns fallback for unknown names
+     */
+    static Format formatFromName(const QString &name, Format fallback = Format::PNG);
+
+    static QString pngFilterName(PngEncoder::Filter filter);
+    static QString subsamplingName(JpegEncoder::Subsampling subsampling);
+};
+
+#endif // IMAGEENCODER_H
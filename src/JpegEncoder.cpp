@@ -0,0 +1,107 @@
+#include "JpegEncoder.h"
+
+#ifdef HAVE_LIBJPEG_TURBO
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <jpeglib.h>
+
+namespace
+{
+    struct ErrorManager
+    {
+        jpeg_error_mgr base;
+        jmp_buf jump;
+    };
+
+    void onError(j_common_ptr info)
+    {
+        ErrorManager *errors = reinterpret_cast<ErrorManager *>(info->err);
+        longjmp(errors->jump, 1);
+    }
+
+    void onMessage(j_common_ptr)
+    {
+        // Warnings are not actionable here; keep libjpeg from printing to stderr
+    }
+}
+
+bool JpegEncoder::encode(const uint8_t *pixels, int width, int height, int stride,
+                         int quality, Subsampling subsampling, std::vector<uint8_t> &output)
+{
+    if (!pixels || width <= 0 || height <= 0)
+        return false;
+
+    jpeg_compress_struct info;
+    ErrorManager errors;
+    info.err = jpeg_std_error(&errors.base);
+    errors.base.error_exit = onError;
+    errors.base.output_message = onMessage;
+
+    // jpeg_mem_dest allocates with malloc and may grow the buffer; copied out at the end
+    unsigned char *buffer = nullptr;
+    unsigned long bufferSize = 0;
+
+    if (setjmp(errors.jump))
+    {
+        jpeg_destroy_compress(&info);
+        free(buffer);
+        return false;
+    }
+
+    jpeg_create_compress(&info);
+    jpeg_mem_dest(&info, &buffer, &bufferSize);
+
+    info.image_width = static_cast<JDIMENSION>(width);
+    info.image_height = static_cast<JDIMENSION>(height);
+    info.input_components = 4;
+    // RGB32 in memory is B, G, R, X on little-endian machines
+    info.in_color_space = JCS_EXT_BGRX;
+    jpeg_set_defaults(&info);
+    jpeg_set_quality(&info, std::clamp(quality, 1, 100), TRUE);
+    info.dct_method = JDCT_IFAST;
+
+    // Luma sampling factors decide the chroma subsampling; chroma stays at 1x1
+    info.comp_info[0].h_samp_factor = subsampling == Subsampling::S444 ? 1 : 2;
+    info.comp_info[0].v_samp_factor = subsampling == Subsampling::S420 ? 2 : 1;
+    for (int i = 1; i < 3; ++i)
+    {
+        info.comp_info[i].h_samp_factor = 1;
+        info.comp_info[i].v_samp_factor = 1;
+    }
+
+    jpeg_start_compress(&info, TRUE);
+    while (info.next_scanline < info.image_height)
+    {
+        JSAMPROW row = const_cast<JSAMPROW>(pixels + static_cast<ptrdiff_t>(info.next_scanline) * stride);
+        jpeg_write_scanlines(&info, &row, 1);
+    }
+    jpeg_finish_compress(&info);
+    jpeg_destroy_compress(&info);
+
+    output.assign(buffer, buffer + bufferSize);
+    free(buffer);
+    return true;
+}
+
+bool JpegEncoder::isAvailable()
+{
+    return true;
+}
+
+#else
+
+bool JpegEncoder::encode(const uint8_t *, int, int, int, int, Subsampling, std::vector<uint8_t> &)
+{
+    return false;
+}
+
+bool JpegEncoder::isAvailable()
+{
+    return false;
+}
+
+#endif
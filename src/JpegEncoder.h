@@ -0,0 +1,42 @@
+#ifndef JPEGENCODER_H
+#define JPEGENCODER_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * JPEG encoder on top of libjpeg-turbo with explicit chroma subsampling.
+ *
+ * Reads RGB32 rows directly (no intermediate RGB888 copy) and uses the fast
+ * integer DCT, which is several times quicker than QImageWriter's JPEG plugin.
+ * Only available when the build found libjpeg-turbo (HAVE_LIBJPEG_TURBO);
+ * isAvailable() reports whether it was compiled in.
+ */
+class JpegEncoder
+{
+public:
+    enum class Subsampling
+    {
+        S444, // Full chroma resolution
+        S422, // Half horizontal chroma resolution
+        S420  // Half horizontal and vertical chroma resolution
+    };
+
+    /**
+     * Encode a 32-bit 0xAARRGGBB image (QImage::Format_RGB32 memory layout) as a baseline JPEG
+     * @param pixels First byte of the image
+     * @param width Image width in pixels
+     * @param height Image height in pixels
+     * @param stride Bytes per source row
+     * @param quality 1 (smallest) to 100 (best)
+     * @param subsampling Chroma subsampling
+     * @param output Receives the complete JPEG file
+     * @return false on invalid input, encoder error, or if libjpeg-turbo isn't available
+     */
+    static bool encode(const uint8_t *pixels, int width, int height, int stride,
+                       int quality, Subsampling subsampling, std::vector<uint8_t> &output);
+
+    static bool isAvailable();
+};
+
+#endif // JPEGENCODER_H
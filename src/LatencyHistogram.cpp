@@ -0,0 +1,95 @@
+#include "LatencyHistogram.h"
+#include <QtAlgorithms>
+
+// Below this every microsecond has its own bucket
+static constexpr int kLinearBuckets = 16;
+// Highest power of two with its own buckets; anything longer lands in the last one
+static constexpr int kMaxExponent = 40;
+
+LatencyHistogram::LatencyHistogram()
+{
+    for (std::atomic<quint64> &count : m_counts)
+    {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(qint64 us)
+{
+    m_counts[bucketFor(us)].fetch_add(1, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+    Snapshot snapshot;
+    for (int i = 0; i < kBucketCount; ++i)
+    {
+        snapshot.counts[i] = m_counts[i].load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+int LatencyHistogram::bucketFor(qint64 us)
+{
+    if (us < kLinearBuckets)
+        return us < 0 ? 0 : static_cast<int>(us);
+
+    int exponent = 63 - qCountLeadingZeroBits(static_cast<quint64>(us));
+    if (exponent > kMaxExponent)
+        return kBucketCount - 1;
+
+    // The three bits below the leading one pick one of eight sub-buckets
+    int sub = static_cast<int>((us >> (exponent - 3)) & 7);
+    return kLinearBuckets + (exponent - 4) * 8 + sub;
+}
+
+qint64 LatencyHistogram::bucketUpperBound(int bucket)
+{
+    if (bucket < kLinearBuckets)
+        return bucket;
+
+    int exponent = (bucket - kLinearBuckets) / 8 + 4;
+    int sub = (bucket - kLinearBuckets) % 8;
+    return ((8LL + sub + 1) << (exponent - 3)) - 1;
+}
+
+quint64 LatencyHistogram::Snapshot::total() const
+{
+    quint64 sum = 0;
+    for (quint64 count : counts)
+    {
+        sum += count;
+    }
+    return sum;
+}
+
+qint64 LatencyHistogram::Snapshot::percentile(double fraction) const
+{
+    quint64 sum = total();
+    if (sum == 0)
+        return 0;
+
+    // Rank of the wanted sample, 1-based, so p0 is the first sample and p100 the last
+    quint64 rank = qMax<quint64>(1, static_cast<quint64>(fraction * sum + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < kBucketCount; ++i)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+        {
+            qint64 lower = i == 0 ? 0 : bucketUpperBound(i - 1) + 1;
+            return (lower + bucketUpperBound(i)) / 2;
+        }
+    }
+    return bucketUpperBound(kBucketCount - 1);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::Snapshot::operator-(const Snapshot &older) const
+{
+    Snapshot difference;
+    for (int i = 0; i < kBucketCount; ++i)
+    {
+        difference.counts[i] = counts[i] - older.counts[i];
+    }
+    return difference;
+}
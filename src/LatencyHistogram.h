@@ -0,0 +1,52 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+
+/**
+ * Lock-free histogram of durations in microseconds.
+ *
+ * Buckets are log-linear: exact below 16us, then eight per power of two, so
+ * any percentile is within about 6% of the true value from 1us to over a
+ * day. record() is one relaxed atomic increment and may be called from any
+ * thread. Readers take a Snapshot and subtract an older one to get the
+ * distribution over a time window without ever resetting the counters.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr int kBucketCount = 16 + 37 * 8;
+
+    struct Snapshot
+    {
+        std::array<quint64, kBucketCount> counts{};
+
+        quint64 total() const;
+
+        /**
+         * @param fraction e.g. 0.95 for p95
+         * @return Middle of the bucket holding that percentile in us, 0 if empty
+         */
+        qint64 percentile(double fraction) const;
+
+        /**
+         * Counts recorded after the older snapshot was taken
+         */
+        Snapshot operator-(const Snapshot &older) const;
+    };
+
+    LatencyHistogram();
+
+    void record(qint64 us);
+    Snapshot snapshot() const;
+
+    static int bucketFor(qint64 us);
+    static qint64 bucketUpperBound(int bucket);
+
+private:
+    std::array<std::atomic<quint64>, kBucketCount> m_counts;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -6,11 +6,19 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/pattern_formatter.h>
 #include <memory>
+#include "AsyncLogSink.h"
+
+// SPDLOG_ACTIVE_LEVEL comes from the PICKER_LOG_LEVEL build option; LOG_* calls below it compile to nothing
 
 class Logger
 {
 public:
-    static void initialize()
+    /**
+     * @param asynchronous Write and flush on a background thread; the calling thread only
+     *                     copies the message into a ring buffer. Synchronous logging writes
+     *                     every message before returning, which helps when debugging a crash.
+     */
+    static void initialize(bool asynchronous = true)
     {
         if (s_initialized)
             return;
@@ -29,8 +37,15 @@ public:
 
             // Create logger with both sinks
             std::vector<spdlog::sink_ptr> sinks{console_sink, file_sink};
+            if (asynchronous)
+            {
+                auto async_sink = std::make_shared<AsyncLogSink>(sinks);
+                s_asyncSink = async_sink;
+                sinks = {async_sink};
+            }
             auto logger = std::make_shared<spdlog::logger>("main", sinks.begin(), sinks.end());
             logger->set_level(spdlog::level::debug);
+            // With the async sink this only asks the flush thread to flush
             logger->flush_on(spdlog::level::info);
 
             spdlog::set_default_logger(logger);
@@ -38,7 +53,7 @@ public:
 
             s_initialized = true;
 
-            SPDLOG_INFO("Logger initialized successfully");
+            SPDLOG_INFO("Logger initialized successfully ({})", asynchronous ? "asynchronous" : "synchronous");
         }
         catch (const spdlog::spdlog_ex &ex)
         {
@@ -54,8 +69,40 @@ public:
         }
     }
 
+    /**
+     * Write out queued messages and stop the flush thread; call before returning from main
+     * Anything logged afterwards, e.g. from destructors, is written synchronously.
+     */
+    static void shutdown()
+    {
+        auto async_sink = s_asyncSink.lock();
+        if (!async_sink)
+            return;
+
+        auto async_logger = spdlog::default_logger();
+        auto logger = std::make_shared<spdlog::logger>("main", async_sink->targets().begin(), async_sink->targets().end());
+        logger->set_level(async_logger->level());
+        logger->flush_on(spdlog::level::info);
+        spdlog::set_default_logger(logger);
+
+        // Dropping the last references drains the queue and joins the flush thread
+        s_asyncSink.reset();
+        async_logger.reset();
+        async_sink.reset();
+    }
+
+    /**
+     * Messages discarded because the async queue was full
+     */
+    static size_t droppedMessages()
+    {
+        auto sink = s_asyncSink.lock();
+        return sink ? sink->droppedCount() : 0;
+    }
+
 private:
     inline static bool s_initialized = false;
+    inline static std::weak_ptr<AsyncLogSink> s_asyncSink;
 };
 
 // Convenience macros
@@ -1,9 +1,11 @@
 #include "MainWindow.h"
+#include "PerceptualHash.h"
+#include "PerfStats.h"
+#include "Tracer.h"
 #include <QApplication>
 #include <QDir>
 #include <QStandardPaths>
 #include <QDateTime>
-#include <QPixmap>
 #include <QVideoFrame>
 #include <QVideoSink>
 #include <QPainter>
@@ -14,10 +16,36 @@
 #include <QFont>
 #include <QTime>
 #include <QProcess>
-#include <QRegularExpression>
+#include <QSignalBlocker>
+#include <QMap>
+#include <QImageReader>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+#include <cstring>
+
+// Step timer ticks spent waiting for the read-ahead thread before falling back to a player seek
+static constexpr int kMaxStepWaitTicks = 3;
+
+// Wrap a decoded RGB32 image in a video frame that can be pushed into a QVideoSink
+static QVideoFrame videoFrameFromImage(const QImage &image)
+{
+    QVideoFrame frame(QVideoFrameFormat(image.size(), QVideoFrameFormat::Format_BGRX8888));
+    if (!frame.map(QVideoFrame::WriteOnly))
+    {
+        return QVideoFrame();
+    }
+
+    const size_t rowBytes = static_cast<size_t>(image.width()) * 4;
+    for (int y = 0; y < image.height(); ++y)
+    {
+        std::memcpy(frame.bits(0) + y * frame.bytesPerLine(0), image.constScanLine(y), rowBytes);
+    }
+    frame.unmap();
+    return frame;
+}
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), m_centralWidget(nullptr), m_mainSplitter(nullptr), m_videoWidget(nullptr), m_videoDisplay(nullptr), m_mediaPlayer(nullptr), m_frameCaptureSink(nullptr), m_controlsWidget(nullptr), m_playPauseBtn(nullptr), m_previousFrameBtn(nullptr), m_nextFrameBtn(nullptr), m_saveFrameBtn(nullptr), m_positionSlider(nullptr), m_timeLabel(nullptr), m_durationLabel(nullptr), m_frameListWidget(nullptr), m_frameList(nullptr), m_removeFrameBtn(nullptr), m_exportFramesBtn(nullptr), m_clearFramesBtn(nullptr), m_frameCountLabel(nullptr), m_settingsGroup(nullptr), m_outputDirEdit(nullptr), m_browseDirBtn(nullptr), m_imageFormatCombo(nullptr), m_openVideoAction(nullptr), m_exitAction(nullptr), m_aboutAction(nullptr), m_progressBar(nullptr), m_filePathLabel(nullptr), m_frameStepTimer(nullptr), m_isSteppingForward(false), m_isSteppingBackward(false), m_stepInterval(200), m_videoDuration(0), m_isPlaying(false), m_toggleFrameListBtn(nullptr), m_frameCaptureMethod(CAPTURE_QT_SINK), m_ffmpegAvailable(false), m_lastPositionUpdate(0), m_lastUIUpdate(0)
+    : QMainWindow(parent), m_centralWidget(nullptr), m_mainSplitter(nullptr), m_videoWidget(nullptr), m_videoDisplay(nullptr), m_mediaPlayer(nullptr), m_frameCaptureSink(nullptr), m_controlsWidget(nullptr), m_playPauseBtn(nullptr), m_previousFrameBtn(nullptr), m_nextFrameBtn(nullptr), m_saveFrameBtn(nullptr), m_snapSharpestBtn(nullptr), m_snapRadiusSpin(nullptr), m_positionSlider(nullptr), m_timeLabel(nullptr), m_durationLabel(nullptr), m_frameListWidget(nullptr), m_frameList(nullptr), m_frameListModel(nullptr), m_removeFrameBtn(nullptr), m_exportFramesBtn(nullptr), m_clearFramesBtn(nullptr), m_frameCountLabel(nullptr), m_settingsGroup(nullptr), m_outputDirEdit(nullptr), m_browseDirBtn(nullptr), m_imageFormatCombo(nullptr), m_encoderLevelLabel(nullptr), m_encoderLevelSpin(nullptr), m_encoderModeCombo(nullptr), m_openVideoAction(nullptr), m_exitAction(nullptr), m_aboutAction(nullptr), m_captureMethodAction(nullptr), m_saveTraceAction(nullptr), m_setInPointAction(nullptr), m_setOutPointAction(nullptr), m_clearInOutAction(nullptr), m_extractRangeAction(nullptr), m_extractVideosAction(nullptr), m_detectScenesAction(nullptr), m_showSharpnessAction(nullptr), m_reviewCapturesAction(nullptr), m_showPerfHudAction(nullptr), m_progressBar(nullptr), m_filePathLabel(nullptr), m_frameStepTimer(nullptr), m_isSteppingForward(false), m_isSteppingBackward(false), m_stepInterval(200), m_stepWaitTicks(0), m_frameIndexWatcher(nullptr), m_currentFrameIndex(-1), m_readAheadDecoder(nullptr), m_playerSyncTimer(nullptr), m_reviewTimer(nullptr), m_videoDuration(0), m_isPlaying(false), m_toggleFrameListBtn(nullptr), m_frameCaptureMethod(CAPTURE_QT_SINK), m_ffmpegAvailable(false), m_captureDecodePool(nullptr), m_frameWriter(nullptr), m_hashIndexWatcher(nullptr), m_hashIndexReload(false), m_duplicateModeCombo(nullptr), m_duplicateThresholdSpin(nullptr), m_duplicatePolicy(FrameWriter::DuplicatePolicy::Warn), m_duplicateThreshold(6), m_saveQueueLabel(nullptr), m_batchExporter(nullptr), m_extractionQueue(nullptr), m_inPoint(-1), m_outPoint(-1), m_sceneDetector(nullptr), m_capturedMarkerLayer(-1), m_sceneCutMarkerLayer(-1), m_frameDirectoryIndex(nullptr), m_sharpnessSparkline(nullptr), m_sharpnessWatcher(nullptr), m_snapCentre(-1), m_perfHud(nullptr), m_lastPositionUpdate(0), m_lastUIUpdate(0)
 {
     setupUI();
     setupMenuBar();
@@ -29,16 +57,68 @@ MainWindow::MainWindow(QWidget *parent)
     m_frameStepTimer->setSingleShot(false);
     connect(m_frameStepTimer, &QTimer::timeout, this, &MainWindow::onFrameStepTimer);
 
-    // Load settings before setting default values
-    loadSettings();
+    // Frame index is built off the GUI thread whenever a video is opened
+    m_frameIndexWatcher = new QFutureWatcher<FrameIndex>(this);
+    connect(m_frameIndexWatcher, &QFutureWatcher<FrameIndex>::finished, this, &MainWindow::onFrameIndexReady);
+
+    // Keeps the timestamps of frames already in the output directory up to date
+    m_frameDirectoryIndex = new FrameDirectoryIndex(this);
+    connect(m_frameDirectoryIndex, &FrameDirectoryIndex::loaded, this, &MainWindow::scanForExistingFrames);
+    connect(m_frameDirectoryIndex, &FrameDirectoryIndex::updated, this, &MainWindow::refreshExistingFrameMarkers);
+
+    m_sharpnessWatcher = new QFutureWatcher<ScoredFrames>(this);
+    connect(m_sharpnessWatcher, &QFutureWatcher<ScoredFrames>::finished, this, &MainWindow::onSharpnessScored);
+
+    // Hash index passes queue up behind each other instead of blocking the GUI
+    m_hashIndexWatcher = new QFutureWatcher<void>(this);
+    connect(m_hashIndexWatcher, &QFutureWatcher<void>::finished, this, &MainWindow::startHashIndexWork);
+
+    // Decodes ahead of the playhead into the frame cache
+    m_readAheadDecoder = new ReadAheadDecoder(&m_frameCache, &m_sharpnessTrack, this);
+    m_readAheadDecoder->start();
+
+    m_playerSyncTimer = new QTimer(this);
+    m_playerSyncTimer->setSingleShot(true);
+    m_playerSyncTimer->setInterval(150);
+    connect(m_playerSyncTimer, &QTimer::timeout, this, &MainWindow::syncPlayerPosition);
+
+    m_reviewTimer = new QTimer(this);
+    m_reviewTimer->setInterval(QSettings().value("review/intervalMs", 1000).toInt());
+    connect(m_reviewTimer, &QTimer::timeout, this, &MainWindow::onReviewTimer);
+
+    // Capture decodes run on their own thread so the warm decoder never blocks the GUI
+    m_captureDecodePool = new QThreadPool(this);
+    m_captureDecodePool->setMaxThreadCount(1);
 
-    // Check ffmpeg availability and set default capture method
+    // Conversion and encoding of saved frames happen on a bounded background pool
+    m_frameWriter = new FrameWriter(8, this);
+    connect(m_frameWriter, &FrameWriter::frameWritten, this, &MainWindow::onFrameWritten);
+    connect(m_frameWriter, &FrameWriter::inFlightChanged, this, &MainWindow::onSaveQueueChanged);
+    connect(m_frameWriter, &FrameWriter::duplicateFound, this, &MainWindow::onDuplicateFound);
+
+    m_perfHud = new PerfHud(m_videoDisplay, &m_frameCache, m_frameWriter, this);
+    connect(m_showPerfHudAction, &QAction::toggled, m_perfHud, &QWidget::setVisible);
+
+    // Batch export decodes on its own thread and encodes on all cores
+    m_batchExporter = new BatchExporter(this);
+    connect(m_batchExporter, &BatchExporter::progress, this, &MainWindow::onExportProgress);
+    connect(m_batchExporter, &BatchExporter::exportFinished, this, &MainWindow::onExportFinished);
+
+    // Multi-video extraction shares one work-stealing pool between decoders and encoders
+    m_extractionQueue = new ExtractionQueue(0, this);
+    connect(m_extractionQueue, &ExtractionQueue::jobProgress, this, &MainWindow::onQueueProgress);
+    connect(m_extractionQueue, &ExtractionQueue::jobFinished, this, &MainWindow::onQueueProgress);
+    connect(m_extractionQueue, &ExtractionQueue::allJobsFinished, this, &MainWindow::onQueueFinished);
+
+    // Check ffmpeg availability; the in-process libav decoder is the default capture method
     m_ffmpegAvailable = checkFFmpegAvailable();
-    m_frameCaptureMethod = m_ffmpegAvailable ? CAPTURE_FFMPEG : CAPTURE_QT_SINK;
+    m_frameCaptureMethod = CAPTURE_LIBAV;
+
+    // Load settings before setting default values
+    loadSettings();
 
     LOG_INFO("FFmpeg available: {}, using capture method: {}",
-             m_ffmpegAvailable,
-             m_frameCaptureMethod == CAPTURE_FFMPEG ? "FFmpeg" : "Qt Sink");
+             m_ffmpegAvailable, captureMethodName(m_frameCaptureMethod).toStdString());
 
     // Set default output directory if not loaded from settings
     if (m_outputDirectory.isEmpty())
@@ -49,6 +129,8 @@ MainWindow::MainWindow(QWidget *parent)
 
     // Create output directory if it doesn't exist
     QDir().mkpath(m_outputDirectory);
+    m_frameDirectoryIndex->setDirectory(m_outputDirectory);
+    refreshHashIndex();
 
     // Auto-load last opened video if it exists
     if (!m_lastVideoPath.isEmpty() && QFileInfo::exists(m_lastVideoPath))
@@ -60,8 +142,9 @@ MainWindow::MainWindow(QWidget *parent)
             m_currentVideoPath = m_lastVideoPath;
             setDefaultFilenamePrefix(m_lastVideoPath);
             updateFilePathDisplay(m_lastVideoPath);
-            m_mediaPlayer->setVideoOutput(m_videoDisplay);
+            m_mediaPlayer->setVideoOutput(m_frameCaptureSink);
             m_mediaPlayer->setSource(QUrl::fromLocalFile(m_lastVideoPath));
+            startFrameIndexing(m_lastVideoPath);
             statusBar()->showMessage("Auto-loaded: " + QFileInfo(m_lastVideoPath).fileName(), 3000);
             updateControls(); });
     }
@@ -82,6 +165,55 @@ MainWindow::~MainWindow()
     // Save settings before cleanup
     saveSettings();
 
+    // Don't leave the indexer scanning a file after the window is gone
+    cancelFrameIndexing();
+    if (m_frameIndexWatcher)
+    {
+        m_frameIndexWatcher->waitForFinished();
+    }
+
+    // The read-ahead thread writes into m_frameCache, so it must stop first
+    if (m_readAheadDecoder)
+    {
+        m_readAheadDecoder->stop();
+    }
+
+    // Let pending libav captures decode before their decoder goes away
+    if (m_captureDecodePool)
+    {
+        m_captureDecodePool->waitForDone();
+    }
+    m_captureDecoder.reset();
+
+    // An unfinished export is abandoned; frames already decoded are still written
+    if (m_batchExporter)
+    {
+        m_batchExporter->cancel();
+        m_batchExporter->wait();
+    }
+    if (m_extractionQueue)
+    {
+        m_extractionQueue->cancel();
+        m_extractionQueue->waitForDone();
+    }
+    stopSceneDetection();
+    m_hashIndexReload = false;
+    m_hashIndexPendingFiles.clear();
+    if (m_hashIndexCancel)
+    {
+        m_hashIndexCancel->store(true);
+    }
+    if (m_hashIndexWatcher)
+    {
+        m_hashIndexWatcher->waitForFinished();
+    }
+
+    // Don't drop frames that are still being encoded
+    if (m_frameWriter)
+    {
+        m_frameWriter->waitForDone();
+    }
+
     if (m_mediaPlayer)
     {
         m_mediaPlayer->stop();
@@ -104,7 +236,6 @@ void MainWindow::setupUI()
     m_videoDisplay->setMinimumSize(640, 480);
     m_videoDisplay->setFocusPolicy(Qt::NoFocus); // Prevent stealing keyboard focus
     m_mediaPlayer = new QMediaPlayer;
-    m_mediaPlayer->setVideoOutput(m_videoDisplay);
 
 // Add performance optimizations for smoother playback
 #ifdef Q_OS_MACOS
@@ -122,17 +253,19 @@ void MainWindow::setupUI()
     // connect(m_frameCaptureSink, &FrameCaptureSink::frameAvailable, this, &MainWindow::onFrameAvailable);
     LOG_INFO("Created frame capture sink");
 
-    // Connect to the video widget's sink to capture frames
+    // Dual output: the player renders into the capture sink, which keeps a reference to
+    // each frame and forwards it to the video widget, so capture always sees what is shown
     QVideoSink *displaySink = m_videoDisplay->videoSink();
     if (displaySink)
     {
-        connect(displaySink, &QVideoSink::videoFrameChanged, m_frameCaptureSink, &FrameCaptureSink::onFrameChanged);
-        LOG_INFO("Connected to display sink for frame capture");
+        m_frameCaptureSink->setDisplaySink(displaySink);
+        LOG_INFO("Frame capture sink forwards to display sink");
     }
     else
     {
         LOG_ERROR("Failed to get display sink from video widget");
     }
+    m_mediaPlayer->setVideoOutput(m_frameCaptureSink);
     videoLayout->addWidget(m_videoDisplay);
 
     // Setup controls
@@ -145,17 +278,29 @@ void MainWindow::setupUI()
     m_previousFrameBtn = new QPushButton("Previous Frame");
     m_nextFrameBtn = new QPushButton("Next Frame");
     m_saveFrameBtn = new QPushButton("Save Current Frame");
+    m_snapSharpestBtn = new QPushButton("Snap to Sharpest");
+    m_snapSharpestBtn->setToolTip("Move to the sharpest frame near the playhead (S)");
+    m_snapRadiusSpin = new QSpinBox;
+    m_snapRadiusSpin->setRange(1, 60);
+    m_snapRadiusSpin->setValue(QSettings().value("sharpness/snapRadius", 5).toInt());
+    m_snapRadiusSpin->setPrefix("±");
+    m_snapRadiusSpin->setSuffix(" frames");
+    m_snapRadiusSpin->setToolTip("How far Snap to Sharpest searches on each side of the playhead");
 
     playbackLayout->addWidget(m_playPauseBtn);
     playbackLayout->addWidget(m_previousFrameBtn);
     playbackLayout->addWidget(m_nextFrameBtn);
     playbackLayout->addWidget(m_saveFrameBtn);
+    playbackLayout->addWidget(m_snapSharpestBtn);
+    playbackLayout->addWidget(m_snapRadiusSpin);
     playbackLayout->addStretch();
 
     // Position slider and time labels
     QHBoxLayout *positionLayout = new QHBoxLayout;
     m_timeLabel = new QLabel("00:00");
-    m_positionSlider = new QSlider(Qt::Horizontal);
+    m_positionSlider = new TimelineWidget;
+    m_capturedMarkerLayer = m_positionSlider->addMarkerLayer("Saved frame", QColor("#ff4444"));
+    m_sceneCutMarkerLayer = m_positionSlider->addMarkerLayer("Scene cut", QColor("#f0a020"));
     m_durationLabel = new QLabel("00:00");
 
     positionLayout->addWidget(m_timeLabel);
@@ -165,6 +310,9 @@ void MainWindow::setupUI()
     controlsLayout->addLayout(playbackLayout);
     controlsLayout->addLayout(positionLayout);
 
+    m_sharpnessSparkline = new SharpnessSparkline(m_positionSlider, &m_sharpnessTrack);
+    controlsLayout->addWidget(m_sharpnessSparkline);
+
     // Add video and controls to video section
     QVBoxLayout *leftLayout = new QVBoxLayout;
     QWidget *leftWidget = new QWidget;
@@ -190,7 +338,12 @@ void MainWindow::setupUI()
     frameListTitleLayout->addWidget(m_toggleFrameListBtn);
     frameListTitleLayout->setContentsMargins(0, 0, 0, 0);
     frameListTitle->setStyleSheet("font-weight: bold; font-size: 14px;");
-    m_frameList = new QListWidget;
+    m_frameListModel = new FrameListModel(this);
+    m_frameList = new QListView;
+    m_frameList->setModel(m_frameListModel);
+    m_frameList->setUniformItemSizes(true);
+    m_frameList->setIconSize(m_frameListModel->thumbnailSize());
+    m_frameList->setSelectionMode(QAbstractItemView::SingleSelection);
     m_frameCountLabel = new QLabel("Frames: 0");
 
     // Frame list controls
@@ -220,12 +373,42 @@ void MainWindow::setupUI()
     QHBoxLayout *formatLayout = new QHBoxLayout;
     QLabel *formatLabel = new QLabel("Image Format:");
     m_imageFormatCombo = new QComboBox;
-    m_imageFormatCombo->addItems({"PNG", "JPEG", "BMP", "TIFF"});
+    for (ImageEncoder::Format format : ImageEncoder::availableFormats())
+    {
+        m_imageFormatCombo->addItem(ImageEncoder::formatName(format), static_cast<int>(format));
+    }
+
+    // Per-format encoder options; relabelled and repopulated by updateEncoderControls()
+    m_encoderLevelLabel = new QLabel;
+    m_encoderLevelSpin = new QSpinBox;
+    m_encoderModeCombo = new QComboBox;
 
     formatLayout->addWidget(formatLabel);
     formatLayout->addWidget(m_imageFormatCombo);
+    formatLayout->addWidget(m_encoderLevelLabel);
+    formatLayout->addWidget(m_encoderLevelSpin);
+    formatLayout->addWidget(m_encoderModeCombo);
     formatLayout->addStretch();
 
+    // Near-duplicates of frames already in the output directory
+    QHBoxLayout *duplicateLayout = new QHBoxLayout;
+    QLabel *duplicateLabel = new QLabel("Near-Duplicates:");
+    m_duplicateModeCombo = new QComboBox;
+    m_duplicateModeCombo->addItem("Keep", static_cast<int>(FrameWriter::DuplicatePolicy::Keep));
+    m_duplicateModeCombo->addItem("Warn", static_cast<int>(FrameWriter::DuplicatePolicy::Warn));
+    m_duplicateModeCombo->addItem("Skip", static_cast<int>(FrameWriter::DuplicatePolicy::Skip));
+    m_duplicateModeCombo->setToolTip("What to do when a saved frame looks like one already in the output directory");
+    m_duplicateThresholdSpin = new QSpinBox;
+    m_duplicateThresholdSpin->setRange(0, 32);
+    m_duplicateThresholdSpin->setPrefix("within ");
+    m_duplicateThresholdSpin->setSuffix(" bits");
+    m_duplicateThresholdSpin->setToolTip("Largest perceptual hash distance that counts as a duplicate (0 = identical)");
+
+    duplicateLayout->addWidget(duplicateLabel);
+    duplicateLayout->addWidget(m_duplicateModeCombo);
+    duplicateLayout->addWidget(m_duplicateThresholdSpin);
+    duplicateLayout->addStretch();
+
     // Filename prefix layout
     QHBoxLayout *filenamePrefixLayout = new QHBoxLayout;
     QLabel *filenamePrefixLabel = new QLabel("Filename Prefix:");
@@ -233,7 +416,7 @@ void MainWindow::setupUI()
     m_filenamePrefixEdit->setMinimumWidth(150); // Make it wider
 
     // Put pattern hint on next line to save space
-    QLabel *patternHint = new QLabel("Pattern: <prefix>_<timestamp>_<videoposition>ms_<width>_<height>.png");
+    QLabel *patternHint = new QLabel("Pattern: <prefix>_<videoposition>.<format extension>");
     patternHint->setStyleSheet("color: gray; font-style: italic; font-size: 10px;");
 
     filenamePrefixLayout->addWidget(filenamePrefixLabel);
@@ -242,6 +425,7 @@ void MainWindow::setupUI()
 
     settingsLayout->addLayout(outputDirLayout);
     settingsLayout->addLayout(formatLayout);
+    settingsLayout->addLayout(duplicateLayout);
     settingsLayout->addLayout(filenamePrefixLayout);
     settingsLayout->addWidget(patternHint);
 
@@ -274,6 +458,11 @@ void MainWindow::setupUI()
     m_filePathLabel->setToolTip("Currently loaded video file");
     statusBar()->addWidget(m_filePathLabel);
 
+    m_saveQueueLabel = new QLabel;
+    m_saveQueueLabel->setToolTip("Frames waiting to be written to disk");
+    m_saveQueueLabel->setVisible(false);
+    statusBar()->addPermanentWidget(m_saveQueueLabel);
+
     m_progressBar = new QProgressBar;
     m_progressBar->setVisible(false);
     statusBar()->addPermanentWidget(m_progressBar);
@@ -290,6 +479,44 @@ void MainWindow::setupMenuBar()
 
     fileMenu->addSeparator();
 
+    m_setInPointAction = new QAction("Set &In Point\tI", this);
+    fileMenu->addAction(m_setInPointAction);
+
+    m_setOutPointAction = new QAction("Set O&ut Point\tO", this);
+    fileMenu->addAction(m_setOutPointAction);
+
+    m_clearInOutAction = new QAction("&Clear In/Out Points", this);
+    fileMenu->addAction(m_clearInOutAction);
+
+    m_extractRangeAction = new QAction("&Extract Range...", this);
+    m_extractRangeAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_E));
+    fileMenu->addAction(m_extractRangeAction);
+
+    m_extractVideosAction = new QAction("Extract from &Multiple Videos...", this);
+    fileMenu->addAction(m_extractVideosAction);
+
+    m_detectScenesAction = new QAction("Detect Scene &Cuts", this);
+    m_detectScenesAction->setCheckable(true);
+    m_detectScenesAction->setChecked(QSettings().value("sceneDetection/enabled", true).toBool());
+    fileMenu->addAction(m_detectScenesAction);
+
+    m_showSharpnessAction = new QAction("Show &Sharpness Graph", this);
+    m_showSharpnessAction->setCheckable(true);
+    m_showSharpnessAction->setChecked(QSettings().value("sharpness/showGraph", false).toBool());
+    m_sharpnessSparkline->setVisible(m_showSharpnessAction->isChecked());
+    fileMenu->addAction(m_showSharpnessAction);
+
+    m_reviewCapturesAction = new QAction("&Review Captures\tR", this);
+    m_reviewCapturesAction->setCheckable(true);
+    fileMenu->addAction(m_reviewCapturesAction);
+
+    m_showPerfHudAction = new QAction("Show &Performance HUD", this);
+    m_showPerfHudAction->setCheckable(true);
+    m_showPerfHudAction->setShortcut(QKeySequence(Qt::Key_F3));
+    fileMenu->addAction(m_showPerfHudAction);
+
+    fileMenu->addSeparator();
+
     m_exitAction = new QAction("E&xit", this);
     m_exitAction->setShortcut(QKeySequence::Quit);
     fileMenu->addAction(m_exitAction);
@@ -303,6 +530,12 @@ void MainWindow::setupMenuBar()
     m_logLevelAction = new QAction("&Log Level...", this);
     helpMenu->addAction(m_logLevelAction);
 
+    m_captureMethodAction = new QAction("&Capture Method...", this);
+    helpMenu->addAction(m_captureMethodAction);
+
+    m_saveTraceAction = new QAction("Save Performance &Trace...", this);
+    helpMenu->addAction(m_saveTraceAction);
+
     helpMenu->addSeparator();
 
     m_aboutAction = new QAction("&About", this);
@@ -325,6 +558,23 @@ void MainWindow::connectSignals()
                                  "This application is licensed under MIT License\n"
                                  "See LICENSE file for details."); });
 
+    connect(m_setInPointAction, &QAction::triggered, this, &MainWindow::setInPoint);
+    connect(m_setOutPointAction, &QAction::triggered, this, &MainWindow::setOutPoint);
+    connect(m_clearInOutAction, &QAction::triggered, this, &MainWindow::clearInOutPoints);
+    connect(m_extractRangeAction, &QAction::triggered, this, &MainWindow::extractRange);
+    connect(m_extractVideosAction, &QAction::triggered, this, &MainWindow::extractMultipleVideos);
+    connect(m_detectScenesAction, &QAction::toggled, this, [this](bool enabled)
+            {
+        QSettings().setValue("sceneDetection/enabled", enabled);
+        if (enabled)
+            startSceneDetection();
+        else
+            stopSceneDetection(); });
+    connect(m_showSharpnessAction, &QAction::toggled, this, [this](bool enabled)
+            {
+        QSettings().setValue("sharpness/showGraph", enabled);
+        m_sharpnessSparkline->setVisible(enabled); });
+    connect(m_reviewCapturesAction, &QAction::toggled, this, &MainWindow::setReviewMode);
     connect(m_keyboardShortcutsAction, &QAction::triggered, [this]()
             { QMessageBox::information(this, "Keyboard Shortcuts",
                                        "Available keyboard shortcuts:\n\n"
@@ -332,7 +582,14 @@ void MainWindow::connectSignals()
                                        "  • Single press: Move one frame\n"
                                        "  • Hold: Accelerated frame stepping\n\n"
                                        "Space: Play/Pause video\n"
-                                       "Ctrl+S: Save current frame\n\n"
+                                       "Ctrl+S: Save current frame\n"
+                                       "S: Snap to the sharpest nearby frame\n"
+                                       "I / O: Set range in/out point\n"
+                                       "Ctrl+E: Extract range\n"
+                                       "[ / ]: Jump to previous/next scene cut\n"
+                                       ", / .: Jump to previous/next captured frame\n"
+                                       "R: Review captures one after another\n"
+                                       "F3: Show/hide the performance HUD\n\n"
                                        "Note: Click on the main window area to ensure\n"
                                        "keyboard focus is on the video player."); });
 
@@ -352,14 +609,52 @@ void MainWindow::connectSignals()
             LOG_INFO("Log level changed to: {}", level.toStdString());
         } });
 
+    connect(m_captureMethodAction, &QAction::triggered, [this]()
+            {
+        QList<FrameCaptureMethod> methods = {CAPTURE_LIBAV, CAPTURE_FFMPEG, CAPTURE_QT_SINK};
+        QStringList names;
+        for (FrameCaptureMethod method : methods)
+            names << captureMethodName(method);
+        bool ok;
+        QString name = QInputDialog::getItem(this, "Capture Method", "Select frame capture method:",
+                                             names, methods.indexOf(m_frameCaptureMethod), false, &ok);
+        if (ok) {
+            FrameCaptureMethod method = methods[names.indexOf(name)];
+            if (method == CAPTURE_FFMPEG && !m_ffmpegAvailable) {
+                QMessageBox::warning(this, "Capture Method", "ffmpeg was not found on the PATH.");
+                return;
+            }
+            m_frameCaptureMethod = method;
+            saveSettings();
+            LOG_INFO("Capture method changed to: {}", name.toStdString());
+        } });
+
+    connect(m_saveTraceAction, &QAction::triggered, [this]()
+            {
+        QString path = QFileDialog::getSaveFileName(this, "Save Performance Trace",
+                                                    QDir(m_outputDirectory).filePath("picker-trace.json"),
+                                                    "Chrome Trace (*.json)");
+        if (path.isEmpty())
+            return;
+        QString error;
+        int spans = Tracer::writeChromeTrace(path, &error);
+        if (spans < 0) {
+            QMessageBox::warning(this, "Save Performance Trace", "Could not write the trace:\n" + error);
+            return;
+        }
+        statusBar()->showMessage(QString("Saved %1 spans; open in chrome://tracing or ui.perfetto.dev").arg(spans), 5000); });
+
     // Control buttons
     connect(m_playPauseBtn, &QPushButton::clicked, this, &MainWindow::playPause);
     connect(m_previousFrameBtn, &QPushButton::clicked, this, &MainWindow::previousFrame);
     connect(m_nextFrameBtn, &QPushButton::clicked, this, &MainWindow::nextFrame);
     connect(m_saveFrameBtn, &QPushButton::clicked, this, &MainWindow::saveCurrentFrame);
+    connect(m_snapSharpestBtn, &QPushButton::clicked, this, &MainWindow::snapToSharpestFrame);
+    connect(m_snapRadiusSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, [](int radius)
+            { QSettings().setValue("sharpness/snapRadius", radius); });
 
     // Slider
-    connect(m_positionSlider, &QSlider::valueChanged, this, &MainWindow::seekToPosition);
+    connect(m_positionSlider, &TimelineWidget::valueChanged, this, &MainWindow::seekToPosition);
 
     // Media player
     connect(m_mediaPlayer, &QMediaPlayer::positionChanged, this, &MainWindow::onPositionChanged);
@@ -372,25 +667,19 @@ void MainWindow::connectSignals()
     connect(m_clearFramesBtn, &QPushButton::clicked, this, &MainWindow::clearSelectedFrames);
 
     // Auto-update button states based on frame list changes (instead of manual updateControls calls)
-    connect(m_frameList, &QListWidget::itemSelectionChanged, [this]()
-            { m_removeFrameBtn->setEnabled(m_frameList->currentRow() >= 0); });
-    connect(m_frameList, &QListWidget::itemChanged, [this]()
-            {
-        bool hasFrames = m_frameList->count() > 0;
-        m_exportFramesBtn->setEnabled(hasFrames);
-        m_clearFramesBtn->setEnabled(hasFrames); });
-    // Also handle when items are added/removed programmatically
-    connect(m_frameList->model(), &QAbstractItemModel::rowsInserted, [this]()
-            {
-        bool hasFrames = m_frameList->count() > 0;
-        m_exportFramesBtn->setEnabled(hasFrames);
-        m_clearFramesBtn->setEnabled(hasFrames); });
-    connect(m_frameList->model(), &QAbstractItemModel::rowsRemoved, [this]()
-            {
-        bool hasFrames = m_frameList->count() > 0;
+    connect(m_frameList->selectionModel(), &QItemSelectionModel::currentChanged, [this](const QModelIndex &current)
+            { m_removeFrameBtn->setEnabled(current.isValid()); });
+    // Also handle when frames are added/removed programmatically
+    auto updateListButtons = [this]()
+    {
+        bool hasFrames = m_frameListModel->rowCount() > 0;
         m_exportFramesBtn->setEnabled(hasFrames);
         m_clearFramesBtn->setEnabled(hasFrames);
-        m_removeFrameBtn->setEnabled(m_frameList->currentRow() >= 0); });
+        m_removeFrameBtn->setEnabled(m_frameList->currentIndex().isValid());
+    };
+    connect(m_frameListModel, &QAbstractItemModel::rowsInserted, this, updateListButtons);
+    connect(m_frameListModel, &QAbstractItemModel::rowsRemoved, this, updateListButtons);
+    connect(m_frameListModel, &QAbstractItemModel::modelReset, this, updateListButtons);
 
     // Settings
     connect(m_browseDirBtn, &QPushButton::clicked, [this]()
@@ -403,12 +692,24 @@ void MainWindow::connectSignals()
             // Save settings immediately when directory changes
             saveSettings();
 
-            // Scan for existing frames when directory changes
-            scanForExistingFrames();
+            // Existing frames are marked once the new directory has been indexed
+            m_frameDirectoryIndex->setDirectory(dir);
+            openCaptureManifest();
+            refreshHashIndex();
 
             LOG_INFO("Output directory changed to: {}", dir.toStdString());
         } });
 
+    // Markers follow the prefix frames are saved under
+    connect(m_filenamePrefixEdit, &QLineEdit::editingFinished, this, &MainWindow::refreshExistingFrameMarkers);
+
+    // Encoder settings
+    connect(m_imageFormatCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onImageFormatChanged);
+    connect(m_encoderLevelSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::onEncoderOptionChanged);
+    connect(m_encoderModeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onEncoderOptionChanged);
+    connect(m_duplicateModeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onDuplicateOptionChanged);
+    connect(m_duplicateThresholdSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::onDuplicateOptionChanged);
+
     // Toggle frame list visibility
     connect(m_toggleFrameListBtn, &QPushButton::clicked, [this]()
             {
@@ -434,9 +735,9 @@ void MainWindow::updateControls()
     m_positionSlider->setEnabled(canSeek);
 
     // Frame list button states are now handled automatically by signal connections
-    m_removeFrameBtn->setEnabled(m_frameList->currentRow() >= 0);
-    m_exportFramesBtn->setEnabled(m_frameList->count() > 0);
-    m_clearFramesBtn->setEnabled(m_frameList->count() > 0);
+    m_removeFrameBtn->setEnabled(m_frameList->currentIndex().isValid());
+    m_exportFramesBtn->setEnabled(m_frameListModel->rowCount() > 0);
+    m_clearFramesBtn->setEnabled(m_frameListModel->rowCount() > 0);
 }
 
 void MainWindow::openVideo()
@@ -464,11 +765,11 @@ void MainWindow::openVideo()
         // Update file path display
         updateFilePathDisplay(fileName);
 
-        // Set up dual output: video widget for display and video sink for frame capture
-        m_mediaPlayer->setVideoOutput(m_videoDisplay);
-        // Note: In Qt6, we can't easily have dual outputs, so we'll use a different approach
+        // Set up dual output: capture sink receives frames and forwards them to the video widget
+        m_mediaPlayer->setVideoOutput(m_frameCaptureSink);
 
         m_mediaPlayer->setSource(QUrl::fromLocalFile(fileName));
+        startFrameIndexing(fileName);
         statusBar()->showMessage("Loaded: " + QFileInfo(fileName).fileName(), 3000);
         updateControls();
     }
@@ -480,7 +781,7 @@ void MainWindow::openVideo()
 
 void MainWindow::saveCurrentFrame()
 {
-    qint64 saveStart = QDateTime::currentMSecsSinceEpoch();
+    TRACE_SCOPE_WARN("saveCurrentFrame", "capture", 5);
     LOG_TRACE("💾 SAVE: saveCurrentFrame() START");
 
     if (m_currentVideoPath.isEmpty())
@@ -489,23 +790,16 @@ void MainWindow::saveCurrentFrame()
         return;
     }
 
+    // Make sure the player is at the frame being shown before capturing it
+    syncPlayerPosition();
+
     // Use the new frame capture implementation
     captureCurrentFrame();
-
-    qint64 duration = QDateTime::currentMSecsSinceEpoch() - saveStart;
-    if (duration > 5)
-    {
-        LOG_WARN("💾 SAVE: saveCurrentFrame() took {}ms (may cause UI lag)", duration);
-    }
-    else
-    {
-        LOG_TRACE("💾 SAVE: saveCurrentFrame() completed in {}ms", duration);
-    }
 }
 
 void MainWindow::playPause()
 {
-    qint64 playPauseStart = QDateTime::currentMSecsSinceEpoch();
+    TRACE_SCOPE_WARN("playPause", "ui", 2);
     LOG_TRACE("⏯️ PLAY: playPause() START - current state: {}", m_isPlaying ? "playing" : "paused");
 
     if (m_isPlaying)
@@ -517,26 +811,19 @@ void MainWindow::playPause()
     }
     else
     {
+        setReviewMode(false);
+        syncPlayerPosition();
         m_mediaPlayer->play();
         m_playPauseBtn->setText("Pause");
         m_isPlaying = true;
+        m_currentFrameIndex = -1; // Playback moves the position under us
         LOG_INFO("▶️ Video playing");
     }
-
-    qint64 duration = QDateTime::currentMSecsSinceEpoch() - playPauseStart;
-    if (duration > 2)
-    {
-        LOG_WARN("⏯️ PLAY: playPause() took {}ms (may cause UI lag)", duration);
-    }
-    else
-    {
-        LOG_TRACE("⏯️ PLAY: playPause() completed in {}ms", duration);
-    }
 }
 
 void MainWindow::nextFrame()
 {
-    qint64 frameStart = QDateTime::currentMSecsSinceEpoch();
+    TRACE_SCOPE_WARN("nextFrame", "seek", 3);
     LOG_TRACE("➡️ FRAME: nextFrame() called");
 
     // Throttle position updates to avoid overwhelming the media player
@@ -548,35 +835,26 @@ void MainWindow::nextFrame()
     }
     m_lastPositionUpdate = currentTime;
 
-    // Jump forward by a larger amount to ensure we hit different frames
-    // Use 100ms jumps instead of 33ms to avoid getting stuck between keyframes
+    // Step exactly one frame using the frame index (falls back to 100ms jumps while indexing)
     qint64 currentPos = m_mediaPlayer->position();
-    qint64 frameTime = 100; // 100ms per step for more reliable frame changes
-    qint64 newPos = qMin(currentPos + frameTime, m_videoDuration);
+    qint64 newPos = steppedPosition(currentPos, 1);
 
     // Only log occasionally to reduce UI overhead during rapid stepping
     static qint64 lastLogTime = 0;
     if (currentTime - lastLogTime > 500)
     { // Log every 500ms max
-        LOG_DEBUG("➡️ FRAME: nextFrame() - current: {}ms, frameTime: {}ms, new: {}ms", currentPos, frameTime, newPos);
+        LOG_DEBUG("➡️ FRAME: nextFrame() - current: {}ms, new: {}ms, frame: {}", currentPos, newPos, m_currentFrameIndex);
         lastLogTime = currentTime;
     }
 
-    // Direct position update without additional timers
-    LOG_TRACE("➡️ FRAME: Setting media player position to {}ms", newPos);
-    m_mediaPlayer->setPosition(newPos);
-
-    qint64 frameEnd = QDateTime::currentMSecsSinceEpoch();
-    qint64 duration = frameEnd - frameStart;
-    if (duration > 3) // Log if frame operation takes more than 3ms
-    {
-        LOG_WARN("➡️ FRAME: nextFrame() took {}ms (may cause UI hangup)", duration);
-    }
+    // Serve from the frame cache when possible, otherwise seek the player
+    LOG_TRACE("➡️ FRAME: Showing frame at {}ms", newPos);
+    showSteppedFrame(newPos, 1);
 }
 
 void MainWindow::previousFrame()
 {
-    qint64 frameStart = QDateTime::currentMSecsSinceEpoch();
+    TRACE_SCOPE_WARN("previousFrame", "seek", 3);
     LOG_TRACE("⬅️ FRAME: previousFrame() called");
 
     // Throttle position updates to avoid overwhelming the media player
@@ -588,50 +866,42 @@ void MainWindow::previousFrame()
     }
     m_lastPositionUpdate = currentTime;
 
-    // Jump backward by a larger amount to ensure we hit different frames
+    // Step exactly one frame using the frame index (falls back to 100ms jumps while indexing)
     qint64 currentPos = m_mediaPlayer->position();
-    qint64 frameTime = 100; // 100ms per step for more reliable frame changes
-    qint64 newPos = qMax(currentPos - frameTime, 0LL);
+    qint64 newPos = steppedPosition(currentPos, -1);
 
     // Only log occasionally to reduce UI overhead during rapid stepping
     static qint64 lastLogTime = 0;
     if (currentTime - lastLogTime > 500)
     { // Log every 500ms max
-        LOG_DEBUG("⬅️ FRAME: previousFrame() - current: {}ms, frameTime: {}ms, new: {}ms", currentPos, frameTime, newPos);
+        LOG_DEBUG("⬅️ FRAME: previousFrame() - current: {}ms, new: {}ms, frame: {}", currentPos, newPos, m_currentFrameIndex);
         lastLogTime = currentTime;
     }
 
-    // Direct position update without additional timers
-    LOG_TRACE("⬅️ FRAME: Setting media player position to {}ms", newPos);
-    m_mediaPlayer->setPosition(newPos);
-
-    qint64 frameEnd = QDateTime::currentMSecsSinceEpoch();
-    qint64 duration = frameEnd - frameStart;
-    if (duration > 3) // Log if frame operation takes more than 3ms
-    {
-        LOG_WARN("⬅️ FRAME: previousFrame() took {}ms (may cause UI hangup)", duration);
-    }
+    // Serve from the frame cache when possible, otherwise seek the player
+    LOG_TRACE("⬅️ FRAME: Showing frame at {}ms", newPos);
+    showSteppedFrame(newPos, -1);
 }
 
 void MainWindow::seekToPosition(int position)
 {
-    qint64 seekStart = QDateTime::currentMSecsSinceEpoch();
+    TRACE_SCOPE_WARN("seekToPosition", "seek", 3);
     LOG_TRACE("🎯 SEEK: seekToPosition() START - position: {}ms", position);
 
-    m_mediaPlayer->setPosition(position);
+    // Snap to the start of the frame under the slider so the player lands on a real frame
+    m_playerSyncTimer->stop();
+    qint64 targetPos = position;
+    m_currentFrameIndex = -1;
+    if (m_frameIndex.isValid())
+    {
+        m_currentFrameIndex = m_frameIndex.frameAtTime(position);
+        targetPos = m_frameIndex.timestampMs(m_currentFrameIndex);
+    }
+    PerfStats::seekRequested();
+    m_mediaPlayer->setPosition(targetPos);
 
     // Ensure main window gets focus back after slider interaction
     setFocus();
-
-    qint64 duration = QDateTime::currentMSecsSinceEpoch() - seekStart;
-    if (duration > 3)
-    {
-        LOG_WARN("🎯 SEEK: seekToPosition() took {}ms (may cause UI stutter)", duration);
-    }
-    else
-    {
-        LOG_TRACE("🎯 SEEK: seekToPosition() completed in {}ms", duration);
-    }
 }
 
 void MainWindow::onPositionChanged(qint64 position)
@@ -641,10 +911,9 @@ void MainWindow::onPositionChanged(qint64 position)
     bool shouldUpdateUI = (currentTime - m_lastUIUpdate > 300);
 
     // Update slider position less frequently to reduce UI overhead
-    if (shouldUpdateUI && !m_positionSlider->isSliderDown())
+    if (shouldUpdateUI)
     {
-        m_positionSlider->setValue(static_cast<int>(position));
-        m_timeLabel->setText(formatTime(position));
+        updatePositionDisplay(position);
         m_lastUIUpdate = currentTime;
     }
 
@@ -659,25 +928,15 @@ void MainWindow::onPositionChanged(qint64 position)
 
 void MainWindow::onDurationChanged(qint64 duration)
 {
-    qint64 durationStart = QDateTime::currentMSecsSinceEpoch();
+    TRACE_SCOPE_WARN("onDurationChanged", "ui", 3);
     LOG_TRACE("⏱️ DURATION: onDurationChanged() START - duration: {}ms ({})", duration, formatTime(duration).toStdString());
 
     m_videoDuration = duration;
     m_positionSlider->setRange(0, static_cast<int>(duration));
+    m_sharpnessSparkline->setDuration(duration);
     m_durationLabel->setText(formatTime(duration));
     // Update controls when duration is set - this enables frame navigation buttons
     updateControls();
-
-    qint64 durationEnd = QDateTime::currentMSecsSinceEpoch();
-    qint64 elapsed = durationEnd - durationStart;
-    if (elapsed > 3)
-    {
-        LOG_WARN("⏱️ DURATION: onDurationChanged() took {}ms (may cause UI lag)", elapsed);
-    }
-    else
-    {
-        LOG_TRACE("⏱️ DURATION: onDurationChanged() completed in {}ms", elapsed);
-    }
 }
 
 void MainWindow::onMediaStatusChanged(QMediaPlayer::MediaStatus status)
@@ -774,23 +1033,44 @@ void MainWindow::onMediaError(QMediaPlayer::Error error, const QString &errorStr
 
 void MainWindow::removeSelectedFrame()
 {
-    int currentRow = m_frameList->currentRow();
-    if (currentRow >= 0)
+    QModelIndex current = m_frameList->currentIndex();
+    if (current.isValid())
     {
-        delete m_frameList->takeItem(currentRow);
-        m_frameCountLabel->setText(QString("Frames: %1").arg(m_frameList->count()));
+        m_frameListModel->removeRow(current.row());
+        m_frameCountLabel->setText(QString("Frames: %1").arg(m_frameListModel->rowCount()));
         // NOTE: Removed updateControls() - the rowsRemoved signal will handle this automatically
     }
 }
 
 void MainWindow::exportSelectedFrames()
 {
-    if (m_frameList->count() == 0)
+    // The export button doubles as the cancel button while an export runs
+    if (m_batchExporter->isRunning())
+    {
+        m_batchExporter->cancel();
+        m_exportFramesBtn->setEnabled(false);
+        statusBar()->showMessage("Cancelling export...");
+        return;
+    }
+
+    if (m_frameListModel->rowCount() == 0)
     {
         QMessageBox::information(this, "Information", "No frames to export.");
         return;
     }
 
+    if (isQueueBusy())
+    {
+        QMessageBox::information(this, "Export", "A multi-video extraction is still running.");
+        return;
+    }
+
+    if (!m_frameIndex.isValid())
+    {
+        QMessageBox::information(this, "Export", "The video is still being indexed. Please try again in a moment.");
+        return;
+    }
+
     // Create output directory if it doesn't exist
     QDir outputDir(m_outputDirectory);
     if (!outputDir.exists())
@@ -798,16 +1078,291 @@ void MainWindow::exportSelectedFrames()
         outputDir.mkpath(".");
     }
 
-    // In a real implementation, you would export the actual captured frames
-    QMessageBox::information(this, "Export",
-                             QString("Would export %1 frames to:\n%2")
-                                 .arg(m_frameList->count())
-                                 .arg(m_outputDirectory));
+    QList<qint64> timestamps = m_frameListModel->timestamps();
+    std::sort(timestamps.begin(), timestamps.end());
+    timestamps.erase(std::unique(timestamps.begin(), timestamps.end()), timestamps.end());
+
+    QVector<BatchExporter::Item> items;
+    items.reserve(timestamps.size());
+    for (qint64 timestamp : timestamps)
+    {
+        items.append({timestamp, outputDir.absoluteFilePath(generateFrameFilename(timestamp))});
+    }
+    startBatchExport(items);
+}
+
+void MainWindow::startBatchExport(const QVector<BatchExporter::Item> &items)
+{
+    LOG_INFO("Exporting {} frames to {}", items.size(), m_outputDirectory.toStdString());
+    m_batchExporter->setJob(m_currentVideoPath, m_frameIndex, items, m_encoderSettings);
+    m_batchExporter->setManifest(m_captureManifest);
+
+    m_progressBar->setRange(0, items.size());
+    m_progressBar->setValue(0);
+    m_progressBar->setFormat("%v/%m");
+    m_progressBar->setVisible(true);
+    m_exportFramesBtn->setText("Cancel Export");
+    m_exportFramesBtn->setEnabled(true);
+    m_batchExporter->start();
+}
+
+void MainWindow::onExportProgress(int done, int total, double decodeFps, double encodeFps)
+{
+    // Progress arrives from several encoder threads; ignore reports that were overtaken
+    if (done < m_progressBar->value())
+        return;
+
+    m_progressBar->setMaximum(total);
+    m_progressBar->setValue(done);
+    m_progressBar->setFormat(QString("%v/%m - decode %1 / encode %2 frames/s")
+                                 .arg(decodeFps, 0, 'f', 1)
+                                 .arg(encodeFps, 0, 'f', 1));
+}
+
+void MainWindow::onExportFinished(int written, int failed, bool cancelled)
+{
+    m_progressBar->setVisible(false);
+    m_exportFramesBtn->setText("Export All");
+    m_exportFramesBtn->setEnabled(m_frameListModel->rowCount() > 0);
+    m_progressBar->setValue(0);
+
+    QString summary = QString("Exported %1 frames to %2").arg(written).arg(m_outputDirectory);
+    if (failed > 0)
+    {
+        summary += QString(" (%1 not written)").arg(failed);
+    }
+    if (cancelled)
+    {
+        summary = "Export cancelled - " + summary;
+    }
+    statusBar()->showMessage(summary, 5000);
+    if (written > 0)
+    {
+        refreshHashIndex();
+    }
+
+    if (failed > 0 && !cancelled)
+    {
+        QMessageBox::warning(this, "Export", summary + ".\nSee the log for details.");
+    }
+}
+
+void MainWindow::setInPoint()
+{
+    if (m_currentVideoPath.isEmpty())
+        return;
+
+    // The frame on screen; the player's position trails cached stepping
+    m_inPoint = m_currentFrameIndex >= 0 ? m_frameIndex.timestampMs(m_currentFrameIndex) : m_mediaPlayer->position();
+    if (m_outPoint >= 0 && m_outPoint < m_inPoint)
+    {
+        m_outPoint = -1;
+    }
+    LOG_INFO("In point set to {}ms", m_inPoint);
+    updateTimelineMarkers();
+    statusBar()->showMessage(QString("In point: %1").arg(formatTime(m_inPoint)), 2000);
+}
+
+void MainWindow::setOutPoint()
+{
+    if (m_currentVideoPath.isEmpty())
+        return;
+
+    m_outPoint = m_currentFrameIndex >= 0 ? m_frameIndex.timestampMs(m_currentFrameIndex) : m_mediaPlayer->position();
+    if (m_inPoint >= 0 && m_inPoint > m_outPoint)
+    {
+        m_inPoint = -1;
+    }
+    LOG_INFO("Out point set to {}ms", m_outPoint);
+    updateTimelineMarkers();
+    statusBar()->showMessage(QString("Out point: %1").arg(formatTime(m_outPoint)), 2000);
+}
+
+void MainWindow::clearInOutPoints()
+{
+    m_inPoint = -1;
+    m_outPoint = -1;
+    updateTimelineMarkers();
+    statusBar()->showMessage("In/out points cleared", 2000);
+}
+
+void MainWindow::extractRange()
+{
+    if (m_currentVideoPath.isEmpty())
+    {
+        QMessageBox::information(this, "Extract Range", "Open a video first.");
+        return;
+    }
+    if (!m_frameIndex.isValid())
+    {
+        QMessageBox::information(this, "Extract Range", "The video is still being indexed. Please try again in a moment.");
+        return;
+    }
+    if (m_batchExporter->isRunning() || isQueueBusy())
+    {
+        QMessageBox::information(this, "Extract Range", "An export is already running.");
+        return;
+    }
+
+    qint64 rangeStart = m_inPoint >= 0 ? m_inPoint : 0;
+    qint64 rangeEnd = m_outPoint >= 0 ? m_outPoint : m_frameIndex.timestampMs(m_frameIndex.frameCount() - 1);
+    int firstFrame = m_frameIndex.frameAtTime(rangeStart);
+    int lastFrame = m_frameIndex.frameAtTime(rangeEnd);
+
+    QSettings settings;
+    QStringList modes = {"Every N frames", "Every X milliseconds"};
+    bool ok;
+    QString mode = QInputDialog::getItem(this, "Extract Range",
+                                         QString("Sample %1 - %2 (%3 frames):")
+                                             .arg(formatTime(rangeStart))
+                                             .arg(formatTime(rangeEnd))
+                                             .arg(lastFrame - firstFrame + 1),
+                                         modes, settings.value("extractRange/mode", 0).toInt(), false, &ok);
+    if (!ok)
+        return;
+
+    bool byFrames = mode == modes[0];
+    QString key = byFrames ? "extractRange/everyFrames" : "extractRange/everyMs";
+    int step = QInputDialog::getInt(this, "Extract Range", byFrames ? "Extract every Nth frame, N:" : "Extract a frame every X ms, X:",
+                                    settings.value(key, byFrames ? 10 : 1000).toInt(), 1, 1000000, 1, &ok);
+    if (!ok)
+        return;
+
+    settings.setValue("extractRange/mode", modes.indexOf(mode));
+    settings.setValue(key, step);
+
+    // Sample frame indices, then name each file after its frame's timestamp
+    QVector<int> frames = m_frameIndex.sampleFrames(rangeStart, rangeEnd, byFrames ? step : 0, byFrames ? 0 : step);
+
+    QDir outputDir(m_outputDirectory);
+    if (!outputDir.exists())
+    {
+        outputDir.mkpath(".");
+    }
+
+    QVector<BatchExporter::Item> items;
+    items.reserve(frames.size());
+    for (int frame : frames)
+    {
+        qint64 timestamp = m_frameIndex.timestampMs(frame);
+        items.append({timestamp, outputDir.absoluteFilePath(generateFrameFilename(timestamp))});
+    }
+
+    LOG_INFO("Extracting {} frames between {}ms and {}ms, one every {}{}", items.size(), rangeStart, rangeEnd,
+             step, byFrames ? " frames" : "ms");
+    startBatchExport(items);
+}
+
+void MainWindow::extractMultipleVideos()
+{
+    if (isQueueBusy())
+    {
+        QMessageBox::StandardButton reply = QMessageBox::question(this, "Extract from Multiple Videos",
+                                                                  "An extraction is running. Cancel it?",
+                                                                  QMessageBox::Yes | QMessageBox::No);
+        if (reply == QMessageBox::Yes)
+        {
+            m_extractionQueue->cancel();
+            statusBar()->showMessage("Cancelling extraction...");
+        }
+        return;
+    }
+    if (m_batchExporter->isRunning())
+    {
+        QMessageBox::information(this, "Extract from Multiple Videos", "An export is already running.");
+        return;
+    }
+
+    QSettings settings;
+    QString startDir = m_lastVideoPath.isEmpty() ? QDir::homePath() : QFileInfo(m_lastVideoPath).absolutePath();
+    QStringList videos = QFileDialog::getOpenFileNames(this, "Extract from Multiple Videos", startDir,
+                                                       "Video Files (*.mp4 *.avi *.mov *.mkv *.wmv *.flv *.webm)");
+    if (videos.isEmpty())
+        return;
+
+    QStringList modes = {"Every N frames", "Every X milliseconds"};
+    bool ok;
+    QString mode = QInputDialog::getItem(this, "Extract from Multiple Videos",
+                                         QString("Sample each of the %1 videos:").arg(videos.size()),
+                                         modes, settings.value("extractRange/mode", 0).toInt(), false, &ok);
+    if (!ok)
+        return;
+
+    bool byFrames = mode == modes[0];
+    QString key = byFrames ? "extractRange/everyFrames" : "extractRange/everyMs";
+    int step = QInputDialog::getInt(this, "Extract from Multiple Videos", byFrames ? "Extract every Nth frame, N:" : "Extract a frame every X ms, X:",
+                                    settings.value(key, byFrames ? 10 : 1000).toInt(), 1, 1000000, 1, &ok);
+    if (!ok)
+        return;
+
+    settings.setValue("extractRange/mode", modes.indexOf(mode));
+    settings.setValue(key, step);
+
+    // Each video keeps its own file name prefix, so all of them can share the output directory
+    ExtractionJob job;
+    job.outputDirectory = m_outputDirectory;
+    job.encoder = m_encoderSettings;
+    job.everyFrames = byFrames ? step : 0;
+    job.everyMs = byFrames ? 0 : step;
+    for (const QString &video : videos)
+    {
+        job.videoPath = video;
+        m_extractionQueue->addJob(job);
+    }
+
+    LOG_INFO("Queued {} videos for extraction, one frame every {}{}", videos.size(), step, byFrames ? " frames" : "ms");
+    m_progressBar->setRange(0, 0);
+    m_progressBar->setFormat("Indexing...");
+    m_progressBar->setVisible(true);
+    m_extractVideosAction->setText("Cancel &Multi-Video Extraction...");
+}
+
+bool MainWindow::isQueueBusy() const
+{
+    ExtractionQueue::Stats stats = m_extractionQueue->stats();
+    return stats.jobsWaiting + stats.jobsActive > 0;
+}
+
+void MainWindow::onQueueProgress()
+{
+    ExtractionQueue::Stats stats = m_extractionQueue->stats();
+    if (stats.framesTotal == 0)
+        return;
+
+    m_progressBar->setRange(0, stats.framesTotal);
+    m_progressBar->setValue(stats.framesWritten + stats.framesFailed);
+    m_progressBar->setFormat(QString("%v/%m - video %1/%2, %3 decoding")
+                                 .arg(stats.jobsFinished)
+                                 .arg(stats.jobsWaiting + stats.jobsActive + stats.jobsFinished)
+                                 .arg(stats.decoders));
+}
+
+void MainWindow::onQueueFinished()
+{
+    ExtractionQueue::Stats stats = m_extractionQueue->stats();
+    m_progressBar->setVisible(false);
+    m_progressBar->setRange(0, 100);
+    m_progressBar->setValue(0);
+    m_extractVideosAction->setText("Extract from &Multiple Videos...");
+
+    QString summary = QString("Extracted %1 frames from %2 videos to %3")
+                          .arg(stats.framesWritten)
+                          .arg(stats.jobsFinished)
+                          .arg(m_outputDirectory);
+    if (stats.framesFailed > 0)
+    {
+        summary += QString(" (%1 not written)").arg(stats.framesFailed);
+    }
+    statusBar()->showMessage(summary, 5000);
+    if (stats.framesWritten > 0)
+    {
+        refreshHashIndex();
+    }
 }
 
 void MainWindow::clearSelectedFrames()
 {
-    if (m_frameList->count() > 0)
+    if (m_frameListModel->rowCount() > 0)
     {
         QMessageBox::StandardButton reply = QMessageBox::question(this,
                                                                   "Clear Frames", "Are you sure you want to clear all selected frames?",
@@ -815,7 +1370,7 @@ void MainWindow::clearSelectedFrames()
 
         if (reply == QMessageBox::Yes)
         {
-            m_frameList->clear();
+            m_frameListModel->clear();
             m_frameCountLabel->setText("Frames: 0");
             // NOTE: Removed updateControls() - the rowsRemoved signal will handle this automatically
         }
@@ -826,21 +1381,17 @@ void MainWindow::addFrameToList(const QString &framePath, qint64 timestamp)
 {
     QString displayText = QString("%1 - %2")
                               .arg(formatTime(timestamp))
-                              .arg(QFileInfo(framePath).fileName());
-
-    QListWidgetItem *item = new QListWidgetItem(displayText);
-    item->setData(Qt::UserRole, framePath);
-    item->setData(Qt::UserRole + 1, timestamp);
+                              .arg(QFileInfo(framePath).completeBaseName());
 
-    m_frameList->addItem(item);
-    m_frameCountLabel->setText(QString("Frames: %1").arg(m_frameList->count()));
+    m_frameListModel->append(framePath, timestamp, displayText);
+    m_frameCountLabel->setText(QString("Frames: %1").arg(m_frameListModel->rowCount()));
     // NOTE: Removed updateControls() - frame list changes don't affect media controls, only list-specific buttons
-    // The list selection change signal will handle enabling/disabling remove button automatically
+    // The model's rowsInserted signal will handle enabling/disabling the list buttons automatically
 }
 
 void MainWindow::keyPressEvent(QKeyEvent *event)
 {
-    qint64 keyStart = QDateTime::currentMSecsSinceEpoch();
+    TRACE_SCOPE_WARN("keyPressEvent", "ui", 2);
     LOG_TRACE("⌨️ KEY: keyPressEvent() START - key={}, modifiers={}, repeat={}", event->key(), event->modifiers(), event->isAutoRepeat());
 
     if (!m_currentVideoPath.isEmpty() && m_videoDuration > 0)
@@ -872,7 +1423,9 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
 
                 previousFrame();
                 m_isSteppingBackward = true;
+                m_readAheadDecoder->setHeldDirection(-1);
                 m_stepInterval = 200;         // Increased from 150ms to 200ms for more conservative stepping
+                m_stepWaitTicks = 0;
                 m_frameStepTimer->start(500); // Increased initial delay from 400ms to 500ms
                 LOG_DEBUG("Started backward frame stepping");
             }
@@ -904,7 +1457,9 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
 
                 nextFrame();
                 m_isSteppingForward = true;
+                m_readAheadDecoder->setHeldDirection(1);
                 m_stepInterval = 200;         // Increased from 150ms to 200ms for more conservative stepping
+                m_stepWaitTicks = 0;
                 m_frameStepTimer->start(500); // Increased initial delay from 400ms to 500ms
                 LOG_DEBUG("Started forward frame stepping");
             }
@@ -925,6 +1480,59 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
                 event->accept();
                 return;
             }
+            if (event->modifiers() == Qt::NoModifier)
+            {
+                snapToSharpestFrame();
+                event->accept();
+                return;
+            }
+            break;
+
+        case Qt::Key_I:
+            if (event->modifiers() == Qt::NoModifier)
+            {
+                setInPoint();
+                event->accept();
+                return;
+            }
+            break;
+
+        case Qt::Key_O:
+            if (event->modifiers() == Qt::NoModifier)
+            {
+                setOutPoint();
+                event->accept();
+                return;
+            }
+            break;
+
+        case Qt::Key_BracketLeft:
+            jumpToSceneCut(-1);
+            event->accept();
+            return;
+
+        case Qt::Key_BracketRight:
+            jumpToSceneCut(1);
+            event->accept();
+            return;
+
+        case Qt::Key_Comma:
+            jumpToCapture(-1);
+            event->accept();
+            return;
+
+        case Qt::Key_Period:
+            jumpToCapture(1);
+            event->accept();
+            return;
+
+        case Qt::Key_R:
+            if (event->modifiers() == Qt::NoModifier)
+            {
+                m_reviewCapturesAction->toggle();
+                event->accept();
+                return;
+            }
             break;
         }
     }
@@ -933,16 +1541,6 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
         LOG_DEBUG("Key event ignored - no video loaded or invalid duration");
     }
 
-    qint64 duration = QDateTime::currentMSecsSinceEpoch() - keyStart;
-    if (duration > 2)
-    {
-        LOG_WARN("⌨️ KEY: keyPressEvent() took {}ms (may cause UI lag)", duration);
-    }
-    else
-    {
-        LOG_TRACE("⌨️ KEY: keyPressEvent() completed in {}ms", duration);
-    }
-
     QMainWindow::keyPressEvent(event);
 }
 
@@ -959,6 +1557,8 @@ void MainWindow::keyReleaseEvent(QKeyEvent *event)
             m_frameStepTimer->stop();
             m_isSteppingBackward = false;
             m_stepInterval = 200; // Reset interval for next time
+            m_readAheadDecoder->setHeldDirection(0);
+            logFrameCacheStats();
             event->accept();
             return;
         }
@@ -971,6 +1571,8 @@ void MainWindow::keyReleaseEvent(QKeyEvent *event)
             m_frameStepTimer->stop();
             m_isSteppingForward = false;
             m_stepInterval = 200; // Reset interval for next time
+            m_readAheadDecoder->setHeldDirection(0);
+            logFrameCacheStats();
             event->accept();
             return;
         }
@@ -1000,10 +1602,19 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
 
 void MainWindow::onFrameStepTimer()
 {
-    qint64 timerStart = QDateTime::currentMSecsSinceEpoch();
+    TRACE_SCOPE_WARN("onFrameStepTimer", "ui", 5);
     LOG_TRACE("⏰ TIMER: onFrameStepTimer() START - forward: {}, backward: {}, interval: {}ms",
               m_isSteppingForward, m_isSteppingBackward, m_stepInterval);
 
+    // Wait for the read-ahead thread, but not forever: the player can seek to frames libav can't decode
+    bool waiting = (m_isSteppingForward && !canStepFromCache(1)) || (m_isSteppingBackward && !canStepFromCache(-1));
+    if (waiting && ++m_stepWaitTicks <= kMaxStepWaitTicks)
+    {
+        LOG_TRACE("⏰ TIMER: {} frame not decoded yet - holding", m_isSteppingForward ? "Next" : "Previous");
+        return;
+    }
+    m_stepWaitTicks = 0;
+
     if (m_isSteppingForward)
     {
         LOG_TRACE("⏰ TIMER: Calling nextFrame() from timer");
@@ -1033,17 +1644,456 @@ void MainWindow::onFrameStepTimer()
         LOG_DEBUG("⏰ TIMER: Frame step timer - stopping (no active stepping)");
         m_frameStepTimer->stop();
     }
+}
+
+void MainWindow::startFrameIndexing(const QString &videoPath)
+{
+    cancelFrameIndexing();
+    m_frameIndex = FrameIndex();
+    m_currentFrameIndex = -1;
+    m_inPoint = -1;
+    m_outPoint = -1;
+    stopSceneDetection();
+    setReviewMode(false);
+
+    // Markers of the new video come straight from its manifest
+    openCaptureManifest();
+
+    // Frames cached for the previous video are useless now
+    m_readAheadDecoder->closeVideo();
+    m_frameCache.clear();
+    m_sharpnessSparkline->setFrameIndex(FrameIndex());
+
+    auto cancelled = std::make_shared<std::atomic_bool>(false);
+    m_frameIndexCancel = cancelled;
+
+    LOG_INFO("Building frame index for: {}", videoPath.toStdString());
+    m_frameIndexWatcher->setFuture(QtConcurrent::run([videoPath, cancelled]()
+                                                     { return FrameIndex::build(videoPath, cancelled.get()); }));
+}
+
+void MainWindow::cancelFrameIndexing()
+{
+    if (m_frameIndexCancel)
+    {
+        m_frameIndexCancel->store(true);
+    }
+}
+
+void MainWindow::onFrameIndexReady()
+{
+    // Ignore stale results from a scan that was superseded by another video
+    if (!m_frameIndexWatcher->isFinished() || (m_frameIndexCancel && m_frameIndexCancel->load()))
+    {
+        return;
+    }
+
+    m_frameIndex = m_frameIndexWatcher->result();
+    m_currentFrameIndex = -1;
+
+    if (m_frameIndex.isValid())
+    {
+        statusBar()->showMessage(QString("Indexed %1 frames (%2 fps)")
+                                     .arg(m_frameIndex.frameCount())
+                                     .arg(m_frameIndex.averageFrameRate(), 0, 'f', 2),
+                                 3000);
+        m_readAheadDecoder->openVideo(m_currentVideoPath, m_frameIndex);
+        m_sharpnessSparkline->setFrameIndex(m_frameIndex);
+        openCaptureDecoder();
+        startSceneDetection();
+    }
+    else
+    {
+        LOG_WARN("Frame index unavailable - frame stepping falls back to 100ms jumps");
+    }
+}
+
+void MainWindow::startSceneDetection()
+{
+    stopSceneDetection();
+    if (!m_detectScenesAction->isChecked() || !m_frameIndex.isValid())
+        return;
+
+    // One detector per pass; a superseded pass finishes in the background and deletes itself
+    m_sceneDetector = new SceneDetector(this);
+    connect(m_sceneDetector, &SceneDetector::cutsFound, this, &MainWindow::onSceneCutsFound);
+    connect(m_sceneDetector, &SceneDetector::analysisFinished, this, &MainWindow::onSceneAnalysisFinished);
+    connect(m_sceneDetector, &QThread::finished, m_sceneDetector, &QObject::deleteLater);
+    m_sceneDetector->setJob(m_currentVideoPath, m_frameIndex);
+    m_sceneDetector->start(QThread::LowPriority);
+}
+
+void MainWindow::stopSceneDetection()
+{
+    if (m_sceneDetector)
+    {
+        m_sceneDetector->cancel();
+        m_sceneDetector = nullptr;
+    }
+    m_sceneCuts.clear();
+    if (m_positionSlider)
+    {
+        m_positionSlider->clearMarkers(m_sceneCutMarkerLayer);
+    }
+}
+
+void MainWindow::onSceneCutsFound(const QVector<qint64> &timestamps)
+{
+    // Ignore batches still queued from a pass that was stopped
+    if (sender() != m_sceneDetector)
+        return;
+
+    m_sceneCuts += timestamps;
+    m_positionSlider->appendMarkers(m_sceneCutMarkerLayer, timestamps);
+}
+
+void MainWindow::onSceneAnalysisFinished(int cuts, double framesPerSecond, bool cancelled)
+{
+    if (sender() != m_sceneDetector || cancelled)
+        return;
+
+    m_sceneDetector = nullptr;
+    statusBar()->showMessage(QString("Found %1 scene cut(s), analysed at %2 frames/s - [ and ] jump between them")
+                                 .arg(cuts)
+                                 .arg(framesPerSecond, 0, 'f', 0),
+                             4000);
+}
+
+void MainWindow::jumpToSceneCut(int direction)
+{
+    if (m_sceneCuts.isEmpty())
+    {
+        statusBar()->showMessage(m_sceneDetector ? "Scene analysis is still running" : "No scene cuts found", 2000);
+        return;
+    }
+
+    qint64 current = m_currentFrameIndex >= 0 ? m_frameIndex.timestampMs(m_currentFrameIndex) : m_mediaPlayer->position();
+    qint64 target = -1;
+    if (direction > 0)
+    {
+        auto it = std::upper_bound(m_sceneCuts.cbegin(), m_sceneCuts.cend(), current);
+        if (it != m_sceneCuts.cend())
+            target = *it;
+    }
+    else
+    {
+        auto it = std::lower_bound(m_sceneCuts.cbegin(), m_sceneCuts.cend(), current);
+        if (it != m_sceneCuts.cbegin())
+            target = *(it - 1);
+    }
+
+    if (target < 0)
+    {
+        statusBar()->showMessage(direction > 0 ? "No later scene cut" : "No earlier scene cut", 2000);
+        return;
+    }
+
+    int cut = static_cast<int>(std::lower_bound(m_sceneCuts.cbegin(), m_sceneCuts.cend(), target) - m_sceneCuts.cbegin());
+    seekToPosition(static_cast<int>(target));
+    updatePositionDisplay(target);
+    statusBar()->showMessage(QString("Scene cut %1 of %2 at %3").arg(cut + 1).arg(m_sceneCuts.size()).arg(formatTime(target)), 2000);
+}
+
+int MainWindow::captureIndexFrom(int direction) const
+{
+    const QList<qint64> &captures = m_existingFrameTimestamps;
+    qint64 current = m_currentFrameIndex >= 0 ? m_frameIndex.timestampMs(m_currentFrameIndex) : m_mediaPlayer->position();
+
+    // A capture's timestamp can fall anywhere inside its frame; compare frames so a jump never lands where it started
+    auto sameFrame = [this](qint64 timestamp)
+    {
+        return m_currentFrameIndex >= 0 && m_frameIndex.frameAtTime(timestamp) == m_currentFrameIndex;
+    };
+
+    if (direction > 0)
+    {
+        auto it = std::upper_bound(captures.cbegin(), captures.cend(), current);
+        while (it != captures.cend() && sameFrame(*it))
+            ++it;
+        return it != captures.cend() ? static_cast<int>(it - captures.cbegin()) : -1;
+    }
+
+    auto it = std::lower_bound(captures.cbegin(), captures.cend(), current);
+    while (it != captures.cbegin() && sameFrame(*(it - 1)))
+        --it;
+    return it != captures.cbegin() ? static_cast<int>(it - captures.cbegin()) - 1 : -1;
+}
+
+bool MainWindow::jumpToCapture(int direction)
+{
+    if (m_existingFrameTimestamps.isEmpty())
+    {
+        statusBar()->showMessage("No captured frames of this video in the output directory", 2000);
+        return false;
+    }
+
+    int capture = captureIndexFrom(direction);
+    if (capture < 0)
+    {
+        statusBar()->showMessage(direction > 0 ? "No later captured frame" : "No earlier captured frame", 2000);
+        return false;
+    }
+
+    showCapture(capture, direction);
+    return true;
+}
+
+void MainWindow::showCapture(int capture, int direction)
+{
+    if (m_isPlaying)
+    {
+        m_mediaPlayer->pause();
+        m_playPauseBtn->setText("Play");
+        m_isPlaying = false;
+    }
 
-    qint64 timerEnd = QDateTime::currentMSecsSinceEpoch();
-    qint64 duration = timerEnd - timerStart;
-    if (duration > 5) // Log if timer takes more than 5ms
+    qint64 target = m_existingFrameTimestamps[capture];
+    if (m_frameIndex.isValid())
     {
-        LOG_WARN("⏰ TIMER: onFrameStepTimer() took {}ms (may cause UI hangup)", duration);
+        // Prefetched captures are already in the frame cache, so this is usually just a blit
+        m_currentFrameIndex = m_frameIndex.frameAtTime(target);
+        showSteppedFrame(m_frameIndex.timestampMs(m_currentFrameIndex), direction);
+
+        // Decode the captures on either side next, the one in the direction of travel first
+        QVector<int> targets;
+        for (int offset : {direction, -direction, 2 * direction})
+        {
+            int neighbour = capture + offset;
+            if (neighbour >= 0 && neighbour < m_existingFrameTimestamps.size())
+                targets.append(m_frameIndex.frameAtTime(m_existingFrameTimestamps[neighbour]));
+        }
+        m_readAheadDecoder->setPrefetchTargets(targets);
     }
     else
     {
-        LOG_TRACE("⏰ TIMER: onFrameStepTimer() completed in {}ms", duration);
+        seekToPosition(static_cast<int>(target));
+        updatePositionDisplay(target);
+    }
+
+    statusBar()->showMessage(QString("%1 %2 of %3 at %4")
+                                 .arg(m_reviewTimer->isActive() ? "Reviewing capture" : "Capture")
+                                 .arg(capture + 1)
+                                 .arg(m_existingFrameTimestamps.size())
+                                 .arg(formatTime(target)),
+                             m_reviewTimer->isActive() ? 0 : 2000);
+}
+
+void MainWindow::setReviewMode(bool enabled)
+{
+    if (enabled && (m_currentVideoPath.isEmpty() || m_existingFrameTimestamps.isEmpty()))
+    {
+        statusBar()->showMessage("No captured frames of this video to review", 2000);
+        enabled = false;
+    }
+
+    if (m_reviewCapturesAction->isChecked() != enabled)
+    {
+        QSignalBlocker blocker(m_reviewCapturesAction);
+        m_reviewCapturesAction->setChecked(enabled);
+    }
+
+    if (!enabled)
+    {
+        if (m_reviewTimer->isActive())
+        {
+            m_reviewTimer->stop();
+            statusBar()->clearMessage();
+        }
+        return;
+    }
+
+    // Carry on from the playhead, or start over once past the last capture
+    m_reviewTimer->start();
+    int capture = captureIndexFrom(1);
+    showCapture(capture >= 0 ? capture : 0, 1);
+    LOG_INFO("Reviewing {} captures, {}ms each", m_existingFrameTimestamps.size(), m_reviewTimer->interval());
+}
+
+void MainWindow::onReviewTimer()
+{
+    int capture = captureIndexFrom(1);
+    if (capture < 0)
+    {
+        setReviewMode(false);
+        statusBar()->showMessage("Reviewed all captured frames", 3000);
+        return;
+    }
+    showCapture(capture, 1);
+}
+
+void MainWindow::snapToSharpestFrame()
+{
+    if (!m_frameIndex.isValid())
+    {
+        statusBar()->showMessage("Snap to sharpest needs the frame index - still indexing", 2000);
+        return;
+    }
+    if (m_sharpnessWatcher->isRunning())
+        return;
+
+    m_snapCentre = m_currentFrameIndex >= 0 ? m_currentFrameIndex : m_frameIndex.frameAtTime(m_mediaPlayer->position());
+    int radius = m_snapRadiusSpin->value();
+
+    // Frames the read-ahead decoder has seen are already scored; decode the rest in one forward sweep
+    QVector<int> unscored = m_sharpnessTrack.unscoredFrames(m_snapCentre - radius, m_snapCentre + radius);
+    if (unscored.isEmpty())
+    {
+        finishSharpnessSnap();
+        return;
     }
+
+    LOG_DEBUG("Sharpness: scoring {} frames around frame {}", unscored.size(), m_snapCentre);
+    statusBar()->showMessage(QString("Scoring %1 frames...").arg(unscored.size()));
+    m_snapVideoPath = m_currentVideoPath;
+    FrameIndex index = m_frameIndex;
+    QString videoPath = m_currentVideoPath;
+    m_sharpnessWatcher->setFuture(QtConcurrent::run([videoPath, index, unscored]()
+                                                    {
+        ScoredFrames scores;
+        VideoDecoder decoder;
+        if (!decoder.open(videoPath, index))
+            return scores;
+        decoder.decodeFrames(unscored, [&scores](int frameIndex, const QImage &image)
+                             {
+            scores.append({frameIndex, SharpnessMetrics::compute(image)});
+            return true; });
+        return scores; }));
+}
+
+void MainWindow::onSharpnessScored()
+{
+    // Scores of a video that has since been closed belong to nobody
+    if (m_snapVideoPath != m_currentVideoPath || !m_frameIndex.isValid())
+        return;
+
+    for (const auto &scored : m_sharpnessWatcher->result())
+    {
+        m_sharpnessTrack.set(scored.first, scored.second);
+    }
+
+    // Don't yank the playhead back if the user stepped away while scoring
+    if (m_currentFrameIndex >= 0 && m_currentFrameIndex != m_snapCentre)
+    {
+        statusBar()->clearMessage();
+        return;
+    }
+    finishSharpnessSnap();
+}
+
+void MainWindow::finishSharpnessSnap()
+{
+    int radius = m_snapRadiusSpin->value();
+    int best = m_sharpnessTrack.sharpestFrame(m_snapCentre - radius, m_snapCentre + radius, m_snapCentre);
+    if (best < 0)
+    {
+        statusBar()->showMessage("Could not score the frames around the playhead", 3000);
+        return;
+    }
+
+    SharpnessMetrics::Score score = m_sharpnessTrack.score(best);
+    int offset = best - m_snapCentre;
+    LOG_DEBUG("Sharpness: frame {} (Laplacian variance {:.1f}, gradient energy {:.1f}), {:+d} from frame {}",
+              best, score.laplacianVariance, score.gradientEnergy, offset, m_snapCentre);
+    if (offset == 0)
+    {
+        statusBar()->showMessage(QString("Already on the sharpest frame within ±%1").arg(radius), 2000);
+        return;
+    }
+
+    m_currentFrameIndex = best;
+    showSteppedFrame(m_frameIndex.timestampMs(best), offset > 0 ? 1 : -1);
+    statusBar()->showMessage(QString("Snapped %1%2 frames to the sharpest within ±%3")
+                                 .arg(offset > 0 ? "+" : "")
+                                 .arg(offset)
+                                 .arg(radius),
+                             2000);
+}
+
+qint64 MainWindow::steppedPosition(qint64 currentPos, int frameDelta)
+{
+    if (!m_frameIndex.isValid())
+    {
+        // Use 100ms jumps instead of 33ms to avoid getting stuck between keyframes
+        return qBound<qint64>(0, currentPos + frameDelta * 100, m_videoDuration);
+    }
+
+    // Continue from the frame we last stepped to; the player's position lags behind seeks
+    int current = m_currentFrameIndex >= 0 ? m_currentFrameIndex : m_frameIndex.frameAtTime(currentPos);
+    m_currentFrameIndex = qBound(0, current + frameDelta, m_frameIndex.frameCount() - 1);
+    return m_frameIndex.timestampMs(m_currentFrameIndex);
+}
+
+void MainWindow::showSteppedFrame(qint64 position, int direction)
+{
+    TRACE_SCOPE("showSteppedFrame", "seek");
+    PerfStats::seekRequested();
+    QImage image;
+    if (m_currentFrameIndex >= 0 && m_frameCache.lookup(m_currentFrameIndex, &image))
+    {
+        // Blit the cached frame straight into the video widget; the player catches up once stepping stops
+        m_frameCache.setCenter(m_currentFrameIndex);
+        // Going through the capture sink keeps Ctrl+S in sync with the blitted frame
+        QVideoFrame frame = videoFrameFromImage(image);
+        frame.setStartTime(m_frameIndex.timestampMs(m_currentFrameIndex) * 1000);
+        m_frameCaptureSink->setVideoFrame(frame);
+        updatePositionDisplay(position);
+        m_playerSyncTimer->start();
+
+        m_readAheadDecoder->setPlayhead(m_currentFrameIndex, direction);
+        return;
+    }
+
+    m_playerSyncTimer->stop();
+    m_mediaPlayer->setPosition(position);
+
+    if (m_currentFrameIndex >= 0)
+    {
+        m_frameCache.setCenter(m_currentFrameIndex);
+        m_readAheadDecoder->setPlayhead(m_currentFrameIndex, direction);
+    }
+}
+
+bool MainWindow::canStepFromCache(int direction) const
+{
+    // Without an index (or a known current frame) there is nothing to prefetch against,
+    // and without an open decoder nothing will ever arrive; the player seeks instead
+    if (!m_frameIndex.isValid() || m_currentFrameIndex < 0 || !m_readAheadDecoder->isVideoOpen())
+        return true;
+    return m_frameCache.contains(m_currentFrameIndex + direction);
+}
+
+void MainWindow::updatePositionDisplay(qint64 position)
+{
+    if (m_positionSlider->isSliderDown())
+        return;
+
+    // Block valueChanged so tracking the playhead doesn't trigger another seek
+    QSignalBlocker blocker(m_positionSlider);
+    m_positionSlider->setValue(static_cast<int>(position));
+    m_timeLabel->setText(formatTime(position));
+}
+
+void MainWindow::syncPlayerPosition()
+{
+    if (!m_playerSyncTimer->isActive())
+        return;
+
+    TRACE_SCOPE("syncPlayerPosition", "seek");
+
+    m_playerSyncTimer->stop();
+    if (m_frameIndex.isValid() && m_currentFrameIndex >= 0)
+    {
+        LOG_TRACE("Syncing player to cached frame {}", m_currentFrameIndex);
+        m_mediaPlayer->setPosition(m_frameIndex.timestampMs(m_currentFrameIndex));
+    }
+}
+
+void MainWindow::logFrameCacheStats()
+{
+    FrameCache::Stats stats = m_frameCache.stats();
+    LOG_DEBUG("Frame cache: {} hits, {} misses, {} frames, {}MB cached, lookahead {} frames",
+              stats.hits, stats.misses, stats.frames, stats.bytes / (1024 * 1024),
+              m_readAheadDecoder->lookaheadDepth());
 }
 
 QString MainWindow::formatTime(qint64 milliseconds)
@@ -1071,25 +2121,7 @@ QString MainWindow::formatTime(qint64 milliseconds)
 
 QString MainWindow::extractFilenamePrefix(const QString &videoPath)
 {
-    QFileInfo fileInfo(videoPath);
-    QString baseName = fileInfo.baseName(); // Gets filename without extension
-
-    // Check if it looks like a YouTube ID (11 characters followed by underscore)
-    if (baseName.length() >= 12 && baseName.at(11) == '_')
-    {
-        QString potentialYouTubeId = baseName.left(11);
-        // YouTube IDs are alphanumeric with possible dashes and underscores
-        QRegularExpression youtubeIdPattern("^[A-Za-z0-9_-]{11}$");
-        if (youtubeIdPattern.match(potentialYouTubeId).hasMatch())
-        {
-            LOG_INFO("Detected YouTube ID format: {}", potentialYouTubeId.toStdString());
-            return potentialYouTubeId;
-        }
-    }
-
-    // Fallback: use the full filename (without extension) as prefix
-    LOG_INFO("Using full filename as prefix: {}", baseName.toStdString());
-    return baseName;
+    return FrameFilename::prefixForVideo(videoPath);
 }
 
 void MainWindow::setDefaultFilenamePrefix(const QString &videoPath)
@@ -1192,6 +2224,57 @@ void MainWindow::loadSettings()
         LOG_INFO("Will auto-extract filename prefix from video file, skipping saved prefix");
     }
 
+    // Load capture method
+    QString captureMethod = settings.value("captureMethod", captureMethodName(m_frameCaptureMethod)).toString();
+    if (captureMethod == captureMethodName(CAPTURE_FFMPEG) && m_ffmpegAvailable)
+    {
+        m_frameCaptureMethod = CAPTURE_FFMPEG;
+    }
+    else if (captureMethod == captureMethodName(CAPTURE_QT_SINK))
+    {
+        m_frameCaptureMethod = CAPTURE_QT_SINK;
+    }
+
+    // Load frame cache limits
+    int cacheFrames = settings.value("frameCache/maxFrames", 120).toInt();
+    int cacheMegabytes = settings.value("frameCache/maxMegabytes", 512).toInt();
+    m_frameCache.setLimits(cacheFrames, static_cast<qint64>(cacheMegabytes) * 1024 * 1024);
+    LOG_INFO("Frame cache limits: {} frames, {}MB", cacheFrames, cacheMegabytes);
+
+    // Load image format and encoder options
+    m_encoderSettings.format = ImageEncoder::formatFromName(settings.value("imageFormat", "PNG").toString());
+    m_encoderSettings.pngCompressionLevel = qBound(0, settings.value("encoder/pngCompressionLevel", m_encoderSettings.pngCompressionLevel).toInt(), 9);
+    m_encoderSettings.pngFilter = static_cast<PngEncoder::Filter>(
+        qBound(0, settings.value("encoder/pngFilter", static_cast<int>(m_encoderSettings.pngFilter)).toInt(), static_cast<int>(PngEncoder::Filter::Adaptive)));
+    m_encoderSettings.jpegQuality = qBound(1, settings.value("encoder/jpegQuality", m_encoderSettings.jpegQuality).toInt(), 100);
+    m_encoderSettings.jpegSubsampling = static_cast<JpegEncoder::Subsampling>(
+        qBound(0, settings.value("encoder/jpegSubsampling", static_cast<int>(m_encoderSettings.jpegSubsampling)).toInt(), static_cast<int>(JpegEncoder::Subsampling::S420)));
+    int formatIndex = m_imageFormatCombo->findData(static_cast<int>(m_encoderSettings.format));
+    if (formatIndex < 0)
+    {
+        // Saved format not writable by this build (e.g. no webp plugin)
+        formatIndex = 0;
+        m_encoderSettings.format = static_cast<ImageEncoder::Format>(m_imageFormatCombo->itemData(0).toInt());
+    }
+    {
+        QSignalBlocker blocker(m_imageFormatCombo);
+        m_imageFormatCombo->setCurrentIndex(formatIndex);
+    }
+    updateEncoderControls();
+    LOG_INFO("Image format: {}", ImageEncoder::formatName(m_encoderSettings.format).toStdString());
+
+    // Load near-duplicate handling
+    m_duplicatePolicy = static_cast<FrameWriter::DuplicatePolicy>(
+        qBound(0, settings.value("duplicates/mode", static_cast<int>(m_duplicatePolicy)).toInt(), static_cast<int>(FrameWriter::DuplicatePolicy::Skip)));
+    m_duplicateThreshold = qBound(0, settings.value("duplicates/threshold", m_duplicateThreshold).toInt(), 32);
+    {
+        QSignalBlocker modeBlocker(m_duplicateModeCombo);
+        QSignalBlocker thresholdBlocker(m_duplicateThresholdSpin);
+        m_duplicateModeCombo->setCurrentIndex(m_duplicateModeCombo->findData(static_cast<int>(m_duplicatePolicy)));
+        m_duplicateThresholdSpin->setValue(m_duplicateThreshold);
+        m_duplicateThresholdSpin->setEnabled(m_duplicatePolicy != FrameWriter::DuplicatePolicy::Keep);
+    }
+
     // Load window geometry
     QByteArray geometry = settings.value("geometry").toByteArray();
     if (!geometry.isEmpty())
@@ -1229,12 +2312,34 @@ void MainWindow::saveSettings()
         LOG_INFO("Saved filename prefix: {}", prefix.toStdString());
     }
 
+    // Save capture method
+    settings.setValue("captureMethod", captureMethodName(m_frameCaptureMethod));
+
+    // Save frame cache limits
+    settings.setValue("frameCache/maxFrames", m_frameCache.maxFrames());
+    settings.setValue("frameCache/maxMegabytes", m_frameCache.maxBytes() / (1024 * 1024));
+
+    // Save image format and encoder options
+    settings.setValue("imageFormat", ImageEncoder::formatName(m_encoderSettings.format));
+    settings.setValue("encoder/pngCompressionLevel", m_encoderSettings.pngCompressionLevel);
+    settings.setValue("encoder/pngFilter", static_cast<int>(m_encoderSettings.pngFilter));
+    settings.setValue("encoder/jpegQuality", m_encoderSettings.jpegQuality);
+    settings.setValue("encoder/jpegSubsampling", static_cast<int>(m_encoderSettings.jpegSubsampling));
+    settings.setValue("duplicates/mode", static_cast<int>(m_duplicatePolicy));
+    settings.setValue("duplicates/threshold", m_duplicateThreshold);
+
     // Save window geometry
     settings.setValue("geometry", saveGeometry());
     LOG_INFO("Saved window geometry");
 }
 
 QString MainWindow::generateFrameFilename()
+{
+    // Name the frame after the current video position in milliseconds
+    return generateFrameFilename(m_mediaPlayer ? m_mediaPlayer->position() : 0);
+}
+
+QString MainWindow::generateFrameFilename(qint64 videoPosition)
 {
     QString prefix = "frame";
     if (m_filenamePrefixEdit)
@@ -1246,19 +2351,87 @@ QString MainWindow::generateFrameFilename()
         }
     }
 
-    // Get current video position in milliseconds
-    qint64 videoPosition = m_mediaPlayer ? m_mediaPlayer->position() : 0;
+    return FrameFilename::generate(prefix, videoPosition, m_encoderSettings.format);
+}
 
-    // Use millisecond precision instead of seconds for better uniqueness
-    // Format: {prefix}_{milliseconds}.png
-    // This provides much better precision for frame-by-frame captures
-    return QString("%1_%2.png")
-        .arg(prefix)
-        .arg(videoPosition);
+void MainWindow::updateEncoderControls()
+{
+    QSignalBlocker spinBlocker(m_encoderLevelSpin);
+    QSignalBlocker comboBlocker(m_encoderModeCombo);
+    m_encoderModeCombo->clear();
+
+    switch (m_encoderSettings.format)
+    {
+    case ImageEncoder::Format::PNG:
+        m_encoderLevelLabel->setText("Level:");
+        m_encoderLevelSpin->setRange(0, 9);
+        m_encoderLevelSpin->setValue(m_encoderSettings.pngCompressionLevel);
+        m_encoderLevelSpin->setToolTip("zlib compression level: 0 is fastest, 9 is smallest");
+        for (PngEncoder::Filter filter : {PngEncoder::Filter::None, PngEncoder::Filter::Sub, PngEncoder::Filter::Up,
+                                          PngEncoder::Filter::Paeth, PngEncoder::Filter::Adaptive})
+        {
+            m_encoderModeCombo->addItem(ImageEncoder::pngFilterName(filter), static_cast<int>(filter));
+        }
+        m_encoderModeCombo->setCurrentIndex(m_encoderModeCombo->findData(static_cast<int>(m_encoderSettings.pngFilter)));
+        m_encoderModeCombo->setToolTip("PNG scanline filter");
+        break;
+    case ImageEncoder::Format::JPEG:
+        m_encoderLevelLabel->setText("Quality:");
+        m_encoderLevelSpin->setRange(1, 100);
+        m_encoderLevelSpin->setValue(m_encoderSettings.jpegQuality);
+        m_encoderLevelSpin->setToolTip("JPEG quality");
+        for (JpegEncoder::Subsampling subsampling : {JpegEncoder::Subsampling::S444, JpegEncoder::Subsampling::S422,
+                                                     JpegEncoder::Subsampling::S420})
+        {
+            m_encoderModeCombo->addItem(ImageEncoder::subsamplingName(subsampling), static_cast<int>(subsampling));
+        }
+        m_encoderModeCombo->setCurrentIndex(m_encoderModeCombo->findData(static_cast<int>(m_encoderSettings.jpegSubsampling)));
+        m_encoderModeCombo->setToolTip(JpegEncoder::isAvailable() ? "Chroma subsampling"
+                                                                  : "Chroma subsampling (needs libjpeg-turbo; Qt's encoder ignores it)");
+        break;
+    default:
+        // WebP is always lossless; QOI, BMP and TIFF have no options
+        break;
+    }
+
+    bool hasOptions = m_encoderSettings.format == ImageEncoder::Format::PNG || m_encoderSettings.format == ImageEncoder::Format::JPEG;
+    m_encoderModeCombo->setEnabled(m_encoderSettings.format != ImageEncoder::Format::JPEG || JpegEncoder::isAvailable());
+    m_encoderLevelLabel->setVisible(hasOptions);
+    m_encoderLevelSpin->setVisible(hasOptions);
+    m_encoderModeCombo->setVisible(hasOptions);
+}
+
+void MainWindow::onImageFormatChanged(int index)
+{
+    if (index < 0)
+        return;
+
+    m_encoderSettings.format = static_cast<ImageEncoder::Format>(m_imageFormatCombo->itemData(index).toInt());
+    updateEncoderControls();
+    LOG_INFO("Image format changed to: {}", ImageEncoder::formatName(m_encoderSettings.format).toStdString());
+}
+
+void MainWindow::onEncoderOptionChanged()
+{
+    int mode = m_encoderModeCombo->currentData().toInt();
+    switch (m_encoderSettings.format)
+    {
+    case ImageEncoder::Format::PNG:
+        m_encoderSettings.pngCompressionLevel = m_encoderLevelSpin->value();
+        m_encoderSettings.pngFilter = static_cast<PngEncoder::Filter>(mode);
+        break;
+    case ImageEncoder::Format::JPEG:
+        m_encoderSettings.jpegQuality = m_encoderLevelSpin->value();
+        m_encoderSettings.jpegSubsampling = static_cast<JpegEncoder::Subsampling>(mode);
+        break;
+    default:
+        break;
+    }
 }
 
 void MainWindow::captureCurrentFrame()
 {
+    TRACE_SCOPE("captureCurrentFrame", "capture");
     if (!m_mediaPlayer || m_mediaPlayer->playbackState() == QMediaPlayer::StoppedState)
     {
         LOG_ERROR("Cannot capture frame: no video loaded or player stopped");
@@ -1266,10 +2439,13 @@ void MainWindow::captureCurrentFrame()
     }
 
     LOG_INFO("Attempting to capture current frame using method: {}",
-             m_frameCaptureMethod == CAPTURE_FFMPEG ? "FFmpeg" : "Qt Sink");
+             captureMethodName(m_frameCaptureMethod).toStdString());
 
     switch (m_frameCaptureMethod)
     {
+    case CAPTURE_LIBAV:
+        captureCurrentFrameLibav();
+        break;
     case CAPTURE_FFMPEG:
         captureCurrentFrameFFmpeg();
         break;
@@ -1303,92 +2479,310 @@ bool MainWindow::checkFFmpegAvailable()
     return available;
 }
 
-void MainWindow::captureCurrentFrameQt()
+QString MainWindow::captureMethodName(FrameCaptureMethod method) const
 {
-    LOG_INFO("Using Qt sink capture method");
+    switch (method)
+    {
+    case CAPTURE_LIBAV:
+        return "libav";
+    case CAPTURE_FFMPEG:
+        return "FFmpeg";
+    case CAPTURE_QT_SINK:
+    default:
+        return "Qt Sink";
+    }
+}
 
-    // Generate filename with current prefix
-    QString filename = generateFrameFilename();
-    QString fullPath = QDir(m_outputDirectory).absoluteFilePath(filename);
+void MainWindow::openCaptureDecoder()
+{
+    QString videoPath = m_currentVideoPath;
+    FrameIndex index = m_frameIndex;
+
+    // Open eagerly so the first capture doesn't pay for probing the container
+    m_captureDecodePool->start([this, videoPath, index]()
+                               {
+        if (!m_captureDecoder)
+            m_captureDecoder = std::make_unique<VideoDecoder>();
+        m_captureDecoder->open(videoPath, index); });
+}
 
-    QPixmap framePixmap;
+void MainWindow::captureCurrentFrameLibav()
+{
+    LOG_INFO("Using libav capture method");
 
-    // Try to capture from frame capture sink
-    if (m_frameCaptureSink)
+    if (!m_frameIndex.isValid())
     {
-        QVideoFrame currentFrame = m_frameCaptureSink->getCurrentFrame();
-        LOG_INFO("Frame capture sink exists, current frame valid: {}", currentFrame.isValid());
+        LOG_WARN("Frame index not ready yet - falling back to Qt sink capture");
+        captureCurrentFrameQt();
+        return;
+    }
 
-        if (currentFrame.isValid())
-        {
-            LOG_INFO("Capturing frame from video sink, size: {}x{}, format: {}",
-                     currentFrame.size().width(), currentFrame.size().height(),
-                     (int)currentFrame.pixelFormat());
+    // Refuse up front rather than decoding a frame the writer can't take
+    if (m_frameWriter->inFlight() >= m_frameWriter->maxInFlight())
+    {
+        statusBar()->showMessage("Save queue full - frame not saved", 2000);
+        return;
+    }
 
-            // Convert QVideoFrame to QImage
-            QVideoFrame mappedFrame = currentFrame;
-            mappedFrame.map(QVideoFrame::ReadOnly);
+    int frameIndex = m_currentFrameIndex >= 0 ? m_currentFrameIndex : m_frameIndex.frameAtTime(m_mediaPlayer->position());
 
-            QImage frameImage = mappedFrame.toImage();
+    // Name and stamp the file after the decoded frame; the player lags behind cached stepping
+    qint64 position = m_frameIndex.timestampMs(frameIndex);
+    QString filename = generateFrameFilename(position);
+    QString fullPath = QDir(m_outputDirectory).absoluteFilePath(filename);
 
-            if (!frameImage.isNull())
-            {
-                // Ensure proper color format - convert to RGB32 if needed for consistent output
-                if (frameImage.format() != QImage::Format_RGB32 && frameImage.format() != QImage::Format_ARGB32)
-                {
-                    LOG_INFO("Converting image format from {} to RGB32", (int)frameImage.format());
-                    frameImage = frameImage.convertToFormat(QImage::Format_RGB32);
-                }
+    // A frame already in the stepping cache costs nothing to capture
+    FrameWriter::Job job{QVideoFrame(), QImage(), fullPath, position, m_encoderSettings};
+    job.frameNumber = frameIndex;
+    // Bound to this video now; the decode may finish after another one has been opened
+    job.manifest = m_captureManifest;
+    job.pts = m_frameIndex.entry(frameIndex).pts;
+    if (m_frameCache.lookup(frameIndex, &job.image))
+    {
+        enqueueFrameWrite(job);
+        return;
+    }
 
-                framePixmap = QPixmap::fromImage(frameImage);
-                LOG_INFO("Successfully converted video frame to pixmap, size: {}x{}, image format: {}",
-                         framePixmap.width(), framePixmap.height(), (int)frameImage.format());
+    QString videoPath = m_currentVideoPath;
+    FrameIndex index = m_frameIndex;
+
+    m_captureDecodePool->start([this, videoPath, index, frameIndex, job]() mutable
+                               {
+        if (!m_captureDecoder)
+            m_captureDecoder = std::make_unique<VideoDecoder>();
+        if (!m_captureDecoder->isOpen() || m_captureDecoder->videoPath() != videoPath)
+            m_captureDecoder->open(videoPath, index);
+        job.image = m_captureDecoder->decodeFrame(frameIndex);
+
+        QMetaObject::invokeMethod(this, [this, job, frameIndex, videoPath]()
+                                  {
+            if (videoPath != m_currentVideoPath)
+            {
+                LOG_INFO("libav capture: dropped frame {}, {} was closed while it decoded", frameIndex, videoPath.toStdString());
+                return;
             }
-            else
+            if (job.image.isNull())
             {
-                LOG_ERROR("Failed to convert video frame to image");
+                LOG_ERROR("libav capture: failed to decode frame {}", frameIndex);
+                statusBar()->showMessage("libav frame capture failed", 3000);
+                return;
             }
+            enqueueFrameWrite(job); }, Qt::QueuedConnection); });
+}
 
-            mappedFrame.unmap();
-        }
-        else
-        {
-            LOG_ERROR("No valid frame available from capture sink");
-        }
+void MainWindow::captureCurrentFrameQt()
+{
+    LOG_INFO("Using Qt sink capture method");
+
+    // Grab the displayed frame by reference; conversion and encoding happen on the writer pool
+    QVideoFrame frame;
+    if (m_frameCaptureSink)
+    {
+        frame = m_frameCaptureSink->getCurrentFrame();
+        LOG_INFO("Frame capture sink exists, current frame valid: {}", frame.isValid());
+    }
+
+    // File the capture under the frame on screen; the player's position trails cached stepping
+    qint64 position = m_mediaPlayer->position();
+    if (frame.isValid() && frame.startTime() >= 0)
+    {
+        position = frame.startTime() / 1000;
+    }
+    else if (m_frameIndex.isValid() && m_currentFrameIndex >= 0)
+    {
+        position = m_frameIndex.timestampMs(m_currentFrameIndex);
+    }
+
+    // Generate filename with current prefix
+    QString filename = generateFrameFilename(position);
+    QString fullPath = QDir(m_outputDirectory).absoluteFilePath(filename);
+
+    FrameWriter::Job job{frame, QImage(), fullPath, position, m_encoderSettings};
+    if (m_frameIndex.isValid())
+    {
+        job.frameNumber = m_frameIndex.frameAtTime(position);
     }
 
     // Fallback to placeholder if frame capture failed
-    if (framePixmap.isNull())
+    if (!job.frame.isValid())
     {
         LOG_INFO("Using placeholder image - Qt frame capture failed");
-        framePixmap = QPixmap(800, 600);
-        framePixmap.fill(Qt::darkGray);
+        job.image = QImage(800, 600, QImage::Format_RGB32);
+        job.image.fill(Qt::darkGray);
 
-        QPainter painter(&framePixmap);
+        QPainter painter(&job.image);
         painter.setPen(Qt::white);
         painter.setFont(QFont("Arial", 16));
-        painter.drawText(framePixmap.rect(), Qt::AlignCenter,
+        painter.drawText(job.image.rect(), Qt::AlignCenter,
                          QString("Qt Frame capture failed\nPosition: %1ms\nTry playing the video first")
-                             .arg(m_mediaPlayer->position()));
+                             .arg(position));
+    }
+    else
+    {
+        LOG_INFO("Capturing frame from video sink, size: {}x{}, format: {}",
+                 job.frame.size().width(), job.frame.size().height(),
+                 (int)job.frame.pixelFormat());
     }
 
-    if (framePixmap.save(fullPath))
+    enqueueFrameWrite(job);
+}
+
+void MainWindow::enqueueFrameWrite(const FrameWriter::Job &job)
+{
+    FrameWriter::Job checked = job;
+    checked.hashIndex = &m_hashIndex;
+    checked.duplicates = m_duplicatePolicy;
+    checked.duplicateThreshold = m_duplicateThreshold;
+    if (!checked.manifest)
+    {
+        checked.manifest = m_captureManifest;
+    }
+    if (m_frameIndex.isValid() && checked.pts < 0)
     {
-        LOG_INFO("Frame saved to: {}", fullPath.toStdString());
+        if (checked.frameNumber < 0)
+            checked.frameNumber = m_frameIndex.frameAtTime(checked.timestamp);
+        if (checked.frameNumber >= 0 && checked.frameNumber < m_frameIndex.frameCount())
+            checked.pts = m_frameIndex.entry(checked.frameNumber).pts;
+    }
+    if (!m_frameWriter->enqueue(checked))
+    {
+        statusBar()->showMessage("Save queue full - frame not saved", 2000);
+    }
+}
 
-        // Add to frame list using just the filename (without extension for display)
-        QFileInfo fileInfo(filename);
-        addFrameToList(fileInfo.baseName(), m_mediaPlayer->position());
+void MainWindow::onFrameWritten(const QString &path, qint64 timestamp, bool success)
+{
+    QString filename = QFileInfo(path).fileName();
+    if (success)
+    {
+        LOG_INFO("Frame saved to: {}", path.toStdString());
 
-        statusBar()->showMessage(QString("Frame saved: %1").arg(filename), 3000);
+        // The list shows the name without extension next to a thumbnail of the file
+        addFrameToList(path, timestamp);
+        if (QFileInfo(path).absolutePath() == m_frameDirectoryIndex->directory())
+        {
+            m_frameDirectoryIndex->addFile(filename);
+        }
+
+        QString similar = m_duplicateWarnings.take(path);
+        if (similar.isEmpty())
+            statusBar()->showMessage(QString("Frame saved: %1").arg(filename), 3000);
+        else
+            statusBar()->showMessage(QString("Frame saved: %1 - looks like %2").arg(filename, similar), 5000);
     }
     else
     {
-        LOG_ERROR("Failed to save frame to: {}", fullPath.toStdString());
+        LOG_ERROR("Failed to save frame to: {}", path.toStdString());
+        m_duplicateWarnings.remove(path);
         statusBar()->showMessage("Failed to save frame", 3000);
     }
 }
 
+void MainWindow::onDuplicateFound(const QString &path, qint64 timestamp, const QString &existingFile, int distance, bool skipped)
+{
+    if (skipped)
+    {
+        LOG_INFO("Skipped frame at {}ms: {} bits from {}", timestamp, distance, existingFile.toStdString());
+        statusBar()->showMessage(QString("Not saved - near-duplicate of %1 (%2 bits apart)").arg(existingFile).arg(distance), 5000);
+        return;
+    }
+    // Shown once the save completes, so the "Frame saved" message doesn't hide it
+    m_duplicateWarnings.insert(path, existingFile);
+}
+
+void MainWindow::onDuplicateOptionChanged()
+{
+    m_duplicatePolicy = static_cast<FrameWriter::DuplicatePolicy>(m_duplicateModeCombo->currentData().toInt());
+    m_duplicateThreshold = m_duplicateThresholdSpin->value();
+    m_duplicateThresholdSpin->setEnabled(m_duplicatePolicy != FrameWriter::DuplicatePolicy::Keep);
+    saveSettings();
+}
+
+void MainWindow::refreshHashIndex()
+{
+    // A running pass stops between two frames; the new one starts when it has
+    m_hashIndexReload = true;
+    m_hashIndexPendingFiles.clear();
+    if (m_hashIndexCancel)
+    {
+        m_hashIndexCancel->store(true);
+    }
+    startHashIndexWork();
+}
+
+void MainWindow::indexFrameFile(const QString &path)
+{
+    // A pending full pass picks the file up anyway, and frames outside the output directory aren't indexed
+    QFileInfo info(path);
+    if (m_hashIndexReload || info.absolutePath() != QDir(m_outputDirectory).absolutePath())
+        return;
+    m_hashIndexPendingFiles.append(info.fileName());
+    startHashIndexWork();
+}
+
+void MainWindow::startHashIndexWork()
+{
+    if (m_hashIndexWatcher->isRunning())
+        return;
+    if (!m_hashIndexReload && m_hashIndexPendingFiles.isEmpty())
+        return;
+
+    auto cancelled = std::make_shared<std::atomic_bool>(false);
+    m_hashIndexCancel = cancelled;
+    FrameHashIndex *index = &m_hashIndex;
+    QString directory = QDir(m_outputDirectory).absolutePath();
+
+    if (!m_hashIndexReload)
+    {
+        // Frames saved one at a time outside the frame writer (FFmpeg capture)
+        QStringList fileNames = m_hashIndexPendingFiles;
+        m_hashIndexPendingFiles.clear();
+        m_hashIndexWatcher->setFuture(QtConcurrent::run([index, directory, fileNames, cancelled]()
+                                                        {
+            if (index->directory() != directory)
+                return;
+            QDir dir(directory);
+            for (const QString &fileName : fileNames)
+            {
+                if (cancelled->load())
+                    break;
+                QImage image = QImageReader(dir.filePath(fileName)).read();
+                if (!image.isNull())
+                    index->add(fileName, PerceptualHash::dHash(image));
+            } }));
+        return;
+    }
+    m_hashIndexReload = false;
+
+    // Frames written without the index (batch exports, older versions) are hashed here
+    m_hashIndexWatcher->setFuture(QtConcurrent::run([index, directory, cancelled]()
+                                                    {
+        if (index->directory() != directory && !index->open(directory, cancelled.get()))
+            return;
+
+        QDir dir(directory);
+        int added = 0;
+        for (const QString &fileName : dir.entryList(FrameFilename::imageNameFilters(), QDir::Files))
+        {
+            if (cancelled->load())
+                break;
+            if (index->contains(fileName))
+                continue;
+            QImage image = QImageReader(dir.filePath(fileName)).read();
+            if (image.isNull())
+                continue;
+            index->add(fileName, PerceptualHash::dHash(image));
+            ++added;
+        }
+        LOG_INFO("Hash index: {} frames indexed, {} newly hashed", index->size(), added); }));
+}
+
+void MainWindow::onSaveQueueChanged(int inFlight)
+{
+    m_saveQueueLabel->setText(QString("Saving: %1").arg(inFlight));
+    m_saveQueueLabel->setVisible(inFlight > 0);
+}
+
 void MainWindow::captureCurrentFrameFFmpeg()
 {
     LOG_INFO("Using FFmpeg capture method");
@@ -1399,21 +2793,54 @@ void MainWindow::captureCurrentFrameFFmpeg()
         return;
     }
 
+    // The frame on screen; the player's position trails cached stepping
+    qint64 position = m_mediaPlayer->position();
+    if (m_frameIndex.isValid() && m_currentFrameIndex >= 0)
+    {
+        position = m_frameIndex.timestampMs(m_currentFrameIndex);
+    }
+
     // Generate filename with current prefix
-    QString filename = generateFrameFilename();
+    QString filename = generateFrameFilename(position);
     QString fullPath = QDir(m_outputDirectory).absoluteFilePath(filename);
 
     // Get current position in seconds for ffmpeg
-    double currentSeconds = m_mediaPlayer->position() / 1000.0;
+    double currentSeconds = position / 1000.0;
 
     // Create ffmpeg command to extract frame at current position
     QStringList arguments;
     arguments << "-ss" << QString::number(currentSeconds, 'f', 3) // Seek to position
               << "-i" << m_currentVideoPath                       // Input file
-              << "-frames:v" << "1"                               // Extract 1 frame
-              << "-q:v" << "2"                                    // High quality
-              << "-y"                                             // Overwrite output
-              << fullPath;                                        // Output file
+              << "-frames:v" << "1";                              // Extract 1 frame
+
+    // Mirror the selected encoder options with ffmpeg's own encoders
+    switch (m_encoderSettings.format)
+    {
+    case ImageEncoder::Format::PNG:
+    {
+        static const char *predictors[] = {"none", "sub", "up", "paeth", "mixed"};
+        arguments << "-compression_level" << QString::number(m_encoderSettings.pngCompressionLevel)
+                  << "-pred" << predictors[static_cast<int>(m_encoderSettings.pngFilter)];
+        break;
+    }
+    case ImageEncoder::Format::JPEG:
+    {
+        static const char *pixelFormats[] = {"yuvj444p", "yuvj422p", "yuvj420p"};
+        // Map quality 1-100 onto mjpeg's qscale 31-2
+        int qscale = 2 + (100 - m_encoderSettings.jpegQuality) * 29 / 99;
+        arguments << "-q:v" << QString::number(qscale)
+                  << "-pix_fmt" << pixelFormats[static_cast<int>(m_encoderSettings.jpegSubsampling)];
+        break;
+    }
+    case ImageEncoder::Format::WebP:
+        arguments << "-lossless" << "1";
+        break;
+    default:
+        break;
+    }
+
+    arguments << "-y"      // Overwrite output
+              << fullPath; // Output file
 
     LOG_INFO("FFmpeg command: ffmpeg {}", arguments.join(" ").toStdString());
 
@@ -1422,7 +2849,7 @@ void MainWindow::captureCurrentFrameFFmpeg()
 
     // Handle completion
     connect(ffmpegProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            [this, ffmpegProcess, filename, fullPath](int exitCode, QProcess::ExitStatus exitStatus)
+            [this, ffmpegProcess, filename, fullPath, position](int exitCode, QProcess::ExitStatus exitStatus)
             {
                 ffmpegProcess->deleteLater();
 
@@ -1430,9 +2857,8 @@ void MainWindow::captureCurrentFrameFFmpeg()
                 {
                     LOG_INFO("FFmpeg frame saved to: {}", fullPath.toStdString());
 
-                    // Add to frame list using just the filename (without extension for display)
-                    QFileInfo fileInfo(filename);
-                    addFrameToList(fileInfo.baseName(), m_mediaPlayer->position());
+                    addFrameToList(fullPath, position);
+                    indexFrameFile(fullPath);
 
                     statusBar()->showMessage(QString("Frame saved: %1").arg(filename), 3000);
                 }
@@ -1459,34 +2885,22 @@ void MainWindow::captureCurrentFrameFFmpeg()
 
 void MainWindow::scanForExistingFrames()
 {
-    if (m_currentVideoPath.isEmpty() || m_outputDirectory.isEmpty())
-    {
-        LOG_DEBUG("Cannot scan for existing frames: no video or output directory");
+    if (m_currentVideoPath.isEmpty())
         return;
-    }
-
-    LOG_INFO("Scanning for existing frames in: {}", m_outputDirectory.toStdString());
-
-    m_existingFrameTimestamps = parseExistingFrameTimestamps();
-
-    LOG_INFO("Found {} existing frame(s)", m_existingFrameTimestamps.size());
 
-    // Update timeline markers
-    updateTimelineMarkers();
+    refreshExistingFrameMarkers();
+    LOG_INFO("Found {} existing frame(s) in {}", m_existingFrameTimestamps.size(), m_outputDirectory.toStdString());
+    if (!m_existingFrameTimestamps.isEmpty())
+    {
+        statusBar()->showMessage(QString("Found %1 existing frame(s) at various positions").arg(m_existingFrameTimestamps.size()), 3000);
+    }
 }
 
-QList<qint64> MainWindow::parseExistingFrameTimestamps()
+void MainWindow::refreshExistingFrameMarkers()
 {
-    QList<qint64> timestamps;
-    QDir outputDir(m_outputDirectory);
-
-    if (!outputDir.exists())
-    {
-        LOG_DEBUG("Output directory doesn't exist: {}", m_outputDirectory.toStdString());
-        return timestamps;
-    }
+    if (m_currentVideoPath.isEmpty())
+        return;
 
-    // Get current filename prefix
     QString currentPrefix = "frame";
     if (m_filenamePrefixEdit)
     {
@@ -1497,199 +2911,50 @@ QList<qint64> MainWindow::parseExistingFrameTimestamps()
         }
     }
 
-    // Create regex pattern to match our NEW filename format:
-    // prefix_YYYYMMDD_hhmmss_zzz_XXXXms_width_height.ext
-    QString pattern = QString("^%1_(\\d{8})_(\\d{6})_(\\d{3})_(\\d+)ms_(\\d+)_(\\d+)\\.(png|jpg|jpeg|bmp|tiff)$")
-                          .arg(QRegularExpression::escape(currentPrefix));
-    QRegularExpression newFormatRegex(pattern, QRegularExpression::CaseInsensitiveOption);
-
-    // Also support OLD filename format for backward compatibility:
-    // prefix_YYYYMMDD_hhmmss_zzz_width_height.ext
-    QString oldPattern = QString("^%1_(\\d{8})_(\\d{6})_(\\d{3})_(\\d+)_(\\d+)\\.(png|jpg|jpeg|bmp|tiff)$")
-                             .arg(QRegularExpression::escape(currentPrefix));
-    QRegularExpression oldFormatRegex(oldPattern, QRegularExpression::CaseInsensitiveOption);
-
-    // Get all image files in directory
-    QStringList nameFilters;
-    nameFilters << "*.png" << "*.jpg" << "*.jpeg" << "*.bmp" << "*.tiff";
-    QFileInfoList files = outputDir.entryInfoList(nameFilters, QDir::Files);
-
-    LOG_INFO("Scanning directory: {}", m_outputDirectory.toStdString());
-    LOG_INFO("Using prefix: '{}'", currentPrefix.toStdString());
-    LOG_INFO("Found {} image files total", files.size());
-    LOG_DEBUG("New pattern: {}", pattern.toStdString());
-    LOG_DEBUG("Old pattern: {}", oldPattern.toStdString());
-
-    // List all files for debugging
-    for (const QFileInfo &fileInfo : files)
-    {
-        LOG_DEBUG("File found: {}", fileInfo.fileName().toStdString());
-    }
+    // Frames named after the prefix, including ones saved before manifests existed
+    QVector<qint64> timestamps = m_frameDirectoryIndex->timestamps(currentPrefix);
 
-    for (const QFileInfo &fileInfo : files)
+    // Captures recorded for this video under any name; once the listing is in, skip deleted files
+    if (m_captureManifest)
     {
-        QString filename = fileInfo.fileName();
-        LOG_DEBUG("Processing file: {}", filename.toStdString());
-
-        qint64 timestamp = extractTimestampFromFilename(filename);
-
-        if (timestamp >= 0)
-        {
-            timestamps.append(timestamp);
-            LOG_INFO("✓ Found existing frame: {} -> {}ms", filename.toStdString(), timestamp);
-        }
-        else
+        bool listed = m_frameDirectoryIndex->isLoaded();
+        for (const CaptureManifest::Record &record : m_captureManifest->records())
         {
-            LOG_DEBUG("✗ Skipped file (no timestamp): {}", filename.toStdString());
+            if (record.timestampMs >= 0 && (!listed || m_frameDirectoryIndex->contains(record.fileName)))
+                timestamps.append(record.timestampMs);
         }
+        std::sort(timestamps.begin(), timestamps.end());
+        timestamps.erase(std::unique(timestamps.begin(), timestamps.end()), timestamps.end());
     }
 
-    // Sort timestamps
-    std::sort(timestamps.begin(), timestamps.end());
-
-    return timestamps;
+    m_existingFrameTimestamps = timestamps;
+    updateTimelineMarkers();
 }
 
-qint64 MainWindow::extractTimestampFromFilename(const QString &filename)
+void MainWindow::openCaptureManifest()
 {
-    // Get current filename prefix
-    QString currentPrefix = "frame";
-    if (m_filenamePrefixEdit)
-    {
-        QString userPrefix = m_filenamePrefixEdit->text().trimmed();
-        if (!userPrefix.isEmpty())
-        {
-            currentPrefix = userPrefix;
-        }
-    }
-
-    LOG_DEBUG("Extracting timestamp from: '{}' with prefix: '{}'", filename.toStdString(), currentPrefix.toStdString());
-
-    // Try NEW simplified format: prefix_milliseconds.ext
-    QString newPattern = QString("^%1_(\\d+)\\.(png|jpg|jpeg|bmp|tiff)$")
-                             .arg(QRegularExpression::escape(currentPrefix));
-    QRegularExpression newFormatRegex(newPattern, QRegularExpression::CaseInsensitiveOption);
-    QRegularExpressionMatch newMatch = newFormatRegex.match(filename);
-
-    LOG_DEBUG("Testing new simplified format pattern: {}", newPattern.toStdString());
-
-    if (newMatch.hasMatch())
-    {
-        // Extract video position in milliseconds directly
-        qint64 videoPosition = newMatch.captured(1).toLongLong();
-        LOG_INFO("✓ Extracted video position from new format: {}ms", videoPosition);
-        return videoPosition;
-    }
-    else
-    {
-        LOG_DEBUG("✗ New simplified format pattern didn't match");
-    }
-
-    // Try OLD detailed format for backward compatibility: prefix_YYYYMMDD_hhmmss_zzz_XXXXms_width_height.ext
-    QString oldDetailedPattern = QString("^%1_(\\d{8})_(\\d{6})_(\\d{3})_(\\d+)ms_(\\d+)_(\\d+)\\.(png|jpg|jpeg|bmp|tiff)$")
-                                     .arg(QRegularExpression::escape(currentPrefix));
-    QRegularExpression oldDetailedRegex(oldDetailedPattern, QRegularExpression::CaseInsensitiveOption);
-    QRegularExpressionMatch oldDetailedMatch = oldDetailedRegex.match(filename);
-
-    LOG_DEBUG("Testing old detailed format pattern: {}", oldDetailedPattern.toStdString());
-
-    if (oldDetailedMatch.hasMatch())
-    {
-        // Extract video position from the old detailed format
-        qint64 videoPosition = oldDetailedMatch.captured(4).toLongLong();
-        LOG_INFO("✓ Extracted video position from old detailed format: {}ms", videoPosition);
-        return videoPosition;
-    }
-    else
-    {
-        LOG_DEBUG("✗ Old detailed format pattern didn't match");
-    }
-
-    // Try OLD filename format for backward compatibility: prefix_YYYYMMDD_hhmmss_zzz_width_height.ext
-    QString oldPattern = QString("^%1_(\\d{8})_(\\d{6})_(\\d{3})_(\\d+)_(\\d+)\\.(png|jpg|jpeg|bmp|tiff)$")
-                             .arg(QRegularExpression::escape(currentPrefix));
-    QRegularExpression oldFormatRegex(oldPattern, QRegularExpression::CaseInsensitiveOption);
-    QRegularExpressionMatch oldMatch = oldFormatRegex.match(filename);
-
-    LOG_DEBUG("Testing old format pattern: {}", oldPattern.toStdString());
+    // Writers still holding the previous manifest finish appending to it
+    m_captureManifest.reset();
+    if (m_currentVideoPath.isEmpty() || m_outputDirectory.isEmpty())
+        return;
 
-    if (oldMatch.hasMatch())
+    auto manifest = std::make_shared<CaptureManifest>();
+    if (manifest->open(m_outputDirectory, m_currentVideoPath))
     {
-        LOG_INFO("✓ Found old format file (no video position): {}", filename.toStdString());
-        // For old format files, we can't extract video position, so skip them
-        return -1;
+        m_captureManifest = manifest;
     }
     else
     {
-        LOG_DEBUG("✗ Old format pattern didn't match either");
+        LOG_WARN("Captures of {} won't be recorded in a manifest", m_currentVideoPath.toStdString());
     }
-
-    LOG_DEBUG("✗ Filename doesn't match any expected pattern: {}", filename.toStdString());
-    return -1;
 }
 
 void MainWindow::updateTimelineMarkers()
 {
-    if (!m_positionSlider || m_videoDuration <= 0)
-    {
-        LOG_DEBUG("Cannot update timeline markers: invalid slider or duration");
-        return;
-    }
-
-    if (m_existingFrameTimestamps.isEmpty())
-    {
-        LOG_DEBUG("No existing frame timestamps to mark on timeline");
-        // Reset to default slider style
-        m_positionSlider->setStyleSheet("");
+    if (!m_positionSlider)
         return;
-    }
-
-    LOG_INFO("Marking {} existing frames on timeline", m_existingFrameTimestamps.size());
-
-    // Create a simple stylesheet that adds visual indicators
-    // We'll use a custom background with gradient stops at frame positions
-    QString styleSheet = "QSlider::groove:horizontal {"
-                         "border: 1px solid #999999;"
-                         "height: 8px;"
-                         "background: qlineargradient(x1:0, y1:0, x2:1, y2:0";
-
-    // Add gradient stops for existing frames
-    for (int i = 0; i < m_existingFrameTimestamps.size(); ++i)
-    {
-        qint64 timestamp = m_existingFrameTimestamps[i];
-        double position = static_cast<double>(timestamp) / static_cast<double>(m_videoDuration);
-
-        // Clamp position to valid range
-        position = qMax(0.0, qMin(1.0, position));
-
-        // Add a red marker at this position
-        styleSheet += QString(", stop:%1 #ff4444").arg(position, 0, 'f', 4);
-
-        // Add a small range around the marker
-        if (position > 0.002)
-        {
-            styleSheet += QString(", stop:%1 #cccccc").arg(position - 0.002, 0, 'f', 4);
-        }
-        if (position < 0.998)
-        {
-            styleSheet += QString(", stop:%1 #cccccc").arg(position + 0.002, 0, 'f', 4);
-        }
-    }
-
-    styleSheet += ");"
-                  "border-radius: 4px;"
-                  "}"
-                  "QSlider::handle:horizontal {"
-                  "background: #0078d4;"
-                  "border: 1px solid #0078d4;"
-                  "width: 14px;"
-                  "margin: -3px 0;"
-                  "border-radius: 7px;"
-                  "}";
-
-    m_positionSlider->setStyleSheet(styleSheet);
 
-    // Update status bar to show frame count
-    QString message = QString("Found %1 existing frame(s) at various positions").arg(m_existingFrameTimestamps.size());
-    statusBar()->showMessage(message, 3000);
+    LOG_DEBUG("Marking {} existing frames on timeline", m_existingFrameTimestamps.size());
+    m_positionSlider->setMarkers(m_capturedMarkerLayer, m_existingFrameTimestamps);
+    m_positionSlider->setInOutRange(m_inPoint, m_outPoint);
 }
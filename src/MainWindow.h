@@ -7,7 +7,6 @@
 #include <QGridLayout>
 #include <QPushButton>
 #include <QLabel>
-#include <QSlider>
 #include <QSpinBox>
 #include <QFileDialog>
 #include <QMessageBox>
@@ -17,7 +16,7 @@
 #include <QKeySequence>
 #include <QVideoWidget>
 #include <QMediaPlayer>
-#include <QListWidget>
+#include <QListView>
 #include <QSplitter>
 #include <QGroupBox>
 #include <QProgressBar>
@@ -30,8 +29,30 @@
 #include <QSettings>
 #include <QVideoSink>
 #include <QVideoFrame>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
 #include "Logger.h"
 #include "FrameCaptureSink.h"
+#include "FrameIndex.h"
+#include "FrameCache.h"
+#include "ReadAheadDecoder.h"
+#include "FrameWriter.h"
+#include "ImageEncoder.h"
+#include "BatchExporter.h"
+#include "ExtractionQueue.h"
+#include "SceneDetector.h"
+#include "FrameFilename.h"
+#include "FrameHashIndex.h"
+#include "FrameDirectoryIndex.h"
+#include "CaptureManifest.h"
+#include "SharpnessTrack.h"
+#include "SharpnessSparkline.h"
+#include "PerfHud.h"
+#include "TimelineWidget.h"
+#include "FrameListModel.h"
 
 class MainWindow : public QMainWindow
 {
@@ -56,6 +77,20 @@ private slots:
     void exportSelectedFrames();
     void clearSelectedFrames();
     void onFrameStepTimer();
+    void onFrameIndexReady();
+    void onFrameWritten(const QString &path, qint64 timestamp, bool success);
+    void onSaveQueueChanged(int inFlight);
+    void onDuplicateFound(const QString &path, qint64 timestamp, const QString &existingFile, int distance, bool skipped);
+    void onDuplicateOptionChanged();
+    void onImageFormatChanged(int index);
+    void onEncoderOptionChanged();
+    void onExportProgress(int done, int total, double decodeFps, double encodeFps);
+    void onExportFinished(int written, int failed, bool cancelled);
+    void onQueueProgress();
+    void onQueueFinished();
+    void onSceneCutsFound(const QVector<qint64> &timestamps);
+    void onSceneAnalysisFinished(int cuts, double framesPerSecond, bool cancelled);
+    void onSharpnessScored();
     // NOTE: Commented out unused slot that was causing UI hangups
     // void onFrameAvailable();
 
@@ -75,27 +110,75 @@ private:
     void loadSettings();
     void saveSettings();
     QString generateFrameFilename();
+    QString generateFrameFilename(qint64 videoPosition);
+    void startBatchExport(const QVector<BatchExporter::Item> &items);
+
+    // In/out points and interval sampling
+    void setInPoint();
+    void setOutPoint();
+    void clearInOutPoints();
+    void extractRange();
+    void extractMultipleVideos();
+    bool isQueueBusy() const;
+
+    // Near-duplicate index of the output directory
+    void refreshHashIndex();
+    void indexFrameFile(const QString &path);
+    void startHashIndexWork();
+
+    // Scene-cut candidates
+    void startSceneDetection();
+    void stopSceneDetection();
+    void jumpToSceneCut(int direction);
+
+    // Stepping through frames already captured from this video
+    int captureIndexFrom(int direction) const;
+    bool jumpToCapture(int direction);
+    void showCapture(int capture, int direction);
+    void setReviewMode(bool enabled);
+    void onReviewTimer();
+
+    // Sharpness scoring
+    using ScoredFrames = QVector<QPair<int, SharpnessMetrics::Score>>;
+    void snapToSharpestFrame();
+    void finishSharpnessSnap();
+    void updateEncoderControls();
     void captureCurrentFrame();
     QString extractFilenamePrefix(const QString &videoPath);
     void setDefaultFilenamePrefix(const QString &videoPath);
     void updateFilePathDisplay(const QString &filePath);
 
+    // Frame-accurate stepping
+    void startFrameIndexing(const QString &videoPath);
+    void cancelFrameIndexing();
+    qint64 steppedPosition(qint64 currentPos, int frameDelta);
+    void showSteppedFrame(qint64 position, int direction);
+    void updatePositionDisplay(qint64 position);
+    void syncPlayerPosition();
+    bool canStepFromCache(int direction) const;
+    void logFrameCacheStats();
+
     // Frame capture methods
     enum FrameCaptureMethod
     {
         CAPTURE_QT_SINK, // Use Qt's QVideoSink (current method)
-        CAPTURE_FFMPEG   // Use ffmpeg subprocess
+        CAPTURE_FFMPEG,  // Use ffmpeg subprocess
+        CAPTURE_LIBAV    // Use the persistent in-process libav decoder
     };
 
     void captureCurrentFrameQt();
     void captureCurrentFrameFFmpeg();
+    void captureCurrentFrameLibav();
+    void enqueueFrameWrite(const FrameWriter::Job &job);
     bool checkFFmpegAvailable();
+    QString captureMethodName(FrameCaptureMethod method) const;
+    void openCaptureDecoder();
 
     // Existing frame detection and timeline marking
     void scanForExistingFrames();
     void updateTimelineMarkers();
-    QList<qint64> parseExistingFrameTimestamps();
-    qint64 extractTimestampFromFilename(const QString &filename);
+    void refreshExistingFrameMarkers();
+    void openCaptureManifest();
 
     // UI Components
     QWidget *m_centralWidget;
@@ -113,13 +196,16 @@ private:
     QPushButton *m_previousFrameBtn;
     QPushButton *m_nextFrameBtn;
     QPushButton *m_saveFrameBtn;
-    QSlider *m_positionSlider;
+    QPushButton *m_snapSharpestBtn;
+    QSpinBox *m_snapRadiusSpin; // Frames searched on each side of the playhead
+    TimelineWidget *m_positionSlider;
     QLabel *m_timeLabel;
     QLabel *m_durationLabel;
 
     // Frame list section
     QWidget *m_frameListWidget;
-    QListWidget *m_frameList;
+    QListView *m_frameList;
+    FrameListModel *m_frameListModel;
     QPushButton *m_removeFrameBtn;
     QPushButton *m_exportFramesBtn;
     QPushButton *m_clearFramesBtn;
@@ -130,6 +216,9 @@ private:
     QLineEdit *m_outputDirEdit;
     QPushButton *m_browseDirBtn;
     QComboBox *m_imageFormatCombo;
+    QLabel *m_encoderLevelLabel;
+    QSpinBox *m_encoderLevelSpin;  // PNG compression level or JPEG quality
+    QComboBox *m_encoderModeCombo; // PNG filter or JPEG chroma subsampling
     QLineEdit *m_filenamePrefixEdit;
 
     // Menu and actions
@@ -138,6 +227,17 @@ private:
     QAction *m_aboutAction;
     QAction *m_keyboardShortcutsAction;
     QAction *m_logLevelAction;
+    QAction *m_captureMethodAction;
+    QAction *m_saveTraceAction;
+    QAction *m_setInPointAction;
+    QAction *m_setOutPointAction;
+    QAction *m_clearInOutAction;
+    QAction *m_extractRangeAction;
+    QAction *m_extractVideosAction;
+    QAction *m_detectScenesAction;
+    QAction *m_showSharpnessAction;
+    QAction *m_reviewCapturesAction;
+    QAction *m_showPerfHudAction;
 
     // Status
     QProgressBar *m_progressBar;
@@ -148,6 +248,19 @@ private:
     bool m_isSteppingForward;
     bool m_isSteppingBackward;
     int m_stepInterval;
+    int m_stepWaitTicks; // Timer ticks spent waiting for the read-ahead thread since the last step
+
+    // Per-video frame index (built in the background on open)
+    FrameIndex m_frameIndex;
+    QFutureWatcher<FrameIndex> *m_frameIndexWatcher;
+    std::shared_ptr<std::atomic_bool> m_frameIndexCancel;
+    int m_currentFrameIndex; // Frame last stepped to, -1 if unknown (playing/seeked)
+
+    // Decoded frames around the playhead; filled by the read-ahead decoder thread
+    FrameCache m_frameCache;
+    ReadAheadDecoder *m_readAheadDecoder;
+    QTimer *m_playerSyncTimer; // Seeks the player once cached stepping settles
+    QTimer *m_reviewTimer;     // Advances to the next capture while review mode is on
 
     // Data
     QString m_currentVideoPath;
@@ -162,7 +275,52 @@ private:
     FrameCaptureMethod m_frameCaptureMethod;
     bool m_ffmpegAvailable;
 
-    // Existing frame timeline markers
+    // Warm decoder for CAPTURE_LIBAV, kept open while the video is loaded
+    std::unique_ptr<VideoDecoder> m_captureDecoder; // Only touched from m_captureDecodePool
+    QThreadPool *m_captureDecodePool;
+
+    // Background encoders for saved frames
+    FrameWriter *m_frameWriter;
+    ImageEncoder::Settings m_encoderSettings;
+
+    // Near-duplicate check against the frames already in the output directory
+    FrameHashIndex m_hashIndex;
+    QFutureWatcher<void> *m_hashIndexWatcher; // One pass at a time; the next is chained off its finished signal
+    std::shared_ptr<std::atomic_bool> m_hashIndexCancel;
+    bool m_hashIndexReload;               // A full pass (reload and hash unindexed frames) is due
+    QStringList m_hashIndexPendingFiles;  // Single new frames to hash, when no full pass is due
+    QComboBox *m_duplicateModeCombo;
+    QSpinBox *m_duplicateThresholdSpin;
+    FrameWriter::DuplicatePolicy m_duplicatePolicy;
+    int m_duplicateThreshold;
+    QHash<QString, QString> m_duplicateWarnings; // Saved frame -> similar existing frame, until its save completes
+
+    // Single-sweep extraction of every frame in the list or of a sampled range
+    BatchExporter *m_batchExporter;
+    // Interval extraction from many videos at once, in the background
+    ExtractionQueue *m_extractionQueue;
+    qint64 m_inPoint;  // Range start in ms, -1 if unset (start of video)
+    qint64 m_outPoint; // Range end in ms, -1 if unset (end of video)
+    QLabel *m_saveQueueLabel;
+
+    // Shot changes found by a background pass, drawn as their own layer on the timeline
+    SceneDetector *m_sceneDetector; // Current pass; finished passes delete themselves
+    int m_capturedMarkerLayer; // Timeline layer of frames already in the output directory
+    int m_sceneCutMarkerLayer;
+    QVector<qint64> m_sceneCuts; // Ascending, in ms
+
+    // Per-frame sharpness, scored by the read-ahead decoder and on demand by the snap action
+    SharpnessTrack m_sharpnessTrack;
+    SharpnessSparkline *m_sharpnessSparkline;
+    QFutureWatcher<ScoredFrames> *m_sharpnessWatcher; // Scores the frames around the playhead not decoded yet
+    QString m_snapVideoPath;
+    int m_snapCentre; // Frame the pending snap searches around
+
+    PerfHud *m_perfHud; // Hidden unless toggled on; performance counters only record while it shows
+
+    // Existing frame timeline markers, looked up in the background-maintained directory index
+    FrameDirectoryIndex *m_frameDirectoryIndex;
+    std::shared_ptr<CaptureManifest> m_captureManifest; // Captures of the current video in the output directory
     QList<qint64> m_existingFrameTimestamps;
 
     // Position update throttling
@@ -0,0 +1,78 @@
+#include "PerceptualHash.h"
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+    constexpr int kGridWidth = 9;
+    constexpr int kGridHeight = 8;
+    // Pixels sampled per cell in each direction; more adds cost but not stability
+    constexpr int kSamplesPerCell = 8;
+
+    inline uint32_t luma(uint32_t pixel)
+    {
+        return (((pixel >> 16) & 0xFF) * 77 + ((pixel >> 8) & 0xFF) * 150 + (pixel & 0xFF) * 29) >> 8;
+    }
+}
+
+uint64_t PerceptualHash::dHash(const uint8_t *pixels, int width, int height, int stride)
+{
+    if (!pixels || width <= 0 || height <= 0)
+        return 0;
+
+    // Mean luma of a regular grid of samples inside each cell
+    uint32_t cells[kGridHeight][kGridWidth];
+    for (int cy = 0; cy < kGridHeight; ++cy)
+    {
+        int y0 = cy * height / kGridHeight;
+        int y1 = std::max(y0 + 1, (cy + 1) * height / kGridHeight);
+        for (int cx = 0; cx < kGridWidth; ++cx)
+        {
+            int x0 = cx * width / kGridWidth;
+            int x1 = std::max(x0 + 1, (cx + 1) * width / kGridWidth);
+            uint32_t sum = 0;
+            for (int sy = 0; sy < kSamplesPerCell; ++sy)
+            {
+                int y = y0 + (2 * sy + 1) * (y1 - y0) / (2 * kSamplesPerCell);
+                const uint8_t *row = pixels + static_cast<ptrdiff_t>(y) * stride;
+                for (int sx = 0; sx < kSamplesPerCell; ++sx)
+                {
+                    int x = x0 + (2 * sx + 1) * (x1 - x0) / (2 * kSamplesPerCell);
+                    uint32_t pixel;
+                    std::memcpy(&pixel, row + x * 4, 4);
+                    sum += luma(pixel);
+                }
+            }
+            cells[cy][cx] = sum;
+        }
+    }
+
+    uint64_t hash = 0;
+    for (int cy = 0; cy < kGridHeight; ++cy)
+    {
+        for (int cx = 0; cx < kGridWidth - 1; ++cx)
+        {
+            hash = (hash << 1) | (cells[cy][cx] < cells[cy][cx + 1] ? 1u : 0u);
+        }
+    }
+    return hash;
+}
+
+uint64_t PerceptualHash::dHash(const QImage &image)
+{
+    if (image.isNull())
+        return 0;
+    if (image.depth() != 32)
+    {
+        QImage converted = image.convertToFormat(QImage::Format_RGB32);
+        return dHash(converted.constBits(), converted.width(), converted.height(), static_cast<int>(converted.bytesPerLine()));
+    }
+    return dHash(image.constBits(), image.width(), image.height(), static_cast<int>(image.bytesPerLine()));
+}
+
+int PerceptualHash::distance(uint64_t a, uint64_t b)
+{
+    return static_cast<int>(std::bitset<64>(a ^ b).count());
+}
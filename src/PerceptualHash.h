@@ -0,0 +1,31 @@
+#ifndef PERCEPTUALHASH_H
+#define PERCEPTUALHASH_H
+
+#include <QImage>
+#include <cstdint>
+
+/**
+ * 64-bit difference hash (dHash) of a frame.
+ *
+ * The frame is reduced to a 9x8 grid of mean luma values and each bit records
+ * whether a cell is brighter than its right-hand neighbour. Re-encoding, small
+ * shifts and noise flip only a few bits, so the Hamming distance between two
+ * hashes measures how alike two frames look.
+ */
+class PerceptualHash
+{
+public:
+    /**
+     * Hash 32-bit pixels (QImage::Format_RGB32/ARGB32 memory layout)
+     */
+    static uint64_t dHash(const uint8_t *pixels, int width, int height, int stride);
+
+    /**
+     * Hash any image; non-32-bit formats are converted first
+     */
+    static uint64_t dHash(const QImage &image);
+
+    static int distance(uint64_t a, uint64_t b);
+};
+
+#endif // PERCEPTUALHASH_H
@@ -0,0 +1,177 @@
+#include "PerfHud.h"
+#include "FrameWriter.h"
+#include <QEvent>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QPainter>
+
+// Rates and percentiles cover this many refreshes
+static constexpr int kWindowSamples = 20;
+static constexpr int kRefreshIntervalMs = 250;
+// A GUI thread timer at this interval fires late by however long the event loop was busy
+static constexpr int kProbeIntervalMs = 50;
+static constexpr int kMargin = 8;
+static constexpr int kPadding = 6;
+
+namespace
+{
+    QString formatUs(qint64 us)
+    {
+        if (us < 1000)
+            return QString("%1us").arg(us);
+        return QString("%1ms").arg(us / 1000.0, 0, 'f', us < 100000 ? 1 : 0);
+    }
+
+    QString formatPercentiles(const LatencyHistogram::Snapshot &histogram)
+    {
+        if (histogram.total() == 0)
+            return "-";
+        return QString("p50 %1  p95 %2  p99 %3")
+            .arg(formatUs(histogram.percentile(0.50)), formatUs(histogram.percentile(0.95)), formatUs(histogram.percentile(0.99)));
+    }
+}
+
+PerfHud::PerfHud(QWidget *anchor, const FrameCache *cache, const FrameWriter *writer, QWidget *parent)
+    : QWidget(parent, Qt::Tool | Qt::FramelessWindowHint | Qt::WindowTransparentForInput | Qt::WindowDoesNotAcceptFocus),
+      m_anchor(anchor), m_cache(cache), m_writer(writer)
+{
+    // A separate tool window rather than a child, since the video widget may be a native surface that children can't draw over
+    setAttribute(Qt::WA_TranslucentBackground);
+    setAttribute(Qt::WA_ShowWithoutActivating);
+    setFocusPolicy(Qt::NoFocus);
+
+    QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    font.setPointSizeF(font.pointSizeF() * 0.9);
+    setFont(font);
+
+    m_anchor->installEventFilter(this);
+    m_anchor->window()->installEventFilter(this);
+
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &PerfHud::refresh);
+
+    m_probeTimer.setTimerType(Qt::PreciseTimer);
+    m_probeTimer.setInterval(kProbeIntervalMs);
+    connect(&m_probeTimer, &QTimer::timeout, this, &PerfHud::probeEventLoop);
+
+    hide();
+}
+
+PerfHud::~PerfHud()
+{
+    PerfStats::setEnabled(false);
+}
+
+void PerfHud::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+
+    PerfStats::setEnabled(true);
+    m_history.clear();
+    m_probeClock.start();
+    m_probeTimer.start();
+    m_refreshTimer.start();
+    refresh();
+    reposition();
+}
+
+void PerfHud::hideEvent(QHideEvent *event)
+{
+    m_refreshTimer.stop();
+    m_probeTimer.stop();
+    PerfStats::setEnabled(false);
+
+    QWidget::hideEvent(event);
+}
+
+bool PerfHud::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Move || event->type() == QEvent::Resize)
+    {
+        if (isVisible())
+            reposition();
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void PerfHud::reposition()
+{
+    move(m_anchor->mapToGlobal(QPoint(kMargin, kMargin)));
+}
+
+void PerfHud::probeEventLoop()
+{
+    qint64 lateUs = m_probeClock.nsecsElapsed() / 1000 - kProbeIntervalMs * 1000;
+    m_probeClock.restart();
+    PerfStats::eventLoopLag(qMax<qint64>(0, lateUs));
+}
+
+void PerfHud::refresh()
+{
+    m_history.append({PerfStats::snapshot(), m_cache->stats()});
+    if (m_history.size() > kWindowSamples + 1)
+    {
+        m_history.removeFirst();
+    }
+
+    const Sample &oldest = m_history.first();
+    const Sample &newest = m_history.last();
+    double seconds = (newest.stats.timeNs - oldest.stats.timeNs) / 1e9;
+    auto rate = [seconds](quint64 count)
+    { return seconds > 0.0 ? count / seconds : 0.0; };
+
+    double decodeFps = rate(newest.stats.framesDecoded - oldest.stats.framesDecoded);
+    double displayFps = rate(newest.stats.framesDisplayed - oldest.stats.framesDisplayed);
+    double encodeFps = rate(newest.stats.framesEncoded - oldest.stats.framesEncoded);
+    double encodeMBps = rate(newest.stats.bytesEncoded - oldest.stats.bytesEncoded) / (1024.0 * 1024.0);
+    LatencyHistogram::Snapshot seek = newest.stats.seekLatency - oldest.stats.seekLatency;
+    LatencyHistogram::Snapshot encode = newest.stats.encodeLatency - oldest.stats.encodeLatency;
+    LatencyHistogram::Snapshot lag = newest.stats.eventLoopLag - oldest.stats.eventLoopLag;
+
+    quint64 hits = newest.cache.hits - oldest.cache.hits;
+    quint64 lookups = hits + newest.cache.misses - oldest.cache.misses;
+    QString hitRate = lookups > 0 ? QString("%1%").arg(100.0 * hits / lookups, 0, 'f', 0) : QString("-");
+
+    m_lines.clear();
+    m_lines << QString("Decode  %1 fps   Display %2 fps").arg(decodeFps, 5, 'f', 1).arg(displayFps, 5, 'f', 1);
+    m_lines << QString("Seek    %1  (%2 seeks)").arg(formatPercentiles(seek)).arg(seek.total());
+    m_lines << QString("Save    queue %1/%2   %3 fps  %4 MB/s  encode p95 %5")
+                   .arg(m_writer->inFlight())
+                   .arg(m_writer->maxInFlight())
+                   .arg(encodeFps, 0, 'f', 1)
+                   .arg(encodeMBps, 0, 'f', 1)
+                   .arg(encode.total() > 0 ? formatUs(encode.percentile(0.95)) : QString("-"));
+    m_lines << QString("Cache   %1 hits of %2   %3 frames  %4 MB")
+                   .arg(hitRate)
+                   .arg(lookups)
+                   .arg(newest.cache.frames)
+                   .arg(newest.cache.bytes / (1024 * 1024));
+    m_lines << QString("UI lag  %1").arg(formatPercentiles(lag));
+
+    QFontMetrics metrics(font());
+    int width = 0;
+    for (const QString &line : m_lines)
+    {
+        width = qMax(width, metrics.horizontalAdvance(line));
+    }
+    resize(width + 2 * kPadding, static_cast<int>(m_lines.size()) * metrics.lineSpacing() + 2 * kPadding);
+    update();
+}
+
+void PerfHud::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 170));
+    painter.drawRoundedRect(rect(), 4, 4);
+
+    QFontMetrics metrics(font());
+    painter.setPen(QColor(230, 230, 230));
+    int y = kPadding + metrics.ascent();
+    for (const QString &line : m_lines)
+    {
+        painter.drawText(kPadding, y, line);
+        y += metrics.lineSpacing();
+    }
+}
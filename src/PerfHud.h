@@ -0,0 +1,64 @@
+#ifndef PERFHUD_H
+#define PERFHUD_H
+
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+#include "FrameCache.h"
+#include "PerfStats.h"
+
+class FrameWriter;
+
+/**
+ * Translucent overlay in the corner of the video showing where time goes.
+ *
+ * Shows decode and display fps, seek-to-displayed latency, capture queue
+ * depth, encode throughput, frame cache hit rate and GUI event-loop lag,
+ * all over the last few seconds. Showing the HUD switches PerfStats
+ * recording on and starts a timer that measures event-loop lag; hiding it
+ * switches both off again, so a hidden HUD costs nothing.
+ */
+class PerfHud : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param anchor Widget whose top-left corner the HUD sits in and follows
+     * @param parent Window the HUD floats above
+     */
+    PerfHud(QWidget *anchor, const FrameCache *cache, const FrameWriter *writer, QWidget *parent);
+    ~PerfHud() override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void refresh();
+    void probeEventLoop();
+
+private:
+    struct Sample
+    {
+        PerfStats::Snapshot stats;
+        FrameCache::Stats cache;
+    };
+
+    void reposition();
+
+    QWidget *m_anchor;
+    const FrameCache *m_cache;
+    const FrameWriter *m_writer;
+    QVector<Sample> m_history; // Oldest first, covering the averaging window
+    QStringList m_lines;
+    QTimer m_refreshTimer;
+    QTimer m_probeTimer;
+    QElapsedTimer m_probeClock;
+};
+
+#endif // PERFHUD_H
@@ -0,0 +1,46 @@
+#include "PerfStats.h"
+#include "Tracer.h"
+
+void PerfStats::setEnabled(bool enabled)
+{
+    // A seek started before recording was switched off would otherwise complete much later
+    s_seekStartNs.store(-1, std::memory_order_relaxed);
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+PerfStats::Snapshot PerfStats::snapshot()
+{
+    Snapshot snapshot;
+    snapshot.timeNs = Tracer::nowNs();
+    snapshot.framesDecoded = s_framesDecoded.load(std::memory_order_relaxed);
+    snapshot.framesDisplayed = s_framesDisplayed.load(std::memory_order_relaxed);
+    snapshot.framesEncoded = s_framesEncoded.load(std::memory_order_relaxed);
+    snapshot.bytesEncoded = s_bytesEncoded.load(std::memory_order_relaxed);
+    snapshot.seekLatency = s_seekLatency.snapshot();
+    snapshot.encodeLatency = s_encodeLatency.snapshot();
+    snapshot.eventLoopLag = s_eventLoopLag.snapshot();
+    return snapshot;
+}
+
+void PerfStats::markSeekRequested()
+{
+    // Held-key stepping requests frames faster than they show; the latest request is the one that counts
+    s_seekStartNs.store(Tracer::nowNs(), std::memory_order_relaxed);
+}
+
+void PerfStats::markFrameDisplayed()
+{
+    s_framesDisplayed.fetch_add(1, std::memory_order_relaxed);
+    qint64 start = s_seekStartNs.exchange(-1, std::memory_order_relaxed);
+    if (start >= 0)
+    {
+        s_seekLatency.record((Tracer::nowNs() - start) / 1000);
+    }
+}
+
+void PerfStats::markFrameEncoded(qint64 durationUs, qint64 bytes)
+{
+    s_framesEncoded.fetch_add(1, std::memory_order_relaxed);
+    s_bytesEncoded.fetch_add(static_cast<quint64>(qMax<qint64>(0, bytes)), std::memory_order_relaxed);
+    s_encodeLatency.record(durationUs);
+}
@@ -0,0 +1,94 @@
+#ifndef PERFSTATS_H
+#define PERFSTATS_H
+
+#include "LatencyHistogram.h"
+#include <atomic>
+
+/**
+ * Process-wide counters and latency histograms behind the performance HUD.
+ *
+ * Recording is off until the HUD turns it on. While off, every recording
+ * call is a single relaxed load of the enabled flag; while on, it is a few
+ * relaxed atomic increments, safe from any thread. Readers take a Snapshot
+ * and diff it against an older one to get rates and percentiles for a
+ * recent time window.
+ */
+class PerfStats
+{
+public:
+    struct Snapshot
+    {
+        qint64 timeNs;
+        quint64 framesDecoded;
+        quint64 framesDisplayed;
+        quint64 framesEncoded;
+        quint64 bytesEncoded;
+        LatencyHistogram::Snapshot seekLatency;
+        LatencyHistogram::Snapshot encodeLatency;
+        LatencyHistogram::Snapshot eventLoopLag;
+    };
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+
+    /**
+     * A seek or frame step was requested; the next displayed frame completes it
+     */
+    static void seekRequested()
+    {
+        if (isEnabled())
+            markSeekRequested();
+    }
+
+    /**
+     * A frame reached the display; counts towards display fps and finishes a pending seek
+     */
+    static void frameDisplayed()
+    {
+        if (isEnabled())
+            markFrameDisplayed();
+    }
+
+    /**
+     * A libav decoder produced a frame, whether or not it was kept
+     */
+    static void frameDecoded()
+    {
+        if (isEnabled())
+            s_framesDecoded.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void frameEncoded(qint64 durationUs, qint64 bytes)
+    {
+        if (isEnabled())
+            markFrameEncoded(durationUs, bytes);
+    }
+
+    /**
+     * How late a GUI thread timer fired, i.e. how long queued events waited
+     */
+    static void eventLoopLag(qint64 us)
+    {
+        if (isEnabled())
+            s_eventLoopLag.record(us);
+    }
+
+    static Snapshot snapshot();
+
+private:
+    static void markSeekRequested();
+    static void markFrameDisplayed();
+    static void markFrameEncoded(qint64 durationUs, qint64 bytes);
+
+    static inline std::atomic_bool s_enabled{false};
+    static inline std::atomic<qint64> s_seekStartNs{-1}; // -1 when no seek is waiting for a frame
+    static inline std::atomic<quint64> s_framesDecoded{0};
+    static inline std::atomic<quint64> s_framesDisplayed{0};
+    static inline std::atomic<quint64> s_framesEncoded{0};
+    static inline std::atomic<quint64> s_bytesEncoded{0};
+    static inline LatencyHistogram s_seekLatency;
+    static inline LatencyHistogram s_encodeLatency;
+    static inline LatencyHistogram s_eventLoopLag;
+};
+
+#endif // PERFSTATS_H
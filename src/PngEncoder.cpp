@@ -0,0 +1,197 @@
+#include "PngEncoder.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+
+namespace
+{
+    void appendUint32(std::vector<uint8_t> &output, uint32_t value)
+    {
+        output.push_back(static_cast<uint8_t>(value >> 24));
+        output.push_back(static_cast<uint8_t>(value >> 16));
+        output.push_back(static_cast<uint8_t>(value >> 8));
+        output.push_back(static_cast<uint8_t>(value));
+    }
+
+    // Chunk layout: length, type, data, CRC over type and data
+    void appendChunk(std::vector<uint8_t> &output, const char *type, const uint8_t *data, size_t size)
+    {
+        appendUint32(output, static_cast<uint32_t>(size));
+        size_t typeOffset = output.size();
+        output.insert(output.end(), type, type + 4);
+        if (size > 0)
+        {
+            output.insert(output.end(), data, data + size);
+        }
+        uLong crc = crc32(0L, output.data() + typeOffset, static_cast<uInt>(size + 4));
+        appendUint32(output, static_cast<uint32_t>(crc));
+    }
+
+    inline uint8_t paethPredictor(int a, int b, int c)
+    {
+        int p = a + b - c;
+        int pa = std::abs(p - a);
+        int pb = std::abs(p - b);
+        int pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc)
+            return static_cast<uint8_t>(a);
+        if (pb <= pc)
+            return static_cast<uint8_t>(b);
+        return static_cast<uint8_t>(c);
+    }
+
+    // Filter one RGB row into out (without the leading filter type byte)
+    void filterRow(PngEncoder::Filter filter, const uint8_t *row, const uint8_t *previous, size_t rowBytes, uint8_t *out)
+    {
+        const size_t bpp = 3;
+        switch (filter)
+        {
+        case PngEncoder::Filter::Sub:
+            for (size_t i = 0; i < rowBytes; ++i)
+                out[i] = static_cast<uint8_t>(row[i] - (i >= bpp ? row[i - bpp] : 0));
+            break;
+        case PngEncoder::Filter::Up:
+            for (size_t i = 0; i < rowBytes; ++i)
+                out[i] = static_cast<uint8_t>(row[i] - previous[i]);
+            break;
+        case PngEncoder::Filter::Paeth:
+            for (size_t i = 0; i < rowBytes; ++i)
+            {
+                int left = i >= bpp ? row[i - bpp] : 0;
+                int upperLeft = i >= bpp ? previous[i - bpp] : 0;
+                out[i] = static_cast<uint8_t>(row[i] - paethPredictor(left, previous[i], upperLeft));
+            }
+            break;
+        case PngEncoder::Filter::None:
+        default:
+            std::memcpy(out, row, rowBytes);
+            break;
+        }
+    }
+
+    uint8_t filterType(PngEncoder::Filter filter)
+    {
+        switch (filter)
+        {
+        case PngEncoder::Filter::Sub:
+            return 1;
+        case PngEncoder::Filter::Up:
+            return 2;
+        case PngEncoder::Filter::Paeth:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    uint64_t residualCost(const uint8_t *data, size_t size)
+    {
+        uint64_t cost = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            cost += static_cast<uint64_t>(std::abs(static_cast<int8_t>(data[i])));
+        }
+        return cost;
+    }
+}
+
+bool PngEncoder::encode(const uint8_t *pixels, int width, int height, int stride,
+                        int compressionLevel, Filter filter, std::vector<uint8_t> &output)
+{
+    if (!pixels || width <= 0 || height <= 0)
+        return false;
+
+    const size_t rowBytes = static_cast<size_t>(width) * 3;
+    const size_t rawSize = (rowBytes + 1) * static_cast<size_t>(height);
+
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    // Filtered scanlines compress best with Z_FILTERED; unfiltered ones with the default strategy
+    int strategy = filter == Filter::None ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+    if (deflateInit2(&stream, std::clamp(compressionLevel, 0, 9), Z_DEFLATED, 15, 8, strategy) != Z_OK)
+        return false;
+
+    std::vector<uint8_t> compressed(deflateBound(&stream, static_cast<uLong>(rawSize)));
+    stream.next_out = compressed.data();
+    stream.avail_out = static_cast<uInt>(compressed.size());
+
+    // Current/previous RGB rows plus one filtered row per candidate filter
+    std::vector<uint8_t> rgb(rowBytes * 2, 0);
+    std::vector<uint8_t> filtered((rowBytes + 1) * 4);
+    uint8_t *current = rgb.data();
+    uint8_t *previous = rgb.data() + rowBytes;
+
+    const Filter candidates[] = {Filter::None, Filter::Sub, Filter::Up, Filter::Paeth};
+
+    bool ok = true;
+    for (int y = 0; y < height && ok; ++y)
+    {
+        const uint8_t *source = pixels + static_cast<ptrdiff_t>(y) * stride;
+        for (int x = 0; x < width; ++x)
+        {
+            // RGB32 in memory is B, G, R, A on little-endian machines
+            uint32_t pixel;
+            std::memcpy(&pixel, source + x * 4, 4);
+            current[x * 3] = static_cast<uint8_t>(pixel >> 16);
+            current[x * 3 + 1] = static_cast<uint8_t>(pixel >> 8);
+            current[x * 3 + 2] = static_cast<uint8_t>(pixel);
+        }
+
+        uint8_t *line = filtered.data();
+        if (filter == Filter::Adaptive)
+        {
+            uint64_t bestCost = UINT64_MAX;
+            for (int i = 0; i < 4; ++i)
+            {
+                uint8_t *candidate = filtered.data() + i * (rowBytes + 1);
+                candidate[0] = filterType(candidates[i]);
+                filterRow(candidates[i], current, previous, rowBytes, candidate + 1);
+                uint64_t cost = residualCost(candidate + 1, rowBytes);
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    line = candidate;
+                }
+            }
+        }
+        else
+        {
+            line[0] = filterType(filter);
+            filterRow(filter, current, previous, rowBytes, line + 1);
+        }
+
+        stream.next_in = line;
+        stream.avail_in = static_cast<uInt>(rowBytes + 1);
+        ok = deflate(&stream, Z_NO_FLUSH) == Z_OK;
+        std::swap(current, previous);
+    }
+
+    if (ok)
+    {
+        ok = deflate(&stream, Z_FINISH) == Z_STREAM_END;
+    }
+    size_t compressedSize = compressed.size() - stream.avail_out;
+    deflateEnd(&stream);
+    if (!ok)
+        return false;
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    output.clear();
+    output.reserve(compressedSize + 64);
+    output.insert(output.end(), signature, signature + 8);
+
+    std::vector<uint8_t> header;
+    appendUint32(header, static_cast<uint32_t>(width));
+    appendUint32(header, static_cast<uint32_t>(height));
+    header.push_back(8); // Bit depth
+    header.push_back(2); // Colour type: truecolour RGB
+    header.push_back(0); // Compression method
+    header.push_back(0); // Filter method
+    header.push_back(0); // No interlace
+    appendChunk(output, "IHDR", header.data(), header.size());
+    appendChunk(output, "IDAT", compressed.data(), compressedSize);
+    appendChunk(output, "IEND", nullptr, 0);
+    return true;
+}
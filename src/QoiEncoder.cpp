@@ -0,0 +1,134 @@
+#include "QoiEncoder.h"
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+    enum : uint8_t
+    {
+        QOI_OP_INDEX = 0x00,
+        QOI_OP_DIFF = 0x40,
+        QOI_OP_LUMA = 0x80,
+        QOI_OP_RUN = 0xC0,
+        QOI_OP_RGB = 0xFE
+    };
+
+    struct Rgb
+    {
+        uint8_t r, g, b;
+    };
+
+    inline int colorHash(const Rgb &c)
+    {
+        // Alpha is always 255 for RGB32 sources
+        return (c.r * 3 + c.g * 5 + c.b * 7 + 255 * 11) % 64;
+    }
+
+    inline bool operator==(const Rgb &a, const Rgb &b)
+    {
+        return a.r == b.r && a.g == b.g && a.b == b.b;
+    }
+
+    void appendUint32(std::vector<uint8_t> &output, uint32_t value)
+    {
+        output.push_back(static_cast<uint8_t>(value >> 24));
+        output.push_back(static_cast<uint8_t>(value >> 16));
+        output.push_back(static_cast<uint8_t>(value >> 8));
+        output.push_back(static_cast<uint8_t>(value));
+    }
+}
+
+bool QoiEncoder::encode(const uint8_t *pixels, int width, int height, int stride, std::vector<uint8_t> &output)
+{
+    if (!pixels || width <= 0 || height <= 0)
+        return false;
+
+    const size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+    output.clear();
+    // Worst case is one QOI_OP_RGB (4 bytes) per pixel plus header and end marker
+    output.reserve(14 + pixelCount * 4 + 8);
+
+    output.insert(output.end(), {'q', 'o', 'i', 'f'});
+    appendUint32(output, static_cast<uint32_t>(width));
+    appendUint32(output, static_cast<uint32_t>(height));
+    output.push_back(3); // Channels: RGB
+    output.push_back(0); // Colour space: sRGB with linear alpha
+
+    // Entries store 0xAARRGGBB so the zero-initialised table (alpha 0) never matches an opaque pixel,
+    // mirroring the decoder's initial state
+    uint32_t index[64];
+    std::memset(index, 0, sizeof(index));
+    Rgb previous{0, 0, 0};
+    int run = 0;
+
+    for (int y = 0; y < height; ++y)
+    {
+        const uint8_t *row = pixels + static_cast<ptrdiff_t>(y) * stride;
+        for (int x = 0; x < width; ++x)
+        {
+            uint32_t value;
+            std::memcpy(&value, row + x * 4, 4);
+            Rgb pixel{static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)};
+
+            if (pixel == previous)
+            {
+                if (++run == 62)
+                {
+                    output.push_back(static_cast<uint8_t>(QOI_OP_RUN | (run - 1)));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0)
+            {
+                output.push_back(static_cast<uint8_t>(QOI_OP_RUN | (run - 1)));
+                run = 0;
+            }
+
+            int hash = colorHash(pixel);
+            uint32_t packed = 0xFF000000u | value;
+            if (index[hash] == packed)
+            {
+                output.push_back(static_cast<uint8_t>(QOI_OP_INDEX | hash));
+            }
+            else
+            {
+                index[hash] = packed;
+
+                int8_t dr = static_cast<int8_t>(pixel.r - previous.r);
+                int8_t dg = static_cast<int8_t>(pixel.g - previous.g);
+                int8_t db = static_cast<int8_t>(pixel.b - previous.b);
+                int8_t drdg = static_cast<int8_t>(dr - dg);
+                int8_t dbdg = static_cast<int8_t>(db - dg);
+
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+                {
+                    output.push_back(static_cast<uint8_t>(QOI_OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+                }
+                else if (dg >= -32 && dg <= 31 && drdg >= -8 && drdg <= 7 && dbdg >= -8 && dbdg <= 7)
+                {
+                    output.push_back(static_cast<uint8_t>(QOI_OP_LUMA | (dg + 32)));
+                    output.push_back(static_cast<uint8_t>((drdg + 8) << 4 | (dbdg + 8)));
+                }
+                else
+                {
+                    output.push_back(QOI_OP_RGB);
+                    output.push_back(pixel.r);
+                    output.push_back(pixel.g);
+                    output.push_back(pixel.b);
+                }
+            }
+            previous = pixel;
+        }
+    }
+
+    if (run > 0)
+    {
+        output.push_back(static_cast<uint8_t>(QOI_OP_RUN | (run - 1)));
+    }
+
+    static const uint8_t endMarker[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+    output.insert(output.end(), endMarker, endMarker + 8);
+    return true;
+}
@@ -0,0 +1,29 @@
+#ifndef QOIENCODER_H
+#define QOIENCODER_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Encoder for the Quite OK Image format (https://qoiformat.org).
+ *
+ * QOI is lossless and encodes in a single linear pass with no entropy coder,
+ * so it runs an order of magnitude faster than PNG at a comparable size on
+ * natural video frames. Useful for bulk dataset extraction.
+ */
+class QoiEncoder
+{
+public:
+    /**
+     * Encode a 32-bit 0xAARRGGBB image (QImage::Format_RGB32 memory layout) as a 3-channel QOI file
+     * @param pixels First byte of the image
+     * @param width Image width in pixels
+     * @param height Image height in pixels
+     * @param stride Bytes per source row
+     * @param output Receives the complete QOI file
+     * @return false on invalid input
+     */
+    static bool encode(const uint8_t *pixels, int width, int height, int stride, std::vector<uint8_t> &output);
+};
+
+#endif // QOIENCODER_H
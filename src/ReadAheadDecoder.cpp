@@ -0,0 +1,280 @@
+#include "ReadAheadDecoder.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include <QMutexLocker>
+#include <QtMath>
+
+// Never decode fewer frames than this ahead of the playhead
+static constexpr int kMinLookaheadFrames = 8;
+// While a key is held, keep this much stepping time decoded ahead
+static constexpr double kLookaheadMs = 2000.0;
+// Matches the initial frame step timer interval in MainWindow
+static constexpr double kInitialStepIntervalMs = 200.0;
+
+ReadAheadDecoder::ReadAheadDecoder(FrameCache *cache, SharpnessTrack *sharpness, QObject *parent)
+    : QThread(parent), m_cache(cache), m_sharpness(sharpness), m_openPending(false), m_fillPending(false), m_quit(false), m_playhead(-1), m_direction(1), m_heldDirection(0), m_stepIntervalMs(kInitialStepIntervalMs), m_generation(0), m_depth(kMinLookaheadFrames), m_videoOpen(false)
+{
+}
+
+ReadAheadDecoder::~ReadAheadDecoder()
+{
+    stop();
+}
+
+void ReadAheadDecoder::openVideo(const QString &videoPath, const FrameIndex &index)
+{
+    QMutexLocker locker(&m_mutex);
+    m_pendingPath = videoPath;
+    m_pendingIndex = index;
+    m_index = index;
+    m_openPending = true;
+    m_fillPending = false;
+    m_playhead = -1;
+    m_prefetchTargets.clear();
+    m_videoOpen.store(false, std::memory_order_release);
+    ++m_generation;
+    m_wakeCondition.wakeOne();
+}
+
+void ReadAheadDecoder::closeVideo()
+{
+    openVideo(QString(), FrameIndex());
+}
+
+void ReadAheadDecoder::setPlayhead(int frameIndex, int direction)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_heldDirection != 0)
+    {
+        updateDepthLocked();
+    }
+    m_playhead = frameIndex;
+    m_direction = direction < 0 ? -1 : 1;
+    m_fillPending = true;
+    m_wakeCondition.wakeOne();
+}
+
+void ReadAheadDecoder::setHeldDirection(int direction)
+{
+    QMutexLocker locker(&m_mutex);
+    m_heldDirection = direction;
+    if (direction == 0)
+    {
+        // Key released: forget the measured rate, the next hold starts slow again
+        m_stepClock.invalidate();
+        m_stepIntervalMs = kInitialStepIntervalMs;
+        m_depth.store(kMinLookaheadFrames, std::memory_order_relaxed);
+        return;
+    }
+
+    m_direction = direction < 0 ? -1 : 1;
+    m_fillPending = true;
+    m_wakeCondition.wakeOne();
+}
+
+void ReadAheadDecoder::setPrefetchTargets(const QVector<int> &frameIndices)
+{
+    QMutexLocker locker(&m_mutex);
+    m_prefetchTargets = frameIndices;
+    m_cache->setPinned(frameIndices);
+    m_fillPending = true;
+    m_wakeCondition.wakeOne();
+}
+
+void ReadAheadDecoder::stop()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_quit = true;
+        ++m_generation;
+        m_wakeCondition.wakeOne();
+    }
+    wait();
+}
+
+void ReadAheadDecoder::run()
+{
+    LOG_DEBUG("Read-ahead decoder thread started");
+    Tracer::setThreadName("Read-ahead decoder");
+
+    while (true)
+    {
+        QString openPath;
+        FrameIndex openIndex;
+        bool openRequested = false;
+        Range range{0, 0, 1};
+        bool haveRange = false;
+        int prefetch = -1;
+        int generation = 0;
+
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_quit && !m_openPending && !m_fillPending)
+            {
+                m_wakeCondition.wait(&m_mutex);
+            }
+            if (m_quit)
+                break;
+
+            generation = m_generation.load();
+            if (m_openPending)
+            {
+                openRequested = true;
+                openPath = m_pendingPath;
+                openIndex = m_pendingIndex;
+                m_openPending = false;
+                m_pendingIndex = FrameIndex();
+            }
+            else
+            {
+                haveRange = m_decoder.isOpen() && nextRangeLocked(&range);
+                if (!haveRange && m_decoder.isOpen())
+                {
+                    prefetch = nextPrefetchLocked();
+                }
+                if (!haveRange && prefetch < 0)
+                {
+                    m_fillPending = false;
+                }
+            }
+        }
+
+        if (openRequested)
+        {
+            // All cache inserts come from this thread, so clearing here can't race with a stale decode
+            m_cache->clear();
+            if (m_sharpness)
+            {
+                m_sharpness->reset(openIndex.frameCount());
+            }
+            if (openPath.isEmpty())
+            {
+                m_decoder.close();
+            }
+            else
+            {
+                m_decoder.open(openPath, openIndex);
+            }
+            m_videoOpen.store(m_decoder.isOpen(), std::memory_order_release);
+            continue;
+        }
+
+        if (prefetch >= 0)
+        {
+            // Only the target is kept; the frames decoded on the way from its keyframe are not worth the cache space
+            LOG_TRACE("Read-ahead: prefetching frame {}", prefetch);
+            TRACE_SCOPE("prefetch", "decode");
+            bool ok = m_decoder.decodeRange(prefetch, prefetch, [this, prefetch, generation](int frameIndex, const QImage &image)
+                                            {
+                if (generation != m_generation.load(std::memory_order_relaxed))
+                    return false;
+                if (frameIndex == prefetch)
+                {
+                    m_cache->insert(frameIndex, image);
+                    if (m_sharpness && !m_sharpness->score(frameIndex).isValid())
+                        m_sharpness->set(frameIndex, SharpnessMetrics::compute(image));
+                }
+                return true; });
+            // Don't retry a frame that can't be decoded or kept
+            QMutexLocker locker(&m_mutex);
+            if (!ok || !m_cache->contains(prefetch))
+            {
+                m_prefetchTargets.removeOne(prefetch);
+            }
+            continue;
+        }
+
+        if (!haveRange)
+            continue;
+
+        LOG_TRACE("Read-ahead: decoding frames {}-{} (direction {})", range.first, range.last, range.direction);
+        TRACE_SCOPE("readAhead", "decode");
+        bool ok = m_decoder.decodeRange(range.first, range.last, [this, &range, generation](int frameIndex, const QImage &image)
+                                        {
+            if (generation != m_generation.load(std::memory_order_relaxed))
+                return false;
+            m_cache->insert(frameIndex, image);
+            if (m_sharpness && !m_sharpness->score(frameIndex).isValid())
+                m_sharpness->set(frameIndex, SharpnessMetrics::compute(image));
+            // Going forward, a frame evicted on insert means the cache budget is used up
+            return range.direction < 0 || m_cache->contains(frameIndex); });
+
+        // Stop if the pass made no progress (decode error or cache too small for the window),
+        // otherwise the same range would be decoded over and over until the playhead moves
+        QMutexLocker locker(&m_mutex);
+        Range next{0, 0, 1};
+        if (!ok || (nextRangeLocked(&next) && next.first == range.first && next.last == range.last))
+        {
+            m_fillPending = false;
+        }
+    }
+
+    m_decoder.close();
+    m_videoOpen.store(false, std::memory_order_release);
+    LOG_DEBUG("Read-ahead decoder thread stopped");
+}
+
+bool ReadAheadDecoder::nextRangeLocked(Range *range) const
+{
+    if (!m_index.isValid() || m_playhead < 0)
+        return false;
+
+    int depth = m_depth.load(std::memory_order_relaxed);
+    int lastFrame = m_index.frameCount() - 1;
+
+    if (m_direction > 0)
+    {
+        int end = qMin(lastFrame, m_playhead + depth);
+        for (int i = m_playhead; i <= end; ++i)
+        {
+            if (!m_cache->contains(i))
+            {
+                *range = {i, end, 1};
+                return true;
+            }
+        }
+    }
+    else
+    {
+        // Backward: one pass from the keyframe covering the closest missing frame
+        int end = qMax(0, m_playhead - depth);
+        for (int i = m_playhead; i >= end; --i)
+        {
+            if (!m_cache->contains(i))
+            {
+                *range = {qMax(end, m_index.keyframeAtOrBefore(i)), i, -1};
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+int ReadAheadDecoder::nextPrefetchLocked() const
+{
+    for (int frameIndex : m_prefetchTargets)
+    {
+        if (frameIndex >= 0 && frameIndex < m_index.frameCount() && !m_cache->contains(frameIndex))
+            return frameIndex;
+    }
+    return -1;
+}
+
+void ReadAheadDecoder::updateDepthLocked()
+{
+    if (m_stepClock.isValid())
+    {
+        // Smooth the step interval so one slow timer tick doesn't collapse the lookahead
+        double interval = static_cast<double>(m_stepClock.restart());
+        m_stepIntervalMs = m_stepIntervalMs * 0.7 + interval * 0.3;
+    }
+    else
+    {
+        m_stepClock.start();
+    }
+
+    // The window has to fit in the cache next to the frames behind the playhead
+    int maxDepth = qMax(kMinLookaheadFrames, m_cache->maxFrames() / 2);
+    int depth = qBound(kMinLookaheadFrames, qCeil(kLookaheadMs / qMax(1.0, m_stepIntervalMs)), maxDepth);
+    m_depth.store(depth, std::memory_order_relaxed);
+}
@@ -0,0 +1,125 @@
+#ifndef READAHEADDECODER_H
+#define READAHEADDECODER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <atomic>
+#include "FrameCache.h"
+#include "FrameIndex.h"
+#include "SharpnessTrack.h"
+#include "VideoDecoder.h"
+
+/**
+ * Worker thread that keeps the frame cache filled around the playhead.
+ *
+ * Each playhead update makes the worker decode any uncached frames in the
+ * stepping direction. While a step key is held, the lookahead depth follows
+ * the measured step rate so the GUI thread only ever has to blit frames that
+ * are already decoded.
+ *
+ * When the playhead's window is full it decodes any prefetch targets, the
+ * frames the user is expected to jump to next.
+ *
+ * Every frame it decodes is also scored for sharpness, since the pixels are
+ * already hot in cache and the score outlives the cached frame.
+ */
+class ReadAheadDecoder : public QThread
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param sharpness Receives the score of every decoded frame; may be nullptr
+     */
+    ReadAheadDecoder(FrameCache *cache, SharpnessTrack *sharpness, QObject *parent = nullptr);
+    ~ReadAheadDecoder() override;
+
+    /**
+     * Switch to a new video; the decoder is (re)opened on the worker thread
+     */
+    void openVideo(const QString &videoPath, const FrameIndex &index);
+
+    /**
+     * Drop the current video and abort any decoding in flight
+     */
+    void closeVideo();
+
+    /**
+     * Report the frame now on screen and the direction the user is moving in
+     * @param direction +1 forward, -1 backward
+     */
+    void setPlayhead(int frameIndex, int direction);
+
+    /**
+     * Start or stop held-key read-ahead
+     * @param direction +1/-1 while a step key is held, 0 when released
+     */
+    void setHeldDirection(int direction);
+
+    /**
+     * Frames to decode once the window around the playhead is filled
+     * They are pinned in the cache until the next call, so a jump to one of
+     * them is a cache hit however far away it is. Replaces the previous targets.
+     */
+    void setPrefetchTargets(const QVector<int> &frameIndices);
+
+    /**
+     * Whether the worker has the current video open for decoding
+     * False until the open completes, and for good if libav can't decode the video.
+     */
+    bool isVideoOpen() const { return m_videoOpen.load(std::memory_order_acquire); }
+
+    /**
+     * Current number of frames decoded ahead of the playhead
+     */
+    int lookaheadDepth() const { return m_depth.load(std::memory_order_relaxed); }
+
+    /**
+     * Stop the worker thread and wait for it to exit
+     */
+    void stop();
+
+protected:
+    void run() override;
+
+private:
+    struct Range
+    {
+        int first;
+        int last;
+        int direction;
+    };
+
+    bool nextRangeLocked(Range *range) const;
+    int nextPrefetchLocked() const;
+    void updateDepthLocked();
+
+    FrameCache *m_cache;
+    SharpnessTrack *m_sharpness;
+    VideoDecoder m_decoder; // Only touched from the worker thread
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wakeCondition;
+    QString m_pendingPath;
+    FrameIndex m_pendingIndex;
+    FrameIndex m_index;
+    bool m_openPending;
+    bool m_fillPending;
+    bool m_quit;
+    int m_playhead;
+    int m_direction;
+    int m_heldDirection;
+    QVector<int> m_prefetchTargets; // Nearest first
+
+    // Step rate measurement for adaptive lookahead
+    QElapsedTimer m_stepClock;
+    double m_stepIntervalMs;
+
+    std::atomic_int m_generation; // Bumped on every video change to abort stale decodes
+    std::atomic_int m_depth;
+    std::atomic_bool m_videoOpen;
+};
+
+#endif // READAHEADDECODER_H
@@ -0,0 +1,138 @@
+#include "SceneDetector.h"
+#include "Logger.h"
+#include "SceneMetrics.h"
+#include "VideoDecoder.h"
+#include <QElapsedTimer>
+#include <memory>
+
+// A cut must change the picture clearly in absolute terms...
+static constexpr double kMinThumbnailDifference = 12.0;
+static constexpr double kMinHistogramDistance = 0.2;
+// ...and relative to the motion of the preceding frames, so fast pans don't count
+static constexpr double kAverageMultiplier = 3.0;
+static constexpr int kAverageWindow = 16;
+// Shots shorter than this are flashes or fast cutting, not separate scenes
+static constexpr qint64 kMinSceneMs = 400;
+// How often new candidates are handed to the GUI
+static constexpr qint64 kReportIntervalMs = 250;
+
+SceneDetector::SceneDetector(QObject *parent)
+    : QThread(parent), m_cancelled(false)
+{
+}
+
+SceneDetector::~SceneDetector()
+{
+    cancel();
+    wait();
+}
+
+void SceneDetector::setJob(const QString &videoPath, const FrameIndex &index)
+{
+    m_videoPath = videoPath;
+    m_index = index;
+    m_cancelled.store(false);
+}
+
+void SceneDetector::cancel()
+{
+    m_cancelled.store(true);
+}
+
+void SceneDetector::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Leave half the cores to playback and read-ahead; the pass runs while the user works
+    VideoDecoder decoder;
+    decoder.setFastDecode(true);
+    decoder.setThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+    if (!m_index.isValid() || !decoder.open(m_videoPath, m_index))
+    {
+        LOG_ERROR("Scene detection: cannot open {}", m_videoPath.toStdString());
+        emit analysisFinished(0, 0.0, isCancelled());
+        return;
+    }
+
+    int total = m_index.frameCount();
+    // Two signatures, swapped every frame; each is a few KB
+    auto current = std::make_unique<SceneMetrics::Signature>();
+    auto previous = std::make_unique<SceneMetrics::Signature>();
+    bool havePrevious = false;
+
+    double recent[kAverageWindow] = {};
+    int recentCount = 0;
+    double recentSum = 0.0;
+    qint64 lastCutMs = 0;
+    int cuts = 0;
+    int analysed = 0;
+    QVector<qint64> pending;
+    qint64 lastReport = 0;
+
+    bool ok = decoder.scanLuma(0, [&](int frameIndex, const uint8_t *luma, int stride, int width, int height)
+                               {
+        if (isCancelled())
+            return false;
+
+        SceneMetrics::compute(luma, stride, width, height, *current);
+        ++analysed;
+        if (havePrevious)
+        {
+            double difference = SceneMetrics::thumbnailDifference(*current, *previous);
+            double histogram = SceneMetrics::histogramDistance(*current, *previous);
+            double average = recentCount > 0 ? recentSum / recentCount : 0.0;
+            qint64 timestamp = m_index.timestampMs(frameIndex);
+
+            if (difference >= kMinThumbnailDifference && histogram >= kMinHistogramDistance &&
+                difference >= kAverageMultiplier * average && timestamp - lastCutMs >= kMinSceneMs)
+            {
+                LOG_DEBUG("Scene detection: cut at frame {} ({}ms), difference {:.1f} (average {:.1f}), histogram {:.2f}",
+                          frameIndex, timestamp, difference, average, histogram);
+                pending.append(timestamp);
+                lastCutMs = timestamp;
+                ++cuts;
+            }
+
+            // Rolling average of the recent frame-to-frame differences
+            int slot = analysed % kAverageWindow;
+            if (recentCount == kAverageWindow)
+                recentSum -= recent[slot];
+            else
+                ++recentCount;
+            recent[slot] = difference;
+            recentSum += difference;
+        }
+        std::swap(current, previous);
+        havePrevious = true;
+
+        if (timer.elapsed() - lastReport >= kReportIntervalMs)
+        {
+            lastReport = timer.elapsed();
+            if (!pending.isEmpty())
+            {
+                emit cutsFound(pending);
+                pending.clear();
+            }
+            emit progress(analysed, total);
+        }
+        return true; });
+
+    if (!pending.isEmpty())
+    {
+        emit cutsFound(pending);
+    }
+    emit progress(analysed, total);
+
+    double seconds = timer.elapsed() / 1000.0;
+    double framesPerSecond = seconds > 0 ? analysed / seconds : 0.0;
+    if (!ok && !isCancelled())
+    {
+        LOG_ERROR("Scene detection: decoding {} failed after {} frames", m_videoPath.toStdString(), analysed);
+    }
+    LOG_INFO("Scene detection: {} cuts in {} of {} frames, {:.0f} frames/s ({:.1f}x real time){}",
+             cuts, analysed, total, framesPerSecond,
+             m_index.averageFrameRate() > 0 ? framesPerSecond / m_index.averageFrameRate() : 0.0,
+             isCancelled() ? " - cancelled" : "");
+    emit analysisFinished(cuts, framesPerSecond, isCancelled());
+}
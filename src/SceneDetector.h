@@ -0,0 +1,58 @@
+#ifndef SCENEDETECTOR_H
+#define SCENEDETECTOR_H
+
+#include <QThread>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include "FrameIndex.h"
+
+/**
+ * Background pass that finds shot changes in a video.
+ *
+ * Decodes the whole video once with a fast, low-quality decoder configuration,
+ * reduces each frame's luma to a SceneMetrics signature and compares it with
+ * the previous frame. A frame is a cut candidate when both its thumbnail
+ * difference and histogram distance jump well above the recent average.
+ * Candidates are reported in small batches while the pass runs, so markers
+ * appear on the timeline long before it finishes.
+ */
+class SceneDetector : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit SceneDetector(QObject *parent = nullptr);
+    ~SceneDetector() override;
+
+    /**
+     * Configure the next pass; call before start()
+     * @param index Frame index for the video; must be valid
+     */
+    void setJob(const QString &videoPath, const FrameIndex &index);
+
+    void cancel();
+    bool isCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+signals:
+    /**
+     * New cut candidates since the last emission, as frame start times in ms, ascending
+     */
+    void cutsFound(const QVector<qint64> &timestamps);
+    void progress(int analysedFrames, int totalFrames);
+
+    /**
+     * @param framesPerSecond Analysis speed; above the video's frame rate means faster than real time
+     */
+    void analysisFinished(int cuts, double framesPerSecond, bool cancelled);
+
+protected:
+    void run() override;
+
+private:
+    QString m_videoPath;
+    FrameIndex m_index;
+    std::atomic_bool m_cancelled;
+};
+
+#endif // SCENEDETECTOR_H
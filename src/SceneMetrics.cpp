@@ -0,0 +1,216 @@
+#include "SceneMetrics.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PICKER_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(PICKER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PICKER_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PICKER_TARGET(isa)
+#endif
+
+namespace
+{
+    // Rows summed per thumbnail block; taller blocks are sampled on a stride
+    constexpr int kRowsPerBlock = 8;
+
+    void accumulateRowScalar(const uint8_t *row, uint16_t *sums, int width)
+    {
+        for (int x = 0; x < width; ++x)
+            sums[x] = static_cast<uint16_t>(sums[x] + row[x]);
+    }
+
+    uint64_t sadScalar(const uint8_t *a, const uint8_t *b, size_t size)
+    {
+        uint64_t total = 0;
+        for (size_t i = 0; i < size; ++i)
+            total += static_cast<uint64_t>(std::abs(a[i] - b[i]));
+        return total;
+    }
+
+#ifdef PICKER_X86
+    PICKER_TARGET("sse4.1")
+    void accumulateRowSse41(const uint8_t *row, uint16_t *sums, int width)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+            __m128i *low = reinterpret_cast<__m128i *>(sums + x);
+            __m128i *high = reinterpret_cast<__m128i *>(sums + x + 8);
+            _mm_storeu_si128(low, _mm_add_epi16(_mm_loadu_si128(low), _mm_unpacklo_epi8(pixels, zero)));
+            _mm_storeu_si128(high, _mm_add_epi16(_mm_loadu_si128(high), _mm_unpackhi_epi8(pixels, zero)));
+        }
+        accumulateRowScalar(row + x, sums + x, width - x);
+    }
+
+    PICKER_TARGET("sse4.1")
+    uint64_t sadSse41(const uint8_t *a, const uint8_t *b, size_t size)
+    {
+        __m128i total = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+            total = _mm_add_epi64(total, _mm_sad_epu8(va, vb));
+        }
+        uint64_t lanes[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), total);
+        return lanes[0] + lanes[1] + sadScalar(a + i, b + i, size - i);
+    }
+
+    PICKER_TARGET("avx2")
+    void accumulateRowAvx2(const uint8_t *row, uint16_t *sums, int width)
+    {
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            __m256i pixels = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x)));
+            __m256i *accumulator = reinterpret_cast<__m256i *>(sums + x);
+            _mm256_storeu_si256(accumulator, _mm256_add_epi16(_mm256_loadu_si256(accumulator), pixels));
+        }
+        accumulateRowScalar(row + x, sums + x, width - x);
+    }
+
+    PICKER_TARGET("avx2")
+    uint64_t sadAvx2(const uint8_t *a, const uint8_t *b, size_t size)
+    {
+        __m256i total = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+            total = _mm256_add_epi64(total, _mm256_sad_epu8(va, vb));
+        }
+        uint64_t lanes[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), total);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sadScalar(a + i, b + i, size - i);
+    }
+#endif
+
+    using AccumulateRowFunction = void (*)(const uint8_t *, uint16_t *, int);
+    using SadFunction = uint64_t (*)(const uint8_t *, const uint8_t *, size_t);
+
+    ColorConversion::Kernel resolve(ColorConversion::Kernel kernel)
+    {
+        if (kernel == ColorConversion::Kernel::Auto || !ColorConversion::isSupported(kernel))
+            return ColorConversion::bestKernel();
+        return kernel;
+    }
+
+    AccumulateRowFunction accumulateRowFunction(ColorConversion::Kernel kernel)
+    {
+        switch (kernel)
+        {
+#ifdef PICKER_X86
+        case ColorConversion::Kernel::AVX2:
+            return accumulateRowAvx2;
+        case ColorConversion::Kernel::SSE41:
+            return accumulateRowSse41;
+#endif
+        default:
+            return accumulateRowScalar;
+        }
+    }
+
+    SadFunction sadFunction(ColorConversion::Kernel kernel)
+    {
+        switch (kernel)
+        {
+#ifdef PICKER_X86
+        case ColorConversion::Kernel::AVX2:
+            return sadAvx2;
+        case ColorConversion::Kernel::SSE41:
+            return sadSse41;
+#endif
+        default:
+            return sadScalar;
+        }
+    }
+}
+
+void SceneMetrics::compute(const uint8_t *luma, int stride, int width, int height, Signature &signature, Kernel kernel)
+{
+    std::memset(signature.thumbnail, 0, sizeof(signature.thumbnail));
+    std::memset(signature.histogram, 0, sizeof(signature.histogram));
+    if (!luma || width <= 0 || height <= 0)
+    {
+        signature.histogram[0] = kThumbnailSize;
+        return;
+    }
+
+    const AccumulateRowFunction accumulateRow = accumulateRowFunction(resolve(kernel));
+
+    // Column sums of the sampled rows of one block row; kRowsPerBlock rows fit easily in 16 bits
+    std::vector<uint16_t> columnSums(static_cast<size_t>(width));
+    for (int by = 0; by < kThumbnailHeight; ++by)
+    {
+        int y0 = by * height / kThumbnailHeight;
+        int y1 = std::max(y0 + 1, (by + 1) * height / kThumbnailHeight);
+        int rowStep = (y1 - y0 + kRowsPerBlock - 1) / kRowsPerBlock;
+
+        std::fill(columnSums.begin(), columnSums.end(), 0);
+        int rows = 0;
+        for (int y = y0; y < y1; y += rowStep, ++rows)
+        {
+            accumulateRow(luma + static_cast<ptrdiff_t>(y) * stride, columnSums.data(), width);
+        }
+
+        uint8_t *out = signature.thumbnail + by * kThumbnailWidth;
+        for (int bx = 0; bx < kThumbnailWidth; ++bx)
+        {
+            int x0 = bx * width / kThumbnailWidth;
+            int x1 = std::max(x0 + 1, (bx + 1) * width / kThumbnailWidth);
+            uint32_t sum = 0;
+            for (int x = x0; x < x1; ++x)
+                sum += columnSums[x];
+            uint32_t count = static_cast<uint32_t>(rows * (x1 - x0));
+            out[bx] = static_cast<uint8_t>((sum + count / 2) / count);
+        }
+    }
+
+    // Four interleaved partial histograms avoid back-to-back increments of the same bin
+    uint32_t partial[4][kHistogramBins] = {};
+    const int shift = 8 - 6; // 256 levels into 64 bins
+    int i = 0;
+    for (; i + 4 <= kThumbnailSize; i += 4)
+    {
+        ++partial[0][signature.thumbnail[i] >> shift];
+        ++partial[1][signature.thumbnail[i + 1] >> shift];
+        ++partial[2][signature.thumbnail[i + 2] >> shift];
+        ++partial[3][signature.thumbnail[i + 3] >> shift];
+    }
+    for (; i < kThumbnailSize; ++i)
+        ++partial[0][signature.thumbnail[i] >> shift];
+    for (int bin = 0; bin < kHistogramBins; ++bin)
+        signature.histogram[bin] = partial[0][bin] + partial[1][bin] + partial[2][bin] + partial[3][bin];
+}
+
+double SceneMetrics::thumbnailDifference(const Signature &a, const Signature &b, Kernel kernel)
+{
+    return static_cast<double>(sad(a.thumbnail, b.thumbnail, kThumbnailSize, kernel)) / kThumbnailSize;
+}
+
+double SceneMetrics::histogramDistance(const Signature &a, const Signature &b)
+{
+    uint32_t distance = 0;
+    for (int bin = 0; bin < kHistogramBins; ++bin)
+    {
+        distance += a.histogram[bin] > b.histogram[bin] ? a.histogram[bin] - b.histogram[bin] : b.histogram[bin] - a.histogram[bin];
+    }
+    return distance / (2.0 * kThumbnailSize);
+}
+
+uint64_t SceneMetrics::sad(const uint8_t *a, const uint8_t *b, size_t size, Kernel kernel)
+{
+    return sadFunction(resolve(kernel))(a, b, size);
+}
@@ -0,0 +1,59 @@
+#ifndef SCENEMETRICS_H
+#define SCENEMETRICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "ColorConversion.h"
+
+/**
+ * Per-frame signatures for shot-change detection.
+ *
+ * A frame's luma plane is reduced to a 64x36 block-average thumbnail and a
+ * 64-bin histogram of that thumbnail. Consecutive signatures are compared by
+ * mean absolute difference (motion and content change) and histogram distance
+ * (global brightness and colour change). A hard cut moves both; a pan
+ * moves only the first and a fade mostly the second.
+ *
+ * Reduction and SAD use the same runtime-selected SIMD kernels as ColorConversion.
+ */
+class SceneMetrics
+{
+public:
+    static constexpr int kThumbnailWidth = 64;
+    static constexpr int kThumbnailHeight = 36;
+    static constexpr int kThumbnailSize = kThumbnailWidth * kThumbnailHeight;
+    static constexpr int kHistogramBins = 64;
+
+    using Kernel = ColorConversion::Kernel;
+
+    struct Signature
+    {
+        alignas(32) uint8_t thumbnail[kThumbnailSize];
+        uint32_t histogram[kHistogramBins];
+    };
+
+    /**
+     * Compute the signature of an 8-bit luma plane
+     * Large frames are sampled on every few rows of each block, which is plenty
+     * for shot detection and keeps the pass well below the cost of decoding.
+     */
+    static void compute(const uint8_t *luma, int stride, int width, int height, Signature &signature,
+                        Kernel kernel = Kernel::Auto);
+
+    /**
+     * Mean absolute difference of two thumbnails, 0-255
+     */
+    static double thumbnailDifference(const Signature &a, const Signature &b, Kernel kernel = Kernel::Auto);
+
+    /**
+     * Half the L1 distance between two normalised histograms, 0 (same) to 1 (disjoint)
+     */
+    static double histogramDistance(const Signature &a, const Signature &b);
+
+    /**
+     * Sum of absolute differences of two byte buffers
+     */
+    static uint64_t sad(const uint8_t *a, const uint8_t *b, size_t size, Kernel kernel = Kernel::Auto);
+};
+
+#endif // SCENEMETRICS_H
@@ -0,0 +1,215 @@
+#include "SharpnessMetrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PICKER_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(PICKER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PICKER_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PICKER_TARGET(isa)
+#endif
+
+namespace
+{
+    // Rows scored per frame; taller frames are sampled on a stride
+    constexpr int kMaxRows = 256;
+    // Pixels per SIMD chunk before the 32-bit lane sums are widened; keeps squared sums from overflowing
+    constexpr int kChunkPixels = 4096;
+
+    struct Sums
+    {
+        int64_t laplacian = 0;
+        int64_t laplacianSquared = 0;
+        int64_t gradient = 0;
+    };
+
+    inline int green(uint32_t pixel)
+    {
+        return static_cast<int>((pixel >> 8) & 0xFF);
+    }
+
+    // Scores pixels [first, last) of the middle row
+    void scoreRowScalar(const uint32_t *up, const uint32_t *mid, const uint32_t *down, int first, int last, Sums &sums)
+    {
+        for (int x = first; x < last; ++x)
+        {
+            int centre = green(mid[x]);
+            int right = green(mid[x + 1]);
+            int below = green(down[x]);
+            int laplacian = 4 * centre - green(mid[x - 1]) - right - green(up[x]) - below;
+            int dx = right - centre;
+            int dy = below - centre;
+            sums.laplacian += laplacian;
+            sums.laplacianSquared += laplacian * laplacian;
+            sums.gradient += dx * dx + dy * dy;
+        }
+    }
+
+#ifdef PICKER_X86
+    PICKER_TARGET("sse4.1")
+    inline __m128i greenSse41(const uint32_t *pixels)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels));
+        return _mm_and_si128(_mm_srli_epi32(v, 8), _mm_set1_epi32(0xFF));
+    }
+
+    PICKER_TARGET("sse4.1")
+    int64_t horizontalSumSse41(__m128i v)
+    {
+        int32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), v);
+        return static_cast<int64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+
+    PICKER_TARGET("sse4.1")
+    void scoreRowSse41(const uint32_t *up, const uint32_t *mid, const uint32_t *down, int first, int last, Sums &sums)
+    {
+        int x = first;
+        while (x + 4 <= last)
+        {
+            int chunkEnd = std::min(last, x + kChunkPixels);
+            __m128i laplacianSum = _mm_setzero_si128();
+            __m128i squaredSum = _mm_setzero_si128();
+            __m128i gradientSum = _mm_setzero_si128();
+            for (; x + 4 <= chunkEnd; x += 4)
+            {
+                __m128i centre = greenSse41(mid + x);
+                __m128i right = greenSse41(mid + x + 1);
+                __m128i below = greenSse41(down + x);
+                __m128i neighbours = _mm_add_epi32(_mm_add_epi32(greenSse41(mid + x - 1), right),
+                                                   _mm_add_epi32(greenSse41(up + x), below));
+                __m128i laplacian = _mm_sub_epi32(_mm_slli_epi32(centre, 2), neighbours);
+                __m128i dx = _mm_sub_epi32(right, centre);
+                __m128i dy = _mm_sub_epi32(below, centre);
+                laplacianSum = _mm_add_epi32(laplacianSum, laplacian);
+                squaredSum = _mm_add_epi32(squaredSum, _mm_mullo_epi32(laplacian, laplacian));
+                gradientSum = _mm_add_epi32(gradientSum, _mm_add_epi32(_mm_mullo_epi32(dx, dx), _mm_mullo_epi32(dy, dy)));
+            }
+            sums.laplacian += horizontalSumSse41(laplacianSum);
+            sums.laplacianSquared += horizontalSumSse41(squaredSum);
+            sums.gradient += horizontalSumSse41(gradientSum);
+        }
+        scoreRowScalar(up, mid, down, x, last, sums);
+    }
+
+    PICKER_TARGET("avx2")
+    inline __m256i greenAvx2(const uint32_t *pixels)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pixels));
+        return _mm256_and_si256(_mm256_srli_epi32(v, 8), _mm256_set1_epi32(0xFF));
+    }
+
+    PICKER_TARGET("avx2")
+    int64_t horizontalSumAvx2(__m256i v)
+    {
+        int32_t lanes[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), v);
+        int64_t total = 0;
+        for (int32_t lane : lanes)
+            total += lane;
+        return total;
+    }
+
+    PICKER_TARGET("avx2")
+    void scoreRowAvx2(const uint32_t *up, const uint32_t *mid, const uint32_t *down, int first, int last, Sums &sums)
+    {
+        int x = first;
+        while (x + 8 <= last)
+        {
+            int chunkEnd = std::min(last, x + kChunkPixels);
+            __m256i laplacianSum = _mm256_setzero_si256();
+            __m256i squaredSum = _mm256_setzero_si256();
+            __m256i gradientSum = _mm256_setzero_si256();
+            for (; x + 8 <= chunkEnd; x += 8)
+            {
+                __m256i centre = greenAvx2(mid + x);
+                __m256i right = greenAvx2(mid + x + 1);
+                __m256i below = greenAvx2(down + x);
+                __m256i neighbours = _mm256_add_epi32(_mm256_add_epi32(greenAvx2(mid + x - 1), right),
+                                                      _mm256_add_epi32(greenAvx2(up + x), below));
+                __m256i laplacian = _mm256_sub_epi32(_mm256_slli_epi32(centre, 2), neighbours);
+                __m256i dx = _mm256_sub_epi32(right, centre);
+                __m256i dy = _mm256_sub_epi32(below, centre);
+                laplacianSum = _mm256_add_epi32(laplacianSum, laplacian);
+                squaredSum = _mm256_add_epi32(squaredSum, _mm256_mullo_epi32(laplacian, laplacian));
+                gradientSum = _mm256_add_epi32(gradientSum, _mm256_add_epi32(_mm256_mullo_epi32(dx, dx), _mm256_mullo_epi32(dy, dy)));
+            }
+            sums.laplacian += horizontalSumAvx2(laplacianSum);
+            sums.laplacianSquared += horizontalSumAvx2(squaredSum);
+            sums.gradient += horizontalSumAvx2(gradientSum);
+        }
+        scoreRowScalar(up, mid, down, x, last, sums);
+    }
+#endif
+
+    using ScoreRowFunction = void (*)(const uint32_t *, const uint32_t *, const uint32_t *, int, int, Sums &);
+
+    ScoreRowFunction scoreRowFunction(ColorConversion::Kernel kernel)
+    {
+        if (kernel == ColorConversion::Kernel::Auto || !ColorConversion::isSupported(kernel))
+            kernel = ColorConversion::bestKernel();
+
+        switch (kernel)
+        {
+#ifdef PICKER_X86
+        case ColorConversion::Kernel::AVX2:
+            return scoreRowAvx2;
+        case ColorConversion::Kernel::SSE41:
+            return scoreRowSse41;
+#endif
+        default:
+            return scoreRowScalar;
+        }
+    }
+}
+
+float SharpnessMetrics::Score::value() const
+{
+    if (!isValid())
+        return -1.0f;
+    return std::sqrt(laplacianVariance) + std::sqrt(gradientEnergy);
+}
+
+SharpnessMetrics::Score SharpnessMetrics::compute(const uint8_t *pixels, int width, int height, int stride, Kernel kernel)
+{
+    Score score;
+    if (!pixels || width < 3 || height < 3)
+        return score;
+
+    const ScoreRowFunction scoreRow = scoreRowFunction(kernel);
+    const int innerRows = height - 2;
+    const int rowStep = (innerRows + kMaxRows - 1) / kMaxRows;
+
+    // The last column has no right-hand neighbour and the first no left-hand one
+    Sums sums;
+    int64_t count = 0;
+    for (int y = 1; y <= innerRows; y += rowStep)
+    {
+        auto row = [pixels, stride](int r)
+        { return reinterpret_cast<const uint32_t *>(pixels + static_cast<ptrdiff_t>(r) * stride); };
+        scoreRow(row(y - 1), row(y), row(y + 1), 1, width - 1, sums);
+        count += width - 2;
+    }
+
+    double mean = static_cast<double>(sums.laplacian) / count;
+    score.laplacianVariance = static_cast<float>(std::max(0.0, static_cast<double>(sums.laplacianSquared) / count - mean * mean));
+    score.gradientEnergy = static_cast<float>(static_cast<double>(sums.gradient) / count);
+    return score;
+}
+
+SharpnessMetrics::Score SharpnessMetrics::compute(const QImage &image, Kernel kernel)
+{
+    if (image.isNull())
+        return Score();
+    if (image.depth() != 32)
+    {
+        QImage converted = image.convertToFormat(QImage::Format_RGB32);
+        return compute(converted.constBits(), converted.width(), converted.height(), static_cast<int>(converted.bytesPerLine()), kernel);
+    }
+    return compute(image.constBits(), image.width(), image.height(), static_cast<int>(image.bytesPerLine()), kernel);
+}
@@ -0,0 +1,48 @@
+#ifndef SHARPNESSMETRICS_H
+#define SHARPNESSMETRICS_H
+
+#include <QImage>
+#include <cstdint>
+#include "ColorConversion.h"
+
+/**
+ * Focus and motion-blur score of a decoded frame.
+ *
+ * Two classic no-reference measures are taken on the green channel, which
+ * carries most of the luma: the variance of the 4-neighbour Laplacian (fine
+ * detail) and the mean squared gradient (edge strength). A blurred frame
+ * loses both. Rows are sampled so that a 1080p frame costs a fraction of a
+ * millisecond, cheap enough to score every frame the read-ahead decodes.
+ *
+ * Uses the same runtime-selected SIMD kernels as ColorConversion.
+ */
+class SharpnessMetrics
+{
+public:
+    using Kernel = ColorConversion::Kernel;
+
+    struct Score
+    {
+        float laplacianVariance = -1.0f;
+        float gradientEnergy = -1.0f;
+
+        bool isValid() const { return laplacianVariance >= 0.0f; }
+
+        /**
+         * Single ranking value: both measures as RMS intensities, summed
+         */
+        float value() const;
+    };
+
+    /**
+     * Score 32-bit pixels (QImage::Format_RGB32/ARGB32 memory layout)
+     */
+    static Score compute(const uint8_t *pixels, int width, int height, int stride, Kernel kernel = Kernel::Auto);
+
+    /**
+     * Score any image; non-32-bit formats are converted first
+     */
+    static Score compute(const QImage &image, Kernel kernel = Kernel::Auto);
+};
+
+#endif // SHARPNESSMETRICS_H
@@ -0,0 +1,100 @@
+#include "SharpnessSparkline.h"
+#include "SharpnessTrack.h"
+#include "TimelineWidget.h"
+#include <QEvent>
+#include <QPainter>
+#include <algorithm>
+
+// Scores are polled rather than pushed; the read-ahead thread can score hundreds of frames a second
+static constexpr int kRefreshIntervalMs = 500;
+
+SharpnessSparkline::SharpnessSparkline(TimelineWidget *timeline, const SharpnessTrack *track, QWidget *parent)
+    : QWidget(parent), m_timeline(timeline), m_track(track), m_duration(0), m_revision(0)
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setToolTip("Frame sharpness (taller is sharper); gaps are frames not decoded yet");
+    timeline->installEventFilter(this);
+
+    m_refreshTimer.setInterval(kRefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &SharpnessSparkline::refresh);
+    m_refreshTimer.start();
+}
+
+void SharpnessSparkline::setFrameIndex(const FrameIndex &index)
+{
+    m_index = index;
+    m_values.clear();
+    m_revision = 0;
+    refresh();
+    update();
+}
+
+void SharpnessSparkline::setDuration(qint64 durationMs)
+{
+    m_duration = durationMs;
+    update();
+}
+
+QSize SharpnessSparkline::sizeHint() const
+{
+    return QSize(200, 16);
+}
+
+void SharpnessSparkline::refresh()
+{
+    if (!isVisible())
+        return;
+
+    quint64 revision = m_track->revision();
+    if (revision == m_revision)
+        return;
+    m_revision = revision;
+    m_values = m_track->values();
+    update();
+}
+
+bool SharpnessSparkline::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_timeline && (event->type() == QEvent::Resize || event->type() == QEvent::Move))
+    {
+        update();
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void SharpnessSparkline::paintEvent(QPaintEvent *)
+{
+    if (m_values.isEmpty() || m_duration <= 0 || m_values.size() != m_index.frameCount())
+        return;
+
+    // Same handle travel as the timeline, shifted into this widget's coordinates
+    int offset = mapFromGlobal(m_timeline->mapToGlobal(QPoint(0, 0))).x();
+
+    // Several frames share a pixel column at any useful zoom; keep the sharpest of each
+    QVector<float> columns(width(), -1.0f);
+    float maxValue = 0.0f;
+    for (int i = 0; i < m_values.size(); ++i)
+    {
+        float value = m_values[i];
+        if (value < 0.0f)
+            continue;
+        int x = qRound(offset + m_timeline->xForPosition(m_index.timestampMs(i)));
+        if (x < 0 || x >= columns.size())
+            continue;
+        columns[x] = std::max(columns[x], value);
+        maxValue = std::max(maxValue, value);
+    }
+    if (maxValue <= 0.0f)
+        return;
+
+    QPainter painter(this);
+    painter.setPen(QColor("#3a9ad9"));
+    int bottom = height() - 1;
+    for (int x = 0; x < columns.size(); ++x)
+    {
+        if (columns[x] < 0.0f)
+            continue;
+        int barHeight = qMax(1, qRound(columns[x] / maxValue * (height() - 1)));
+        painter.drawLine(x, bottom, x, bottom - barHeight + 1);
+    }
+}
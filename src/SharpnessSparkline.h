@@ -0,0 +1,56 @@
+#ifndef SHARPNESSSPARKLINE_H
+#define SHARPNESSSPARKLINE_H
+
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+#include "FrameIndex.h"
+
+class SharpnessTrack;
+class TimelineWidget;
+
+/**
+ * Thin bar graph of per-frame sharpness drawn under the timeline.
+ *
+ * Bars line up with the timeline's handle travel, so a dip under the handle
+ * means the frame on screen is blurrier than its neighbours. Frames that
+ * haven't been decoded yet leave gaps. The track is polled and only
+ * repainted when its revision changes.
+ */
+class SharpnessSparkline : public QWidget
+{
+    Q_OBJECT
+
+public:
+    SharpnessSparkline(TimelineWidget *timeline, const SharpnessTrack *track, QWidget *parent = nullptr);
+
+    /**
+     * Frame timestamps used to place scores on the timeline
+     */
+    void setFrameIndex(const FrameIndex &index);
+
+    /**
+     * Length of the video in ms; nothing is drawn until it is known
+     */
+    void setDuration(qint64 durationMs);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void refresh();
+
+private:
+    TimelineWidget *m_timeline;
+    const SharpnessTrack *m_track;
+    FrameIndex m_index;
+    qint64 m_duration;
+    QVector<float> m_values;
+    quint64 m_revision;
+    QTimer m_refreshTimer;
+};
+
+#endif // SHARPNESSSPARKLINE_H
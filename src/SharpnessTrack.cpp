@@ -0,0 +1,80 @@
+#include "SharpnessTrack.h"
+#include <QMutexLocker>
+#include <cstdlib>
+
+SharpnessTrack::SharpnessTrack()
+    : m_revision(0)
+{
+}
+
+void SharpnessTrack::reset(int frameCount)
+{
+    QMutexLocker locker(&m_mutex);
+    m_scores = QVector<SharpnessMetrics::Score>(qMax(0, frameCount));
+    m_revision.fetch_add(1, std::memory_order_relaxed);
+}
+
+int SharpnessTrack::frameCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_scores.size();
+}
+
+void SharpnessTrack::set(int frameIndex, const SharpnessMetrics::Score &score)
+{
+    QMutexLocker locker(&m_mutex);
+    if (frameIndex < 0 || frameIndex >= m_scores.size())
+        return;
+    m_scores[frameIndex] = score;
+    m_revision.fetch_add(1, std::memory_order_relaxed);
+}
+
+SharpnessMetrics::Score SharpnessTrack::score(int frameIndex) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (frameIndex < 0 || frameIndex >= m_scores.size())
+        return SharpnessMetrics::Score();
+    return m_scores[frameIndex];
+}
+
+QVector<int> SharpnessTrack::unscoredFrames(int firstFrame, int lastFrame) const
+{
+    QMutexLocker locker(&m_mutex);
+    QVector<int> frames;
+    for (int i = qMax(0, firstFrame); i <= qMin(lastFrame, m_scores.size() - 1); ++i)
+    {
+        if (!m_scores[i].isValid())
+            frames.append(i);
+    }
+    return frames;
+}
+
+int SharpnessTrack::sharpestFrame(int firstFrame, int lastFrame, int preferFrame) const
+{
+    QMutexLocker locker(&m_mutex);
+    int best = -1;
+    float bestValue = -1.0f;
+    for (int i = qMax(0, firstFrame); i <= qMin(lastFrame, m_scores.size() - 1); ++i)
+    {
+        float value = m_scores[i].value();
+        if (value < 0.0f)
+            continue;
+        if (value > bestValue || (value == bestValue && std::abs(i - preferFrame) < std::abs(best - preferFrame)))
+        {
+            best = i;
+            bestValue = value;
+        }
+    }
+    return best;
+}
+
+QVector<float> SharpnessTrack::values() const
+{
+    QMutexLocker locker(&m_mutex);
+    QVector<float> values(m_scores.size());
+    for (int i = 0; i < m_scores.size(); ++i)
+    {
+        values[i] = m_scores[i].value();
+    }
+    return values;
+}
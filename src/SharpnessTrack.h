@@ -0,0 +1,65 @@
+#ifndef SHARPNESSTRACK_H
+#define SHARPNESSTRACK_H
+
+#include <QMutex>
+#include <QVector>
+#include <atomic>
+#include "SharpnessMetrics.h"
+
+/**
+ * Sharpness scores of the current video, one slot per frame.
+ *
+ * Filled by whichever thread decodes a frame and kept after the frame leaves
+ * the decode cache, so the timeline graph and "snap to sharpest" can use
+ * every frame that has been decoded once. All methods are thread-safe.
+ */
+class SharpnessTrack
+{
+public:
+    SharpnessTrack();
+
+    /**
+     * Drop all scores and size the track for a new video
+     */
+    void reset(int frameCount);
+
+    int frameCount() const;
+
+    /**
+     * Store a frame's score; out-of-range frames are ignored
+     */
+    void set(int frameIndex, const SharpnessMetrics::Score &score);
+
+    /**
+     * @return The frame's score, invalid if it hasn't been scored yet
+     */
+    SharpnessMetrics::Score score(int frameIndex) const;
+
+    /**
+     * Frames in [firstFrame, lastFrame] that have no score yet, ascending
+     */
+    QVector<int> unscoredFrames(int firstFrame, int lastFrame) const;
+
+    /**
+     * Frame with the highest score in [firstFrame, lastFrame]; ties go to the frame closest to preferFrame
+     * @return -1 if no frame in the range has been scored
+     */
+    int sharpestFrame(int firstFrame, int lastFrame, int preferFrame) const;
+
+    /**
+     * Ranking value of every frame (Score::value(), negative when unscored)
+     */
+    QVector<float> values() const;
+
+    /**
+     * Incremented on every change, so readers can skip work when nothing moved
+     */
+    quint64 revision() const { return m_revision.load(std::memory_order_relaxed); }
+
+private:
+    mutable QMutex m_mutex;
+    QVector<SharpnessMetrics::Score> m_scores;
+    std::atomic<quint64> m_revision;
+};
+
+#endif // SHARPNESSTRACK_H
@@ -0,0 +1,165 @@
+#include "StallWatchdog.h"
+#include "Logger.h"
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+
+// Pings are checked this many times per threshold, so a stall is caught while it is still going on
+static constexpr int kChecksPerThreshold = 4;
+
+StallWatchdog::StallWatchdog(const QString &reportPath, int thresholdMs, QObject *parent)
+    : QThread(parent), m_reportPath(reportPath), m_thresholdMs(qMax(1, thresholdMs)),
+      m_watchedThreadId(Tracer::currentThreadId()), m_pongNs(-1), m_startNs(0), m_quit(false)
+{
+}
+
+StallWatchdog::~StallWatchdog()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_quit = true;
+        m_wakeCondition.wakeOne();
+    }
+    wait();
+}
+
+void StallWatchdog::setThreshold(int thresholdMs)
+{
+    m_thresholdMs.store(qMax(1, thresholdMs), std::memory_order_relaxed);
+}
+
+StallWatchdog::Stats StallWatchdog::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+void StallWatchdog::stop()
+{
+    if (!isRunning())
+        return;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_quit = true;
+        m_wakeCondition.wakeOne();
+    }
+    wait();
+
+    Stats stats = this->stats();
+    QJsonObject summary{
+        {"summary", true},
+        {"sessionMs", (Tracer::nowNs() - m_startNs) / 1000000},
+        {"thresholdMs", threshold()},
+        {"stalls", stats.stalls},
+        {"worstMs", stats.worstMs},
+        {"totalMs", stats.totalMs},
+        {"worstSpan", stats.worstSpan},
+    };
+    appendToReport(QJsonDocument(summary).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void StallWatchdog::run()
+{
+    Tracer::setThreadName("Stall watchdog");
+    m_startNs = Tracer::nowNs();
+    QFile report(m_reportPath);
+    if (!report.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        LOG_WARN("Stall watchdog: cannot write {}: {}", m_reportPath.toStdString(), report.errorString().toStdString());
+    }
+    report.close();
+    LOG_DEBUG("Stall watchdog started, threshold {}ms", threshold());
+
+    qint64 pingNs = -1;
+    bool stalled = false;
+    qint64 sampledNs = 0;
+    QVector<Tracer::ActiveSpan> spans;
+    while (true)
+    {
+        int thresholdMs = threshold();
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_quit)
+                break;
+            m_wakeCondition.wait(&m_mutex, static_cast<unsigned long>(qMax(1, thresholdMs / kChecksPerThreshold)));
+            if (m_quit)
+                break;
+        }
+
+        qint64 now = Tracer::nowNs();
+        qint64 pong = m_pongNs.load(std::memory_order_acquire);
+        if (pingNs < 0 || pong >= pingNs)
+        {
+            // Answered; a reply that was late but slipped in between checks still counts
+            if (pingNs >= 0 && pong - pingNs > thresholdMs * 1000000LL)
+            {
+                recordStall(pong - pingNs, sampledNs, spans);
+            }
+            stalled = false;
+            spans.clear();
+
+            pingNs = now;
+            QMetaObject::invokeMethod(this, [this]()
+                                      { m_pongNs.store(Tracer::nowNs(), std::memory_order_release); }, Qt::QueuedConnection);
+        }
+        else if (!stalled && now - pingNs > thresholdMs * 1000000LL)
+        {
+            // Sample while the thread is still stuck; by the time it answers the culprit has returned
+            stalled = true;
+            sampledNs = now;
+            spans = Tracer::activeSpans(m_watchedThreadId);
+            LOG_DEBUG("Stall watchdog: GUI thread unresponsive for {}ms in {}", (now - pingNs) / 1000000,
+                      spans.isEmpty() ? "untraced code" : spans.last().name);
+        }
+    }
+
+    LOG_DEBUG("Stall watchdog stopped");
+}
+
+void StallWatchdog::recordStall(qint64 durationNs, qint64 sampledNs, const QVector<Tracer::ActiveSpan> &spans)
+{
+    qint64 durationMs = durationNs / 1000000;
+    QString innermost = spans.isEmpty() ? QString() : QString::fromUtf8(spans.last().name);
+    {
+        QMutexLocker locker(&m_mutex);
+        ++m_stats.stalls;
+        m_stats.totalMs += durationMs;
+        if (durationMs > m_stats.worstMs)
+        {
+            m_stats.worstMs = durationMs;
+            m_stats.worstSpan = innermost;
+        }
+    }
+
+    LOG_WARN("GUI stalled for {}ms in {}", durationMs, innermost.isEmpty() ? std::string("untraced code") : innermost.toStdString());
+
+    QJsonArray active;
+    for (const Tracer::ActiveSpan &span : spans)
+    {
+        active.append(QJsonObject{
+            {"name", QString::fromUtf8(span.name)},
+            {"category", QString::fromUtf8(span.category)},
+            {"activeMs", (sampledNs - span.startNs) / 1000000}, // How long it had run when the stall was noticed
+        });
+    }
+    QJsonObject event{
+        {"time", QDateTime::currentDateTime().toString(Qt::ISODateWithMs)},
+        {"durationMs", durationMs},
+        {"thresholdMs", threshold()},
+        {"spans", active},
+    };
+    appendToReport(QJsonDocument(event).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void StallWatchdog::appendToReport(const QByteArray &line)
+{
+    QFile report(m_reportPath);
+    if (report.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        report.write(line);
+    }
+}
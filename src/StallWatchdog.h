@@ -0,0 +1,71 @@
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include "Tracer.h"
+
+/**
+ * Thread that notices when the GUI event loop stops responding.
+ *
+ * It keeps one ping queued on the event loop of the thread that created it.
+ * If a ping goes unanswered for longer than the threshold, it records which
+ * traced scopes that thread is inside. Once the loop catches up, it appends
+ * the stall to a JSON-lines report and logs a warning. stop() adds a
+ * summary line with the stall count and worst case, so a scripted session
+ * can check UI responsiveness from the report alone.
+ */
+class StallWatchdog : public QThread
+{
+    Q_OBJECT
+
+public:
+    struct Stats
+    {
+        int stalls = 0;
+        qint64 worstMs = 0;
+        qint64 totalMs = 0;
+        QString worstSpan; // Innermost traced scope during the worst stall, empty if none
+    };
+
+    /**
+     * Must be created on the thread to watch
+     * @param reportPath JSON-lines file, truncated when the watchdog starts
+     */
+    StallWatchdog(const QString &reportPath, int thresholdMs = 200, QObject *parent = nullptr);
+    ~StallWatchdog() override;
+
+    void setThreshold(int thresholdMs);
+    int threshold() const { return m_thresholdMs.load(std::memory_order_relaxed); }
+
+    Stats stats() const;
+
+    /**
+     * Stop watching and append the session summary to the report
+     */
+    void stop();
+
+protected:
+    void run() override;
+
+private:
+    void recordStall(qint64 durationNs, qint64 sampledNs, const QVector<Tracer::ActiveSpan> &spans);
+    void appendToReport(const QByteArray &line);
+
+    QString m_reportPath;
+    std::atomic_int m_thresholdMs;
+    int m_watchedThreadId; // Tracer id of the watched thread
+    std::atomic<qint64> m_pongNs; // When the watched thread last answered a ping
+    qint64 m_startNs;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wakeCondition;
+    bool m_quit;
+    Stats m_stats;
+};
+
+#endif // STALLWATCHDOG_H
@@ -0,0 +1,319 @@
+#include "TimelineWidget.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include <QElapsedTimer>
+#include <QHelpEvent>
+#include <QLine>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPainterPath>
+#include <QToolTip>
+#include <algorithm>
+
+// Handle radius; the handle's centre travels between these insets
+static constexpr int kHandleRadius = 7;
+static constexpr int kGrooveHeight = 8;
+// Markers stick out this far above and below the groove
+static constexpr int kMarkerOverhang = 3;
+// Clicks and hovers this close to a marker land on it
+static constexpr int kSnapPixels = 4;
+
+namespace
+{
+    QString formatPosition(qint64 ms)
+    {
+        return QString("%1:%2.%3")
+            .arg(ms / 60000, 2, 10, QChar('0'))
+            .arg((ms / 1000) % 60, 2, 10, QChar('0'))
+            .arg(ms % 1000, 3, 10, QChar('0'));
+    }
+}
+
+TimelineWidget::TimelineWidget(QWidget *parent)
+    : QAbstractSlider(parent), m_inPoint(-1), m_outPoint(-1), m_cacheValid(false)
+{
+    setOrientation(Qt::Horizontal);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setMouseTracking(true);
+}
+
+int TimelineWidget::addMarkerLayer(const QString &name, const QColor &color)
+{
+    m_layers.append({name, color, QVector<qint64>()});
+    return m_layers.size() - 1;
+}
+
+void TimelineWidget::setMarkers(int layer, const QVector<qint64> &timestamps)
+{
+    QVector<qint64> &markers = m_layers[layer].markers;
+    markers = timestamps;
+    std::sort(markers.begin(), markers.end());
+    invalidateCache();
+}
+
+void TimelineWidget::appendMarkers(int layer, const QVector<qint64> &timestamps)
+{
+    if (timestamps.isEmpty())
+        return;
+
+    QVector<qint64> &markers = m_layers[layer].markers;
+    qsizetype oldSize = markers.size();
+    markers += timestamps;
+    std::sort(markers.begin() + oldSize, markers.end());
+    std::inplace_merge(markers.begin(), markers.begin() + oldSize, markers.end());
+    invalidateCache();
+}
+
+void TimelineWidget::clearMarkers(int layer)
+{
+    if (m_layers[layer].markers.isEmpty())
+        return;
+    m_layers[layer].markers.clear();
+    invalidateCache();
+}
+
+void TimelineWidget::setInOutRange(qint64 inMs, qint64 outMs)
+{
+    if (inMs == m_inPoint && outMs == m_outPoint)
+        return;
+    m_inPoint = inMs;
+    m_outPoint = outMs;
+    invalidateCache();
+}
+
+double TimelineWidget::xForPosition(qint64 ms) const
+{
+    double span = qMax(1, width() - 2 * kHandleRadius);
+    qint64 length = qMax(1, maximum() - minimum());
+    return kHandleRadius + span * qBound(0.0, static_cast<double>(ms - minimum()) / length, 1.0);
+}
+
+qint64 TimelineWidget::positionForX(double x) const
+{
+    double span = qMax(1, width() - 2 * kHandleRadius);
+    double fraction = qBound(0.0, (x - kHandleRadius) / span, 1.0);
+    return minimum() + qRound64(fraction * (maximum() - minimum()));
+}
+
+qint64 TimelineWidget::markerNear(qint64 ms, qint64 toleranceMs, int *layer) const
+{
+    qint64 best = -1;
+    qint64 bestDistance = toleranceMs + 1;
+    for (int i = 0; i < m_layers.size(); ++i)
+    {
+        const QVector<qint64> &markers = m_layers[i].markers;
+        auto it = std::lower_bound(markers.cbegin(), markers.cend(), ms);
+        // Only the markers on either side of the position can be the closest
+        for (auto candidate : {it, it == markers.cbegin() ? markers.cend() : it - 1})
+        {
+            if (candidate == markers.cend())
+                continue;
+            qint64 distance = qAbs(*candidate - ms);
+            if (distance < bestDistance)
+            {
+                best = *candidate;
+                bestDistance = distance;
+                if (layer)
+                    *layer = i;
+            }
+        }
+    }
+    return best;
+}
+
+QSize TimelineWidget::sizeHint() const
+{
+    return QSize(200, 2 * kHandleRadius + 4);
+}
+
+QSize TimelineWidget::minimumSizeHint() const
+{
+    return QSize(4 * kHandleRadius, 2 * kHandleRadius + 4);
+}
+
+QRect TimelineWidget::grooveRect() const
+{
+    return QRect(1, (height() - kGrooveHeight) / 2, width() - 2, kGrooveHeight);
+}
+
+qint64 TimelineWidget::snapTolerance() const
+{
+    double span = qMax(1, width() - 2 * kHandleRadius);
+    return qRound64(kSnapPixels * static_cast<double>(maximum() - minimum()) / span);
+}
+
+qint64 TimelineWidget::snappedPosition(double x) const
+{
+    qint64 position = positionForX(x);
+    qint64 marker = markerNear(position, snapTolerance());
+    return marker >= 0 ? marker : position;
+}
+
+void TimelineWidget::invalidateCache()
+{
+    m_cacheValid = false;
+    update();
+}
+
+void TimelineWidget::rebuildCache()
+{
+    TRACE_SCOPE("timelineRebuild", "ui");
+    QElapsedTimer timer;
+    timer.start();
+
+    qreal ratio = devicePixelRatioF();
+    m_cache = QPixmap(size() * ratio);
+    m_cache.setDevicePixelRatio(ratio);
+    m_cache.fill(Qt::transparent);
+
+    QPainter painter(&m_cache);
+    painter.setRenderHint(QPainter::Antialiasing);
+    QRect groove = grooveRect();
+    bool enabled = isEnabled();
+
+    QPainterPath grooveShape;
+    grooveShape.addRoundedRect(QRectF(groove).adjusted(0.5, 0.5, -0.5, -0.5), kGrooveHeight / 2.0, kGrooveHeight / 2.0);
+    painter.fillPath(grooveShape, QColor("#cccccc"));
+
+    if (m_inPoint >= 0 || m_outPoint >= 0)
+    {
+        double left = m_inPoint >= 0 ? xForPosition(m_inPoint) : groove.left();
+        double right = m_outPoint >= 0 ? xForPosition(m_outPoint) : groove.right() + 1;
+        painter.save();
+        painter.setClipPath(grooveShape);
+        painter.fillRect(QRectF(left, groove.top(), qMax(1.0, right - left), groove.height()), QColor("#9cc9ef"));
+        painter.restore();
+    }
+    painter.setPen(QColor("#999999"));
+    painter.drawPath(grooveShape);
+
+    // Thousands of markers share a few hundred pixel columns; draw each column once per layer
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    int top = groove.top() - kMarkerOverhang;
+    int bottom = groove.bottom() + kMarkerOverhang;
+    QVector<QLine> lines;
+    for (const Layer &layer : m_layers)
+    {
+        lines.clear();
+        int lastX = -1;
+        for (qint64 marker : layer.markers)
+        {
+            int x = qRound(xForPosition(marker));
+            if (x == lastX)
+                continue;
+            lines.append(QLine(x, top, x, bottom));
+            lastX = x;
+        }
+        QColor color = layer.color;
+        if (!enabled)
+            color.setAlpha(96);
+        painter.setPen(QPen(color, 2));
+        painter.drawLines(lines);
+    }
+
+    m_cacheValid = true;
+    LOG_TRACE("Timeline: marker layer rebuilt in {}us", timer.nsecsElapsed() / 1000);
+}
+
+void TimelineWidget::paintEvent(QPaintEvent *)
+{
+    TRACE_SCOPE("timelinePaint", "ui");
+    if (!m_cacheValid || m_cache.size() != size() * devicePixelRatioF())
+    {
+        rebuildCache();
+    }
+
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, m_cache);
+
+    // The playhead follows the dragged position, not just the committed value
+    painter.setRenderHint(QPainter::Antialiasing);
+    QColor handleColor = isEnabled() ? QColor("#0078d4") : QColor("#a0a0a0");
+    painter.setPen(handleColor);
+    painter.setBrush(handleColor);
+    QPointF centre(xForPosition(sliderPosition()), height() / 2.0);
+    painter.drawEllipse(centre, kHandleRadius - 0.5, kHandleRadius - 0.5);
+}
+
+void TimelineWidget::resizeEvent(QResizeEvent *event)
+{
+    m_cacheValid = false;
+    QAbstractSlider::resizeEvent(event);
+}
+
+void TimelineWidget::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::EnabledChange)
+    {
+        m_cacheValid = false;
+    }
+    QAbstractSlider::changeEvent(event);
+}
+
+void TimelineWidget::sliderChange(SliderChange change)
+{
+    // Markers are placed relative to the range; a new video length moves them all
+    if (change == SliderRangeChange)
+    {
+        m_cacheValid = false;
+    }
+    update();
+    QAbstractSlider::sliderChange(change);
+}
+
+void TimelineWidget::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton || maximum() <= minimum())
+    {
+        event->ignore();
+        return;
+    }
+
+    // Jump straight to the click, landing exactly on a marker when one is under the cursor
+    setSliderDown(true);
+    setSliderPosition(static_cast<int>(snappedPosition(event->position().x())));
+    event->accept();
+}
+
+void TimelineWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!isSliderDown())
+    {
+        event->ignore();
+        return;
+    }
+    setSliderPosition(static_cast<int>(positionForX(event->position().x())));
+    event->accept();
+}
+
+void TimelineWidget::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (!isSliderDown() || event->button() != Qt::LeftButton)
+    {
+        event->ignore();
+        return;
+    }
+    setSliderDown(false);
+    event->accept();
+}
+
+bool TimelineWidget::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip)
+    {
+        auto *help = static_cast<QHelpEvent *>(event);
+        int layer = -1;
+        qint64 marker = markerNear(positionForX(help->pos().x()), snapTolerance(), &layer);
+        if (marker >= 0)
+        {
+            QToolTip::showText(help->globalPos(), QString("%1 at %2").arg(m_layers[layer].name, formatPosition(marker)), this);
+        }
+        else
+        {
+            QToolTip::hideText();
+            event->ignore();
+        }
+        return true;
+    }
+    return QAbstractSlider::event(event);
+}
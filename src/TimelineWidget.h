@@ -0,0 +1,105 @@
+#ifndef TIMELINEWIDGET_H
+#define TIMELINEWIDGET_H
+
+#include <QAbstractSlider>
+#include <QColor>
+#include <QPixmap>
+#include <QString>
+#include <QVector>
+
+/**
+ * Horizontal position slider that draws any number of time-marker layers
+ * and an in/out range on its groove.
+ *
+ * Values are positions in ms. The groove, range shading and every marker
+ * layer are rasterised into a pixmap that is only rebuilt when markers,
+ * range or size change. A repaint for a moving playhead just blits that
+ * pixmap and draws the handle, however many markers there are.
+ *
+ * Markers are kept sorted per layer. Hover tooltips and click snapping find
+ * the nearest one by binary search.
+ */
+class TimelineWidget : public QAbstractSlider
+{
+    Q_OBJECT
+
+public:
+    explicit TimelineWidget(QWidget *parent = nullptr);
+
+    /**
+     * Add a marker layer; later layers draw on top of earlier ones
+     * @param name Shown in hover tooltips, e.g. "Saved frame"
+     * @return Layer id for the other marker methods
+     */
+    int addMarkerLayer(const QString &name, const QColor &color);
+
+    /**
+     * Replace a layer's markers
+     * @param timestamps Positions in ms, any order
+     */
+    void setMarkers(int layer, const QVector<qint64> &timestamps);
+
+    /**
+     * Add markers to a layer
+     */
+    void appendMarkers(int layer, const QVector<qint64> &timestamps);
+
+    void clearMarkers(int layer);
+    const QVector<qint64> &markers(int layer) const { return m_layers[layer].markers; }
+
+    /**
+     * Shade the range between in and out points
+     * @param inMs Range start, -1 for the start of the video
+     * @param outMs Range end, -1 for the end of the video; both -1 hides the range
+     */
+    void setInOutRange(qint64 inMs, qint64 outMs);
+
+    /**
+     * Horizontal centre of the handle at a position, in widget coordinates
+     */
+    double xForPosition(qint64 ms) const;
+    qint64 positionForX(double x) const;
+
+    /**
+     * Marker closest to a position within a tolerance, across all layers
+     * @param layer Receives the marker's layer; may be nullptr
+     * @return The marker's position, or -1 if none is close enough
+     */
+    qint64 markerNear(qint64 ms, qint64 toleranceMs, int *layer = nullptr) const;
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
+    void sliderChange(SliderChange change) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    bool event(QEvent *event) override;
+
+private:
+    struct Layer
+    {
+        QString name;
+        QColor color;
+        QVector<qint64> markers; // Ascending
+    };
+
+    QRect grooveRect() const;
+    qint64 snapTolerance() const; // A few pixels, in ms
+    qint64 snappedPosition(double x) const;
+    void invalidateCache();
+    void rebuildCache();
+
+    QVector<Layer> m_layers;
+    qint64 m_inPoint;
+    qint64 m_outPoint;
+
+    QPixmap m_cache; // Groove, range and markers at the current size
+    bool m_cacheValid;
+};
+
+#endif // TIMELINEWIDGET_H
@@ -0,0 +1,321 @@
+#include "Tracer.h"
+#include "Logger.h"
+#include <QCoreApplication>
+#include <QSaveFile>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Spans kept per thread; the oldest are overwritten first
+static constexpr size_t kEventsPerThread = 8192;
+// Nesting depth of active scopes visible to other threads; deeper ones are counted but not named
+static constexpr int kMaxActiveDepth = 16;
+// Buffers of exited threads kept for the next dump; pool threads come and go all session
+static constexpr int kMaxExitedThreads = 16;
+
+namespace
+{
+    struct Event
+    {
+        const char *name;
+        const char *category;
+        qint64 startNs;
+        qint64 durationNs;
+    };
+
+    struct ActiveSlot
+    {
+        std::atomic<const char *> name{nullptr};
+        std::atomic<const char *> category{nullptr};
+        std::atomic<qint64> startNs{0};
+    };
+
+    struct ThreadBuffer
+    {
+        // Only contended while a trace is being written out
+        std::mutex mutex;
+        std::vector<Event> events;
+        size_t next = 0;
+        int threadId = 0;
+        QString name;
+
+        // Written only by the owning thread, read lock-free by anyone
+        std::array<ActiveSlot, kMaxActiveDepth> active;
+        std::atomic_int depth{0};
+
+        std::atomic_bool exited{false};
+    };
+
+    // Marks the buffer as orphaned when its thread exits
+    struct ThreadHandle
+    {
+        std::shared_ptr<ThreadBuffer> buffer;
+
+        ~ThreadHandle()
+        {
+            buffer->exited.store(true, std::memory_order_release);
+        }
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers; // An exited thread's buffer stays until the next dump, for at most kMaxExitedThreads threads
+        int nextThreadId = 1;
+        std::atomic_bool enabled{true};
+        const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    };
+
+    Registry &registry()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    std::shared_ptr<ThreadBuffer> registerThread()
+    {
+        auto created = std::make_shared<ThreadBuffer>();
+        Registry &shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        created->threadId = shared.nextThreadId++;
+        created->name = QString("Thread %1").arg(created->threadId);
+
+        // Drop the oldest exited threads beyond the cap
+        auto isExited = [](const std::shared_ptr<ThreadBuffer> &buffer)
+        { return buffer->exited.load(std::memory_order_acquire); };
+        auto excess = std::count_if(shared.buffers.begin(), shared.buffers.end(), isExited) - kMaxExitedThreads;
+        for (auto it = shared.buffers.begin(); excess > 0 && it != shared.buffers.end();)
+        {
+            if (isExited(*it))
+            {
+                it = shared.buffers.erase(it);
+                --excess;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        shared.buffers.push_back(created);
+        return created;
+    }
+
+    ThreadBuffer &threadBuffer()
+    {
+        thread_local ThreadHandle handle{registerThread()};
+        return *handle.buffer;
+    }
+
+    void appendJsonString(QByteArray &out, const QByteArray &text)
+    {
+        out += '"';
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20)
+                out += c;
+        }
+        out += '"';
+    }
+}
+
+Tracer::Scope::Scope(const char *name, const char *category, double warnMs)
+    : m_name(name), m_category(category), m_warnMs(warnMs), m_start(-1)
+{
+    if (warnMs > 0.0 || isEnabled())
+    {
+        m_start = nowNs();
+
+        ThreadBuffer &buffer = threadBuffer();
+        int depth = buffer.depth.load(std::memory_order_relaxed);
+        if (depth < kMaxActiveDepth)
+        {
+            ActiveSlot &slot = buffer.active[depth];
+            slot.name.store(name, std::memory_order_relaxed);
+            slot.category.store(category, std::memory_order_relaxed);
+            slot.startNs.store(m_start, std::memory_order_relaxed);
+        }
+        buffer.depth.store(depth + 1, std::memory_order_release);
+    }
+}
+
+Tracer::Scope::~Scope()
+{
+    if (m_start < 0)
+        return;
+
+    ThreadBuffer &buffer = threadBuffer();
+    buffer.depth.store(buffer.depth.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+
+    qint64 end = nowNs();
+    record(m_name, m_category, m_start, end);
+    if (m_warnMs > 0.0)
+    {
+        double ms = (end - m_start) / 1e6;
+        if (ms > m_warnMs)
+        {
+            LOG_WARN("{} took {:.1f}ms (may cause UI lag)", m_name, ms);
+        }
+    }
+}
+
+qint64 Tracer::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - registry().epoch).count();
+}
+
+void Tracer::record(const char *name, const char *category, qint64 startNs, qint64 endNs)
+{
+    if (!isEnabled())
+        return;
+
+    ThreadBuffer &buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    Event event{name, category, startNs, endNs - startNs};
+    if (buffer.events.size() < kEventsPerThread)
+    {
+        buffer.events.push_back(event);
+    }
+    else
+    {
+        buffer.events[buffer.next] = event;
+    }
+    buffer.next = (buffer.next + 1) % kEventsPerThread;
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    registry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Tracer::isEnabled()
+{
+    return registry().enabled.load(std::memory_order_relaxed);
+}
+
+void Tracer::setThreadName(const QString &name)
+{
+    ThreadBuffer &buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.name = name;
+}
+
+int Tracer::currentThreadId()
+{
+    return threadBuffer().threadId;
+}
+
+QVector<Tracer::ActiveSpan> Tracer::activeSpans(int threadId)
+{
+    std::shared_ptr<ThreadBuffer> buffer;
+    {
+        Registry &shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (const std::shared_ptr<ThreadBuffer> &candidate : shared.buffers)
+        {
+            if (candidate->threadId == threadId)
+            {
+                buffer = candidate;
+                break;
+            }
+        }
+    }
+
+    QVector<ActiveSpan> spans;
+    if (!buffer)
+        return spans;
+
+    int depth = qMin(buffer->depth.load(std::memory_order_acquire), kMaxActiveDepth);
+    for (int i = 0; i < depth; ++i)
+    {
+        const ActiveSlot &slot = buffer->active[i];
+        spans.append({slot.name.load(std::memory_order_relaxed), slot.category.load(std::memory_order_relaxed),
+                      slot.startNs.load(std::memory_order_relaxed)});
+    }
+    return spans;
+}
+
+int Tracer::writeChromeTrace(const QString &path, QString *error)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        Registry &shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        buffers = shared.buffers;
+    }
+
+    // Complete ("X") events in microseconds, plus one thread_name metadata event per thread
+    qint64 pid = QCoreApplication::applicationPid();
+    QByteArray out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    int written = 0;
+    bool first = true;
+    std::vector<std::shared_ptr<ThreadBuffer>> flushed; // Exited threads whose spans are all in this dump
+    for (const std::shared_ptr<ThreadBuffer> &buffer : buffers)
+    {
+        if (buffer->exited.load(std::memory_order_acquire))
+            flushed.push_back(buffer);
+
+        std::vector<Event> events;
+        QString name;
+        {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            events = buffer->events;
+            name = buffer->name;
+        }
+
+        if (!first)
+            out += ",\n";
+        first = false;
+        out += QString("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%1,\"tid\":%2,\"args\":{\"name\":")
+                   .arg(pid)
+                   .arg(buffer->threadId)
+                   .toUtf8();
+        appendJsonString(out, name.toUtf8());
+        out += "}}";
+
+        for (const Event &event : events)
+        {
+            out += ",\n{\"ph\":\"X\",\"name\":";
+            appendJsonString(out, event.name);
+            out += ",\"cat\":";
+            appendJsonString(out, event.category);
+            out += QString(",\"ts\":%1,\"dur\":%2,\"pid\":%3,\"tid\":%4}")
+                       .arg(event.startNs / 1000.0, 0, 'f', 3)
+                       .arg(event.durationNs / 1000.0, 0, 'f', 3)
+                       .arg(pid)
+                       .arg(buffer->threadId)
+                       .toUtf8();
+            ++written;
+        }
+    }
+    out += "\n]}\n";
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size() || !file.commit())
+    {
+        if (error)
+            *error = file.errorString();
+        LOG_ERROR("Tracer: cannot write {}: {}", path.toStdString(), file.errorString().toStdString());
+        return -1;
+    }
+
+    // Nothing more can arrive from an exited thread, so its buffer is done with
+    if (!flushed.empty())
+    {
+        Registry &shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.buffers.erase(std::remove_if(shared.buffers.begin(), shared.buffers.end(),
+                                            [&flushed](const std::shared_ptr<ThreadBuffer> &buffer)
+                                            { return std::find(flushed.begin(), flushed.end(), buffer) != flushed.end(); }),
+                             shared.buffers.end());
+    }
+
+    LOG_INFO("Tracer: wrote {} spans from {} threads to {}", written, buffers.size(), path.toStdString());
+    return written;
+}
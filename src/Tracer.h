@@ -0,0 +1,100 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * Scoped timing spans, recorded per thread and exportable as a Chrome trace.
+ *
+ * A TRACE_SCOPE at the top of a function records its start and duration on
+ * a steady nanosecond clock into a ring buffer owned by the calling thread,
+ * so recording never contends with other threads. The most recent spans of
+ * every thread can be written out at any time as Chrome trace event JSON,
+ * which chrome://tracing and ui.perfetto.dev open directly.
+ *
+ * Each thread also publishes the stack of scopes it is currently inside,
+ * so another thread (e.g. a stall watchdog) can see what it is doing.
+ *
+ * Span names and categories must be string literals; only the pointers are
+ * stored.
+ */
+class Tracer
+{
+public:
+    struct ActiveSpan
+    {
+        const char *name;
+        const char *category;
+        qint64 startNs;
+    };
+
+    class Scope
+    {
+    public:
+        /**
+         * @param warnMs Log a warning when the span takes longer than this; 0 never warns
+         */
+        Scope(const char *name, const char *category, double warnMs = 0.0);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *m_name;
+        const char *m_category;
+        double m_warnMs;
+        qint64 m_start; // -1 when tracing was off on entry and no warning is wanted
+    };
+
+    /**
+     * Nanoseconds on a steady clock since the tracer was first used
+     */
+    static qint64 nowNs();
+
+    /**
+     * Record a span that was timed by hand, e.g. one that starts and ends in different functions
+     */
+    static void record(const char *name, const char *category, qint64 startNs, qint64 endNs);
+
+    /**
+     * Turn recording on or off; on by default. Scopes with a warning threshold still time themselves.
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * Name the calling thread in exported traces
+     */
+    static void setThreadName(const QString &name);
+
+    /**
+     * Tracer's id for the calling thread, as used in exported traces
+     */
+    static int currentThreadId();
+
+    /**
+     * Scopes a thread is inside right now, outermost first; safe to call from any thread.
+     * Only the innermost 16 levels are tracked, and the answer can be stale by the time it returns.
+     */
+    static QVector<ActiveSpan> activeSpans(int threadId);
+
+    /**
+     * Write every buffered span as Chrome trace event JSON
+     * @param error Receives a description of the failure; may be nullptr
+     * @return Number of spans written, -1 on failure
+     */
+    static int writeChromeTrace(const QString &path, QString *error = nullptr);
+};
+
+#define TRACER_CONCAT_INNER(a, b) a##b
+#define TRACER_CONCAT(a, b) TRACER_CONCAT_INNER(a, b)
+
+// Time the rest of the enclosing block
+#define TRACE_SCOPE(name, category) Tracer::Scope TRACER_CONCAT(traceScope, __LINE__)(name, category)
+// Same, and log a warning when the block takes longer than warnMs
+#define TRACE_SCOPE_WARN(name, category, warnMs) Tracer::Scope TRACER_CONCAT(traceScope, __LINE__)(name, category, warnMs)
+
+#endif // TRACER_H
@@ -0,0 +1,394 @@
+#include "VideoDecoder.h"
+#include "Logger.h"
+#include "ColorConversion.h"
+#include "PerfStats.h"
+#include "Tracer.h"
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
+
+VideoDecoder::VideoDecoder()
+    : m_formatContext(nullptr), m_codecContext(nullptr), m_swsContext(nullptr), m_lumaSwsContext(nullptr), m_packet(nullptr), m_frame(nullptr), m_streamIndex(-1), m_threadCount(0), m_fastDecode(false), m_lastDecodedFrame(-1), m_draining(false)
+{
+}
+
+VideoDecoder::~VideoDecoder()
+{
+    close();
+}
+
+bool VideoDecoder::open(const QString &videoPath, const FrameIndex &index)
+{
+    close();
+
+    QByteArray path = videoPath.toUtf8();
+    if (avformat_open_input(&m_formatContext, path.constData(), nullptr, nullptr) < 0)
+    {
+        LOG_ERROR("Decoder: failed to open {}", videoPath.toStdString());
+        return false;
+    }
+
+    if (avformat_find_stream_info(m_formatContext, nullptr) < 0)
+    {
+        LOG_ERROR("Decoder: failed to read stream info for {}", videoPath.toStdString());
+        close();
+        return false;
+    }
+
+    const AVCodec *codec = nullptr;
+    m_streamIndex = av_find_best_stream(m_formatContext, AVMEDIA_TYPE_VIDEO, index.streamIndex(), -1, &codec, 0);
+    if (m_streamIndex < 0 || !codec)
+    {
+        LOG_ERROR("Decoder: no decodable video stream in {}", videoPath.toStdString());
+        close();
+        return false;
+    }
+
+    for (unsigned int i = 0; i < m_formatContext->nb_streams; ++i)
+    {
+        m_formatContext->streams[i]->discard = (static_cast<int>(i) == m_streamIndex) ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+    }
+
+    m_codecContext = avcodec_alloc_context3(codec);
+    avcodec_parameters_to_context(m_codecContext, m_formatContext->streams[m_streamIndex]->codecpar);
+    m_codecContext->thread_count = m_threadCount; // 0 lets libav pick one thread per core
+    m_codecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    if (m_fastDecode)
+    {
+        m_codecContext->skip_loop_filter = AVDISCARD_ALL;
+        m_codecContext->flags2 |= AV_CODEC_FLAG2_FAST;
+        m_codecContext->lowres = qMin(2, static_cast<int>(codec->max_lowres));
+    }
+
+    if (avcodec_open2(m_codecContext, codec, nullptr) < 0)
+    {
+        LOG_ERROR("Decoder: failed to open codec {} for {}", codec->name, videoPath.toStdString());
+        close();
+        return false;
+    }
+
+    m_packet = av_packet_alloc();
+    m_frame = av_frame_alloc();
+    m_videoPath = videoPath;
+    m_index = index;
+    m_lastDecodedFrame = -1;
+    m_draining = false;
+
+    LOG_INFO("Decoder: opened {} ({}, {}x{})", videoPath.toStdString(), codec->name,
+             m_codecContext->width, m_codecContext->height);
+    return true;
+}
+
+void VideoDecoder::close()
+{
+    if (m_swsContext)
+    {
+        sws_freeContext(m_swsContext);
+        m_swsContext = nullptr;
+    }
+    if (m_lumaSwsContext)
+    {
+        sws_freeContext(m_lumaSwsContext);
+        m_lumaSwsContext = nullptr;
+    }
+    av_frame_free(&m_frame);
+    av_packet_free(&m_packet);
+    avcodec_free_context(&m_codecContext);
+    avformat_close_input(&m_formatContext);
+
+    m_videoPath.clear();
+    m_index = FrameIndex();
+    m_streamIndex = -1;
+    m_lastDecodedFrame = -1;
+    m_draining = false;
+}
+
+bool VideoDecoder::decodeRange(int firstFrame, int lastFrame, const FrameCallback &callback)
+{
+    if (!isOpen() || !m_index.isValid())
+        return false;
+
+    firstFrame = qBound(0, firstFrame, m_index.frameCount() - 1);
+    lastFrame = qBound(firstFrame, lastFrame, m_index.frameCount() - 1);
+    return decodeSpan(firstFrame, lastFrame, nullptr, [this, &callback](int frameIndex, AVFrame *frame)
+                      { return callback(frameIndex, convertFrame(frame)); });
+}
+
+bool VideoDecoder::decodeFrames(const QVector<int> &frames, const FrameCallback &callback)
+{
+    if (!isOpen() || !m_index.isValid())
+        return false;
+
+    int frameCount = m_index.frameCount();
+    int i = 0;
+    while (i < frames.size())
+    {
+        if (frames[i] < 0 || frames[i] >= frameCount)
+        {
+            ++i;
+            continue;
+        }
+
+        // Extend the span while the next frame lies in a GOP we will already have decoded into;
+        // past the next keyframe, seeking is cheaper than decoding through
+        int first = i;
+        int last = i;
+        while (last + 1 < frames.size() && frames[last + 1] < frameCount &&
+               m_index.keyframeAtOrBefore(frames[last + 1]) <= frames[last])
+        {
+            ++last;
+        }
+
+        int next = first;
+        bool stopped = false;
+        auto wanted = [&frames, &next, last](int frameIndex)
+        {
+            while (next <= last && frames[next] < frameIndex)
+                ++next;
+            return next <= last && frames[next] == frameIndex;
+        };
+        auto forward = [this, &callback, &stopped](int frameIndex, AVFrame *frame)
+        {
+            stopped = !callback(frameIndex, convertFrame(frame));
+            return !stopped;
+        };
+        if (!decodeSpan(frames[first], frames[last], wanted, forward))
+            return false;
+        if (stopped)
+            return true;
+
+        i = last + 1;
+    }
+    return true;
+}
+
+bool VideoDecoder::scanLuma(int firstFrame, const LumaCallback &callback)
+{
+    if (!isOpen() || !m_index.isValid())
+        return false;
+
+    firstFrame = qBound(0, firstFrame, m_index.frameCount() - 1);
+    return decodeSpan(firstFrame, m_index.frameCount() - 1, nullptr, [this, &callback](int frameIndex, AVFrame *frame)
+                      {
+        // Planar and semi-planar 8-bit YUV already has the plane we want as plane 0
+        const AVPixFmtDescriptor *descriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+        if (descriptor && !(descriptor->flags & AV_PIX_FMT_FLAG_RGB) && descriptor->nb_components >= 1 &&
+            descriptor->comp[0].plane == 0 && descriptor->comp[0].depth == 8 && descriptor->comp[0].step == 1)
+        {
+            return callback(frameIndex, frame->data[0], frame->linesize[0], frame->width, frame->height);
+        }
+
+        m_lumaSwsContext = sws_getCachedContext(m_lumaSwsContext,
+                                                frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
+                                                frame->width, frame->height, AV_PIX_FMT_GRAY8,
+                                                SWS_POINT, nullptr, nullptr, nullptr);
+        if (!m_lumaSwsContext)
+        {
+            LOG_ERROR("Decoder: no luma conversion from pixel format {}", frame->format);
+            return false;
+        }
+        m_lumaBuffer.resize(frame->width * frame->height);
+        uint8_t *destination[4] = {reinterpret_cast<uint8_t *>(m_lumaBuffer.data()), nullptr, nullptr, nullptr};
+        int destinationStride[4] = {frame->width, 0, 0, 0};
+        sws_scale(m_lumaSwsContext, frame->data, frame->linesize, 0, frame->height, destination, destinationStride);
+        return callback(frameIndex, destination[0], frame->width, frame->width, frame->height); });
+}
+
+bool VideoDecoder::decodeSpan(int firstFrame, int lastFrame, const std::function<bool(int)> &wanted,
+                              const RawFrameCallback &callback)
+{
+    TRACE_SCOPE("decodeSpan", "decode");
+    // Keep decoding forward if the range starts inside the GOP we are already in
+    int keyframe = m_index.keyframeAtOrBefore(firstFrame);
+    bool canContinue = m_lastDecodedFrame >= keyframe && m_lastDecodedFrame < firstFrame && !m_draining;
+    if (!canContinue && !seekToFrame(keyframe))
+        return false;
+
+    while (true)
+    {
+        int result = avcodec_receive_frame(m_codecContext, m_frame);
+        if (result == AVERROR(EAGAIN))
+        {
+            if (!sendNextPacket())
+                return false;
+            continue;
+        }
+        if (result == AVERROR_EOF)
+        {
+            // Decoder fully drained - the next request has to seek again
+            m_lastDecodedFrame = -1;
+            return true;
+        }
+        if (result < 0)
+        {
+            LOG_ERROR("Decoder: failed to decode frame ({})", result);
+            m_lastDecodedFrame = -1;
+            return false;
+        }
+
+        int frameIndex = m_index.frameForPts(m_frame->best_effort_timestamp);
+        if (frameIndex < 0)
+        {
+            av_frame_unref(m_frame);
+            continue;
+        }
+        m_lastDecodedFrame = frameIndex;
+        PerfStats::frameDecoded();
+
+        bool keepGoing = frameIndex < lastFrame;
+        if (frameIndex >= firstFrame && frameIndex <= lastFrame && (!wanted || wanted(frameIndex)))
+        {
+            bool keepCalling = callback(frameIndex, m_frame);
+            av_frame_unref(m_frame);
+            if (!keepCalling)
+                return true;
+        }
+        else
+        {
+            av_frame_unref(m_frame);
+        }
+
+        if (!keepGoing)
+            return true;
+    }
+}
+
+QImage VideoDecoder::decodeFrame(int frameIndex)
+{
+    QImage result;
+    decodeRange(frameIndex, frameIndex, [&result](int, const QImage &image)
+                {
+        result = image;
+        return false; });
+    return result;
+}
+
+bool VideoDecoder::seekToFrame(int frameIndex)
+{
+    TRACE_SCOPE("seekToFrame", "seek");
+    const FrameIndex::Entry &entry = m_index.entry(frameIndex);
+    if (av_seek_frame(m_formatContext, m_streamIndex, entry.pts, AVSEEK_FLAG_BACKWARD) < 0)
+    {
+        LOG_ERROR("Decoder: seek to frame {} (pts {}) failed", frameIndex, entry.pts);
+        return false;
+    }
+    avcodec_flush_buffers(m_codecContext);
+    m_lastDecodedFrame = -1;
+    m_draining = false;
+    return true;
+}
+
+bool VideoDecoder::sendNextPacket()
+{
+    if (m_draining)
+        return false;
+
+    while (true)
+    {
+        int result = av_read_frame(m_formatContext, m_packet);
+        if (result < 0)
+        {
+            // End of file: switch the decoder to draining so buffered frames come out
+            m_draining = true;
+            return avcodec_send_packet(m_codecContext, nullptr) >= 0;
+        }
+
+        if (m_packet->stream_index != m_streamIndex)
+        {
+            av_packet_unref(m_packet);
+            continue;
+        }
+
+        result = avcodec_send_packet(m_codecContext, m_packet);
+        av_packet_unref(m_packet);
+        if (result < 0)
+        {
+            LOG_ERROR("Decoder: failed to send packet ({})", result);
+            return false;
+        }
+        return true;
+    }
+}
+
+QImage VideoDecoder::convertFrame(const AVFrame *frame)
+{
+    TRACE_SCOPE("convertFrame", "convert");
+    // Common decoder outputs go through the SIMD kernels, which also honour the stream's colour matrix
+    ColorConversion::Source source{};
+    bool fastPath = true;
+    switch (frame->format)
+    {
+    case AV_PIX_FMT_NV12:
+        source.layout = ColorConversion::Layout::NV12;
+        break;
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+        source.layout = ColorConversion::Layout::YUV420P;
+        break;
+    case AV_PIX_FMT_P010LE:
+        source.layout = ColorConversion::Layout::P010;
+        break;
+    case AV_PIX_FMT_YUYV422:
+        source.layout = ColorConversion::Layout::YUYV;
+        break;
+    default:
+        fastPath = false;
+        break;
+    }
+
+    if (fastPath)
+    {
+        source.width = frame->width;
+        source.height = frame->height;
+        for (int plane = 0; plane < 3; ++plane)
+        {
+            source.planes[plane] = frame->data[plane];
+            source.strides[plane] = frame->linesize[plane];
+        }
+
+        switch (frame->colorspace)
+        {
+        case AVCOL_SPC_BT470BG:
+        case AVCOL_SPC_SMPTE170M:
+            source.matrix = ColorConversion::Matrix::BT601;
+            break;
+        case AVCOL_SPC_BT709:
+            source.matrix = ColorConversion::Matrix::BT709;
+            break;
+        case AVCOL_SPC_BT2020_NCL:
+        case AVCOL_SPC_BT2020_CL:
+            source.matrix = ColorConversion::Matrix::BT2020;
+            break;
+        default:
+            source.matrix = ColorConversion::defaultMatrix(frame->width, frame->height);
+            break;
+        }
+        bool fullRange = frame->color_range == AVCOL_RANGE_JPEG || frame->format == AV_PIX_FMT_YUVJ420P;
+        source.range = fullRange ? ColorConversion::Range::Full : ColorConversion::Range::Limited;
+
+        QImage image(frame->width, frame->height, QImage::Format_RGB32);
+        if (ColorConversion::convert(source, image.bits(), static_cast<int>(image.bytesPerLine())))
+            return image;
+    }
+
+    m_swsContext = sws_getCachedContext(m_swsContext,
+                                        frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
+                                        frame->width, frame->height, AV_PIX_FMT_RGB32,
+                                        SWS_POINT, nullptr, nullptr, nullptr);
+    if (!m_swsContext)
+    {
+        LOG_ERROR("Decoder: no conversion from pixel format {}", frame->format);
+        return QImage();
+    }
+
+    QImage image(frame->width, frame->height, QImage::Format_RGB32);
+    uint8_t *destination[4] = {image.bits(), nullptr, nullptr, nullptr};
+    int destinationStride[4] = {static_cast<int>(image.bytesPerLine()), 0, 0, 0};
+    sws_scale(m_swsContext, frame->data, frame->linesize, 0, frame->height, destination, destinationStride);
+    return image;
+}
@@ -0,0 +1,124 @@
+#ifndef VIDEODECODER_H
+#define VIDEODECODER_H
+
+#include <QImage>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include "FrameIndex.h"
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVFrame;
+struct AVPacket;
+struct SwsContext;
+
+/**
+ * In-process libav decoder that keeps the demuxer and codec open for the
+ * lifetime of a video and decodes frames by frame index.
+ *
+ * Frame positions come from a FrameIndex, so every decode starts at the
+ * nearest keyframe and runs forward instead of seeking blind. Sequential
+ * requests continue from where the previous one stopped without reseeking.
+ *
+ * Not thread-safe: each instance must only be used from one thread at a time.
+ */
+class VideoDecoder
+{
+public:
+    /**
+     * Called for each decoded frame in a range, in presentation order
+     * @return false to stop decoding early
+     */
+    using FrameCallback = std::function<bool(int frameIndex, const QImage &image)>;
+
+    /**
+     * Called with a decoded frame's 8-bit luma plane; the plane is only valid during the call
+     * @return false to stop decoding early
+     */
+    using LumaCallback = std::function<bool(int frameIndex, const uint8_t *luma, int stride, int width, int height)>;
+
+    VideoDecoder();
+    ~VideoDecoder();
+
+    VideoDecoder(const VideoDecoder &) = delete;
+    VideoDecoder &operator=(const VideoDecoder &) = delete;
+
+    /**
+     * Open a video for decoding
+     * @param videoPath Path to the video file
+     * @param index Frame index previously built for the same file
+     * @return true if the demuxer and decoder were opened
+     */
+    bool open(const QString &videoPath, const FrameIndex &index);
+    void close();
+    bool isOpen() const { return m_codecContext != nullptr; }
+
+    /**
+     * Number of libav decoding threads used by the next open(); 0 (default) means one per core
+     */
+    void setThreadCount(int threadCount) { m_threadCount = threadCount; }
+
+    /**
+     * Trade picture quality for speed on the next open(): skip the in-loop
+     * deblocking filter and let codecs that support it decode at reduced
+     * resolution. Meant for analysis passes, never for exported frames.
+     */
+    void setFastDecode(bool fast) { m_fastDecode = fast; }
+
+    QString videoPath() const { return m_videoPath; }
+    const FrameIndex &frameIndex() const { return m_index; }
+
+    /**
+     * Decode every frame in [firstFrame, lastFrame] in one forward pass
+     * starting at the keyframe at or before firstFrame
+     * @return false if the decoder failed before reaching the range
+     */
+    bool decodeRange(int firstFrame, int lastFrame, const FrameCallback &callback);
+
+    /**
+     * Decode a sorted list of frames in a single forward sweep
+     * Consecutive frames within reach of the same keyframe share one pass;
+     * frames in between are decoded but not converted.
+     * @param frames Frame indices in ascending order, without duplicates
+     * @return false if the decoder failed
+     */
+    bool decodeFrames(const QVector<int> &frames, const FrameCallback &callback);
+
+    /**
+     * Decode a single frame
+     * @return The frame as QImage::Format_RGB32, or a null image on failure
+     */
+    QImage decodeFrame(int frameIndex);
+
+    /**
+     * Decode from firstFrame to the end of the video without RGB conversion
+     * @return false if the decoder failed
+     */
+    bool scanLuma(int firstFrame, const LumaCallback &callback);
+
+private:
+    using RawFrameCallback = std::function<bool(int frameIndex, AVFrame *frame)>;
+
+    bool decodeSpan(int firstFrame, int lastFrame, const std::function<bool(int)> &wanted, const RawFrameCallback &callback);
+    bool seekToFrame(int frameIndex);
+    bool sendNextPacket();
+    QImage convertFrame(const AVFrame *frame);
+
+    QString m_videoPath;
+    FrameIndex m_index;
+    AVFormatContext *m_formatContext;
+    AVCodecContext *m_codecContext;
+    SwsContext *m_swsContext;
+    SwsContext *m_lumaSwsContext; // Pixel formats without a plain 8-bit luma plane
+    QByteArray m_lumaBuffer;
+    AVPacket *m_packet;
+    AVFrame *m_frame;
+    int m_streamIndex;
+    int m_threadCount;
+    bool m_fastDecode;
+    int m_lastDecodedFrame; // Index of the last frame out of the decoder, -1 after a seek
+    bool m_draining;
+};
+
+#endif // VIDEODECODER_H
@@ -0,0 +1,142 @@
+#include "WorkStealingPool.h"
+
+namespace
+{
+    // Identifies the pool and worker a thread belongs to, so submit() can push locally
+    thread_local const WorkStealingPool *t_pool = nullptr;
+    thread_local int t_workerIndex = -1;
+}
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : m_queued(0), m_pending(0), m_steals(0), m_stopping(false)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    threadCount = threadCount > 0 ? threadCount : 1;
+
+    for (int i = 0; i < threadCount; ++i)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < threadCount; ++i)
+    {
+        m_threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    waitForIdle();
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_stopping = true;
+    }
+    m_wakeCondition.notify_all();
+    for (std::thread &thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    m_pending.fetch_add(1);
+    if (t_pool == this)
+    {
+        Worker &worker = *m_workers[t_workerIndex];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_injectedMutex);
+        m_injected.push_back(std::move(task));
+    }
+
+    // Publish under the state mutex so a worker about to sleep can't miss the task
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_queued.fetch_add(1);
+    }
+    m_wakeCondition.notify_one();
+}
+
+void WorkStealingPool::waitForIdle()
+{
+    std::unique_lock<std::mutex> lock(m_stateMutex);
+    m_idleCondition.wait(lock, [this]()
+                         { return m_pending.load() == 0; });
+}
+
+bool WorkStealingPool::takeTask(int index, Task &task)
+{
+    // Own deque first, newest task: it is the most likely to be in cache
+    {
+        Worker &worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.tasks.empty())
+        {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            return true;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_injectedMutex);
+        if (!m_injected.empty())
+        {
+            task = std::move(m_injected.front());
+            m_injected.pop_front();
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another worker
+    int count = static_cast<int>(m_workers.size());
+    for (int offset = 1; offset < count; ++offset)
+    {
+        Worker &victim = *m_workers[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            m_steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(int index)
+{
+    t_pool = this;
+    t_workerIndex = index;
+
+    while (true)
+    {
+        Task task;
+        if (takeTask(index, task))
+        {
+            m_queued.fetch_sub(1);
+            task();
+            task = nullptr;
+
+            if (m_pending.fetch_sub(1) == 1)
+            {
+                std::lock_guard<std::mutex> lock(m_stateMutex);
+                m_idleCondition.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_stateMutex);
+        m_wakeCondition.wait(lock, [this]()
+                             { return m_stopping || m_queued.load() > 0; });
+        if (m_stopping && m_queued.load() == 0)
+            return;
+    }
+}
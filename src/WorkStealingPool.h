@@ -0,0 +1,84 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed-size thread pool with per-worker task deques and work stealing.
+ *
+ * Tasks submitted from a worker go to that worker's own deque and are taken
+ * back LIFO, so a decode step's encode tasks run hot in cache on the same
+ * core. Idle workers steal FIFO from the other end of busy workers' deques.
+ * Tasks submitted from outside the pool go to a shared injection queue.
+ */
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param threadCount Number of workers; 0 means one per hardware thread
+     */
+    explicit WorkStealingPool(int threadCount = 0);
+
+    /**
+     * Runs every queued task, then stops the workers
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    /**
+     * Queue a task; safe to call from any thread, including from inside a task
+     */
+    void submit(Task task);
+
+    /**
+     * Block until every submitted task, and every task they submitted, has finished
+     * Must not be called from a worker.
+     */
+    void waitForIdle();
+
+    int threadCount() const { return static_cast<int>(m_threads.size()); }
+
+    /**
+     * Number of tasks taken from another worker's deque since construction
+     */
+    uint64_t stealCount() const { return m_steals.load(std::memory_order_relaxed); }
+
+private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(int index);
+    bool takeTask(int index, Task &task);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_injectedMutex;
+    std::deque<Task> m_injected;
+
+    // Sleeping workers and waitForIdle() block on m_stateMutex
+    std::mutex m_stateMutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_idleCondition;
+    std::atomic<int64_t> m_queued;  // Tasks sitting in a deque or the injection queue
+    std::atomic<int64_t> m_pending; // Tasks submitted and not yet finished
+    std::atomic<uint64_t> m_steals;
+    bool m_stopping;
+};
+
+#endif // WORKSTEALINGPOOL_H
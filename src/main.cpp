@@ -1,13 +1,48 @@
 #include <QApplication>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSettings>
+#include <QThreadPool>
+#include <QTimer>
 #include "MainWindow.h"
+#include "HeadlessExtractor.h"
 #include "Logger.h"
+#include "Tracer.h"
+#include "StallWatchdog.h"
 
 int main(int argc, char *argv[])
 {
+    // Headless extraction for batch servers: no widgets, no display needed
+    if (HeadlessExtractor::isRequested(argc, argv))
+    {
+        QCoreApplication app(argc, argv);
+
+        Logger::initialize();
+
+        app.setApplicationName("Image Annotation Picker");
+        app.setApplicationVersion("1.0.0");
+        app.setOrganizationName("ImageAnnotationPicker");
+
+        int result = 2;
+        {
+            // Destroyed before the logger shuts down, so none of its worker threads can still log
+            HeadlessExtractor extractor;
+            if (extractor.parseArguments(app.arguments()))
+            {
+                QTimer::singleShot(0, &extractor, &HeadlessExtractor::start);
+                result = app.exec();
+            }
+        }
+        QThreadPool::globalInstance()->waitForDone();
+        Logger::shutdown();
+        return result;
+    }
+
     QApplication app(argc, argv);
 
     // Initialize logging
     Logger::initialize();
+    Tracer::setThreadName("GUI");
 
     app.setApplicationName("Image Annotation Picker");
     app.setApplicationVersion("1.0.0");
@@ -15,13 +50,37 @@ int main(int argc, char *argv[])
 
     LOG_INFO("Starting Image Annotation Picker v1.0.0");
 
-    MainWindow window;
-    window.show();
+    QElapsedTimer session;
+    session.start();
+
+    int result = 0;
+    {
+        // The window and its worker threads go before the logger shuts down
+        MainWindow window;
+        window.show();
+
+        LOG_INFO("Main window displayed");
 
-    LOG_INFO("Main window displayed");
+        // Watches the GUI event loop for stalls; the report is rewritten every session
+        QSettings settings;
+        StallWatchdog watchdog(settings.value("watchdog/reportPath", "annotation_picker_stalls.jsonl").toString(),
+                               settings.value("watchdog/stallThresholdMs", 200).toInt());
+        if (settings.value("watchdog/enabled", true).toBool())
+        {
+            watchdog.start();
+        }
 
-    int result = app.exec();
+        result = app.exec();
 
-    LOG_INFO("Application exiting with code: {}", result);
+        watchdog.stop();
+        StallWatchdog::Stats stalls = watchdog.stats();
+        LOG_INFO("Session summary: {:.0f}s, {} GUI stall(s) over {}ms, worst {}ms{}, {}ms stalled in total",
+                 session.elapsed() / 1000.0, stalls.stalls, watchdog.threshold(), stalls.worstMs,
+                 stalls.worstSpan.isEmpty() ? std::string() : " in " + stalls.worstSpan.toStdString(), stalls.totalMs);
+        LOG_INFO("Application exiting with code: {}", result);
+    }
+    // Background scans on the global pool (directory and hash indexes) may outlive the window
+    QThreadPool::globalInstance()->waitForDone();
+    Logger::shutdown();
     return result;
 }